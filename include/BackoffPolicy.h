@@ -0,0 +1,122 @@
+#ifndef BACKOFF_POLICY_H
+#define BACKOFF_POLICY_H
+
+#include <cstdint>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <thread>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#include <immintrin.h>
+#endif
+
+/**
+ * @brief What a CAS loop does after a failed compare-exchange
+ *
+ * - None: retry immediately
+ * - Pause: one CPU pause/yield instruction (stays on core, no syscall)
+ * - ExponentialJitter: random 1..2^retries pause instructions (capped)
+ * - Yield: std::this_thread::yield()
+ * - Sleep: yield + sleep_for(50ns * (retries + 1)) - the original behavior;
+ *   the timer slack alone costs microseconds on Linux
+ */
+enum class BackoffStrategy {
+    None,
+    Pause,
+    ExponentialJitter,
+    Yield,
+    Sleep
+};
+
+/**
+ * @brief Backoff strategy plus retry budget for a CAS loop
+ */
+struct BackoffPolicy {
+    static constexpr uint32_t DEFAULT_MAX_RETRIES = 100;
+    static constexpr uint32_t MAX_SPIN_EXPONENT = 10;  // up to 1024 pauses
+
+    BackoffStrategy strategy = BackoffStrategy::Sleep;
+    uint32_t maxRetries = DEFAULT_MAX_RETRIES;  // CAS attempts before giving up
+
+    /**
+     * @brief Hint to the CPU that we are spinning
+     */
+    static void cpuRelax() {
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+        _mm_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+        __asm__ __volatile__("yield");
+#endif
+    }
+
+    /**
+     * @brief Waits after the given failed attempt (0-based)
+     */
+    void backoff(uint32_t retries) const {
+        switch (strategy) {
+            case BackoffStrategy::None:
+                break;
+            case BackoffStrategy::Pause:
+                cpuRelax();
+                break;
+            case BackoffStrategy::ExponentialJitter: {
+                uint32_t exponent = retries < MAX_SPIN_EXPONENT ? retries : MAX_SPIN_EXPONENT;
+                uint32_t spins = (nextRandom() & ((1u << exponent) - 1)) + 1;
+                for (uint32_t i = 0; i < spins; ++i) {
+                    cpuRelax();
+                }
+                break;
+            }
+            case BackoffStrategy::Yield:
+                std::this_thread::yield();
+                break;
+            case BackoffStrategy::Sleep:
+                std::this_thread::yield();
+                std::this_thread::sleep_for(
+                    std::chrono::nanoseconds(50 * (retries + 1))
+                );
+                break;
+        }
+    }
+
+private:
+    // Per-thread xorshift, only used for jitter
+    static uint32_t nextRandom() {
+        thread_local uint32_t state =
+            static_cast<uint32_t>(std::hash<std::thread::id>{}(std::this_thread::get_id())) | 1u;
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return state;
+    }
+};
+
+/**
+ * @brief Retry / give-up counters for tuning a deployment
+ *
+ * Only touched on the slow path (after a failed CAS), never on an
+ * uncontended booking. Counts are also added to `parent`, if set
+ * (e.g. per-show counters rolling up into the service's).
+ */
+struct ContentionStats {
+    std::atomic<uint64_t> retries{0};   // failed CAS attempts that were retried
+    std::atomic<uint64_t> giveUps{0};   // bookings abandoned after maxRetries
+    ContentionStats* parent = nullptr;  // not owned
+
+    void recordRetry() {
+        retries.fetch_add(1, std::memory_order_relaxed);
+        if (parent) {
+            parent->recordRetry();
+        }
+    }
+
+    void recordGiveUp() {
+        giveUps.fetch_add(1, std::memory_order_relaxed);
+        if (parent) {
+            parent->recordGiveUp();
+        }
+    }
+};
+
+#endif // BACKOFF_POLICY_H
@@ -0,0 +1,273 @@
+#ifndef BOOKING_LOG_H
+#define BOOKING_LOG_H
+
+#include "IoUring.h"
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+/**
+ * @brief How much a booking waits for its log record
+ *
+ * - None: no log, bookings live in memory only
+ * - Async: records are written and synced by the flusher once per group
+ *   commit window; calls return without waiting (a crash loses at most
+ *   the last window)
+ * - GroupSync: like Async, but every call that changes bookings returns
+ *   only once its record is on disk
+ */
+enum class Durability : uint8_t {
+    None,
+    Async,
+    GroupSync
+};
+
+/**
+ * @brief How the flusher writes and syncs groups
+ *
+ * - Sync: pwrite + fdatasync on the flusher thread, one group at a time
+ * - IoUring: a linked write + fdatasync per group, submitted through
+ *   io_uring from registered buffers; up to Options::groupsInFlight
+ *   groups are on their way to disk while the next one is formed.
+ *   Falls back to Sync where io_uring is unavailable.
+ */
+enum class LogBackend : uint8_t {
+    Sync,
+    IoUring
+};
+
+/**
+ * @brief One fixed-size log record (96 bytes, no padding)
+ *
+ * Book: a booking was published, with all its seats.
+ * Cancel: a booking ended; seats lists the seats it gave back (all of
+ * them, or only the ones an exchange did not keep).
+ * Exchange: a Book that replaces another booking; the Cancel of that
+ * booking is the next record (lsn + 1). The two are appended together
+ * and written in one group, and a log that ends between them loses
+ * the Exchange as well (BookingLog::open), so replay sees both or neither.
+ * Records of one show are in causal order: seats are released only after
+ * the record that frees them was appended.
+ * checksum is set by the flusher when the record is written.
+ */
+struct LogRecord {
+    static constexpr uint32_t MAX_SEATS = 32;
+
+    enum class Type : uint8_t {
+        Book = 1,
+        Cancel = 2,
+        Exchange = 3
+    };
+
+    uint64_t lsn = 0;  // Log sequence number, dense from 1
+    uint64_t bookingId = 0;
+    uint32_t movieId = 0;
+    uint32_t theaterId = 0;
+    uint16_t seatCount = 0;
+    Type type = Type::Book;
+    uint8_t reserved = 0;
+    uint32_t checksum = 0;  // CRC-32C of the record with this field 0
+    uint16_t seats[MAX_SEATS] = {};  // Ascending 0-based seat indexes
+
+    uint32_t computeChecksum() const;
+    bool isIntact() const { return checksum == computeChecksum(); }
+};
+
+static_assert(std::is_trivially_copyable_v<LogRecord>, "LogRecord is written to disk as is");
+static_assert(sizeof(LogRecord) == 96 && std::has_unique_object_representations_v<LogRecord>,
+              "LogRecord must not contain padding bytes");
+
+/**
+ * @brief Write-ahead log of booking records with group commit
+ *
+ * Booking threads append to a lock-free staging ring (one fetch_add to
+ * claim a slot, one release store to publish it); they never touch the
+ * file. A dedicated flusher thread drains the ring once per group commit
+ * window and writes everything it found with one write and one
+ * fdatasync, however many threads appended meanwhile (see LogBackend).
+ *
+ * The file is a plain array of LogRecord: record N (0-based) has lsn N+1,
+ * or first + N once advanceTo() moved the log on to lsn `first`.
+ * With Options::segmentBytes the log is a series of such files instead,
+ * "<path>.<first lsn>" (20 digits): the flusher starts a new segment once
+ * the current one has grown past segmentBytes, and closed segments a
+ * snapshot covers can be deleted (removeSegmentsBefore).
+ * Opening an existing log keeps its records up to the first torn one (a
+ * partial record, a bad checksum or a broken lsn sequence, as a crash
+ * mid-write leaves at the end, or an Exchange without its Cancel),
+ * drops the rest and appends after them.
+ *
+ * If the ring is full, append() waits for the flusher. If a write fails
+ * the log stops being durable: records are still drained (appends never
+ * block for good) but waitDurable() returns false.
+ */
+class BookingLog {
+public:
+    struct Options {
+        Durability durability = Durability::Async;
+        std::chrono::microseconds groupCommitWindow{500};
+        uint32_t ringCapacity = 16384;  // Records staged at most (rounded up to a power of two)
+        LogBackend backend = LogBackend::IoUring;
+        uint32_t groupsInFlight = 4;    // IoUring: groups written/synced at once
+        uint64_t segmentBytes = 0;      // Rotate past this size (0: one file, never rotated)
+    };
+
+    /**
+     * @brief One log file: records [firstLsn, firstLsn + records)
+     */
+    struct Segment {
+        std::string path;
+        uint64_t firstLsn = 1;
+        uint64_t records = 0;
+    };
+
+    /**
+     * @brief Opens (or creates) the log file and starts the flusher
+     * @return nullptr if the file cannot be opened
+     */
+    static std::unique_ptr<BookingLog> open(const std::string& path, const Options& options);
+
+    /**
+     * @brief Writes and syncs every appended record, then stops the flusher
+     *
+     * No append() may still be running.
+     */
+    ~BookingLog();
+
+    BookingLog(const BookingLog&) = delete;
+    BookingLog& operator=(const BookingLog&) = delete;
+
+    /**
+     * @brief Stages a record (lock-free unless the ring is full)
+     * @return The record's lsn (record.lsn is ignored)
+     */
+    uint64_t append(const LogRecord& record);
+
+    /**
+     * @brief Stages records at consecutive lsns (at most the ring's capacity)
+     * @return The last record's lsn
+     */
+    uint64_t append(std::span<const LogRecord> records);
+
+    /**
+     * @brief Blocks until the record with `lsn` and all before it are on disk
+     * @return false if the log failed before getting there
+     */
+    bool waitDurable(uint64_t lsn) const;
+
+    /**
+     * @brief Highest lsn known to be on disk (0 if none)
+     */
+    uint64_t getDurableLsn() const { return durableLsn_.load(std::memory_order_acquire); }
+
+    /**
+     * @brief Lsn the next append() will get: every lower one is taken
+     */
+    uint64_t getNextLsn() const { return firstLsn_ + tail_.load(std::memory_order_acquire); }
+
+    /**
+     * @brief Write + fdatasync rounds so far (one per non-empty group)
+     */
+    uint64_t getFlushCount() const { return flushCount_.load(std::memory_order_relaxed); }
+
+    bool hasFailed() const { return failed_.load(std::memory_order_acquire); }
+
+    Durability getDurability() const { return options_.durability; }
+
+    /**
+     * @brief The backend in use (Sync if IoUring was asked for but unavailable)
+     */
+    LogBackend getBackend() const { return uring_ ? LogBackend::IoUring : LogBackend::Sync; }
+
+    /**
+     * @brief Bytes dropped from the end of the file by open() (torn tail)
+     */
+    uint64_t getTornBytes() const { return tornBytes_; }
+
+    /**
+     * @brief The log's files in lsn order, the one appended to last
+     *
+     * The last segment's records include those appended but not yet written.
+     */
+    std::vector<Segment> getSegments() const;
+
+    /**
+     * @brief Deletes closed segments whose records all have lsn < `lsn`
+     *
+     * For compaction: once a snapshot with walLsn = lsn is on disk, those
+     * records are never replayed again. The active segment is kept.
+     * @return Segments deleted
+     */
+    size_t removeSegmentsBefore(uint64_t lsn);
+
+    /**
+     * @brief Makes the next append() get `lsn` if the log ends before it
+     *
+     * For recovery from a snapshot whose walLsn is past the records that
+     * survived a crash: new records must not reuse lsns the snapshot
+     * already covers. Writes every appended record, then starts over in a
+     * fresh (empty) segment named at `lsn` and deletes the older ones;
+     * their records are all below `lsn`. No append() may be running.
+     * @return false if the log failed or the new segment cannot be created
+     */
+    bool advanceTo(uint64_t lsn);
+
+private:
+    struct Slot {
+        std::atomic<uint64_t> sequence;  // == position: free, position + 1: ready
+        LogRecord record;
+    };
+
+    BookingLog(int fd, const std::string& path, std::vector<Segment> segments, uint64_t tornBytes,
+               const Options& options);
+
+    void startFlusher();
+    void stopFlusher();
+    void flushLoop();
+    void flushLoopUring();
+    size_t drain(std::vector<LogRecord>& batch);
+    bool writeBatch(const std::vector<LogRecord>& batch, size_t count);
+    void publish(uint64_t durableLsn, uint64_t groups);
+    bool rotationDue() const;
+    bool rotate();
+
+    const Options options_;
+    const std::string path_;
+    int fd_;  // Active segment; replaced by the flusher on rotation
+    uint64_t firstLsn_;  // lsn of ring position 0 (moved only by advanceTo)
+    const uint64_t tornBytes_;
+
+    const uint64_t mask_;
+    std::unique_ptr<Slot[]> ring_;
+    alignas(64) std::atomic<uint64_t> tail_{0};  // Next position to claim (producers)
+
+    // Flusher only: one batch per group in flight, written at writeOffset_
+    alignas(64) uint64_t head_ = 0;  // Next position to drain
+    std::vector<std::vector<LogRecord>> batches_;
+    uint64_t writeOffset_;
+    std::unique_ptr<IoUring> uring_;  // IoUring backend only
+    bool fixedBuffers_ = false;       // batches_ registered with uring_
+
+    // Active segment last; its record count is only set once it is closed
+    mutable std::mutex segmentsMutex_;
+    std::vector<Segment> segments_;
+
+    // Published by the flusher; waiters sleep on rounds_
+    std::atomic<uint64_t> durableLsn_{0};
+    std::atomic<uint64_t> rounds_{0};
+    std::atomic<uint64_t> flushCount_{0};
+    std::atomic<bool> failed_{false};
+
+    std::atomic<bool> stopping_{false};
+    std::thread flusher_;  // Last: starts once everything above is set up
+};
+
+#endif // BOOKING_LOG_H
@@ -2,12 +2,27 @@
 #define LOCK_FREE_BOOKING_SERVICE_H
 
 #include "SeatBitmask.h"
+#include "SeatMap.h"
+#include "SeatArena.h"
+#include "EpochReclaimer.h"
+#include "ConcurrentHashIndex.h"
+#include "SegmentedSlab.h"
+#include "SeatLayout.h"
+#include "TimerWheel.h"
+#include "BookingLog.h"
 #include <string>
 #include <vector>
-#include <map>
+#include <deque>
 #include <memory>
 #include <atomic>
-#include <shared_mutex>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <span>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <utility>
 
 /**
  * @brief Movie entity - simple, without thread-safety 
@@ -22,26 +37,214 @@ struct Movie {
 
 /**
  * @brief Theater entity - simple, without thread-safety 
+ *
+ * capacity is the number of seats (a1..aN); it sizes the seat map of
+ * every show in this theater. Defaults to the classic 20-seat layout.
+ * layout (optional) gives rows and seat scores for bookBestAvailable;
+ * without one, or if it does not match capacity, the theater is treated
+ * as a single row.
  */
 struct Theater {
+    static constexpr uint32_t DEFAULT_CAPACITY = SeatBitmask::MAX_SEATS;
+
     uint32_t id;
     std::string name;
+    uint32_t capacity;
+    std::shared_ptr<const SeatLayout> layout;
     
-    Theater(uint32_t id_, const std::string& name_)
-        : id(id_), name(name_) {}
+    Theater(uint32_t id_, const std::string& name_, uint32_t capacity_ = DEFAULT_CAPACITY,
+            std::shared_ptr<const SeatLayout> layout_ = nullptr)
+        : id(id_), name(name_), capacity(capacity_), layout(std::move(layout_)) {}
 };
 
 /**
  * @brief Booking record - result of a booking
+ *
+ * Fixed-size and trivially copyable: the booked seats are kept inline as
+ * ascending 0-based seat indexes (seat aN = index N-1), not as strings.
+ * seatIds() renders the "aN" strings on demand, for display only.
  */
 struct Booking {
-    uint64_t bookingId;
-    uint32_t movieId;
-    uint32_t theaterId;
-    std::vector<std::string> seats;
+    static constexpr uint32_t MAX_SEATS = 32;  // Seats per booking
+    
+    uint64_t bookingId = 0;
+    uint32_t movieId = 0;
+    uint32_t theaterId = 0;
+    uint16_t seatCount = 0;
+    uint16_t seats[MAX_SEATS] = {};
+    
+    /**
+     * @brief Booked seat indexes, ascending
+     */
+    std::span<const uint16_t> seatIndexes() const { return {seats, seatCount}; }
+    
+    /**
+     * @brief Booked seat IDs (e.g., ["a1", "a5"]) - allocates, display only
+     */
+    std::vector<std::string> seatIds() const;
+};
+
+static_assert(std::is_trivially_copyable_v<Booking>, "Booking must stay trivially copyable");
+static_assert(Booking::MAX_SEATS == LogRecord::MAX_SEATS, "A log record carries a whole booking");
+
+/**
+ * @brief Lifecycle of a booking id
+ *
+ * Unknown until the record is published; Active -> Cancelled at most once.
+ * Exchanging is transient: an exchange() is moving the booking, which
+ * stays valid until the exchange either commits (Cancelled, replaced by
+ * a new booking) or fails (back to Active).
+ * With GroupSync, a cancel or exchange whose record never reaches disk
+ * is undone: the booking goes from Cancelled back to Active.
+ */
+enum class BookingStatus : uint8_t {
+    Unknown,
+    Active,
+    Exchanging,
+    Cancelled
+};
+
+/**
+ * @brief Compact handle to a resolved (movie, theater) show
+ *
+ * Index into the service's dense show slab. Obtained once from
+ * BookingService::resolveShow and valid for the lifetime of the service.
+ */
+struct ShowHandle {
+    static constexpr uint32_t INVALID = UINT32_MAX;
+    
+    uint32_t index = INVALID;
+    
+    bool isValid() const { return index != INVALID; }
+};
+
+/**
+ * @brief Token for seats held by BookingService::holdSeats
+ *
+ * Dense id, never reused. Redeemed once by confirmHold or releaseHold,
+ * or expired by expireHolds after its TTL.
+ */
+struct HoldId {
+    static constexpr uint64_t INVALID = 0;
+    
+    uint64_t value = INVALID;
+    
+    bool isValid() const { return value != INVALID; }
+};
+
+/**
+ * @brief One item of a bookBatch call
+ */
+struct BookingRequest {
+    uint32_t movieId = 0;
+    uint32_t theaterId = 0;
+    std::vector<std::string> seatIds;
+};
+
+/**
+ * @brief Per-item outcome of bookBatch
+ */
+struct BookingResult {
+    enum class Status : uint8_t {
+        Booked,
+        InvalidRequest,  // Unknown/unlinked show, bad seat ID, too many seats
+        SeatsTaken,      // At least one seat already booked (or taken earlier in the batch)
+        StoreFull,       // Booking store out of ids
+        NotDurable       // GroupSync: the log failed, the booking was taken back
+    };
+    
+    Status status = Status::InvalidRequest;
+    const Booking* booking = nullptr;  // Set iff Booked
+    
+    bool ok() const { return status == Status::Booked; }
+};
+
+/**
+ * @brief Outcome of BookingService::saveSnapshot and loadSnapshot
+ */
+struct SnapshotInfo {
+    enum class Status : uint8_t {
+        Ok,
+        IoError,          // File could not be written, opened or mapped
+        Corrupt,          // Bad magic, bounds, checksum or references
+        VersionMismatch,  // Written by another snapshot format version
+        NotEmpty          // loadSnapshot: the service already has data
+    };
+
+    Status status = Status::IoError;
+    uint64_t walLsn = 0;        // First log record the snapshot may miss (0: no log)
+    uint64_t showCount = 0;
+    uint64_t bookingCount = 0;  // Active and cancelled
+    uint64_t bytes = 0;         // File size
+
+    bool ok() const { return status == Status::Ok; }
+};
+
+/**
+ * @brief Outcome of BookingService::recover
+ */
+struct RecoveryInfo {
+    enum class Status : uint8_t {
+        Ok,
+        SnapshotFailed,  // A snapshot exists but was not adopted (see snapshot.status)
+        LogUnreadable,   // A log segment could not be mapped, or the log starts after snapshot.walLsn
+        LogFailed        // The log ends before snapshot.walLsn and could not be moved on to it
+    };
+
+    Status status = Status::Ok;
+    bool snapshotLoaded = false;
+    SnapshotInfo snapshot;          // Set if snapshotLoaded or SnapshotFailed
+    uint64_t replayedRecords = 0;   // Log records applied, from snapshot.walLsn on
+    uint64_t skippedRecords = 0;    // Malformed, or for a show not in the catalog
+    uint64_t tornBytes = 0;         // Dropped from the end of the log (BookingLog::getTornBytes)
+    uint32_t workers = 0;           // Replay threads
+    std::chrono::microseconds elapsed{0};
+
+    bool ok() const { return status == Status::Ok; }
+    double recordsPerSecond() const {
+        double seconds = std::chrono::duration<double>(elapsed).count();
+        return seconds > 0 ? static_cast<double>(replayedRecords) / seconds : 0.0;
+    }
+};
+
+/**
+ * @brief Per-instance tuning of BookingService
+ */
+struct BookingServiceConfig {
+    // How bookSeats claims seat bits (CAS loop or wait-free fetch_or)
+    ClaimStrategy claimStrategy = ClaimStrategy::CompareExchange;
+    
+    // What the CAS loop does after a failed attempt, and how many attempts
+    BackoffPolicy backoff{};
+    
+    // Resolution of hold expiry (one timer-wheel tick)
+    std::chrono::milliseconds holdTick{10};
+    
+    // Seat map tiers (rebalanceSeats): CAS retries per call that make a
+    // show hot, quiet calls before a hot show is packed again, and how
+    // long a move waits for in-flight operations before it is skipped
+    uint64_t promoteRetries = 64;
+    uint32_t demoteRounds = 8;
+    std::chrono::microseconds moveTimeout{10000};
     
-    Booking(uint32_t bid, uint32_t mid, uint32_t tid, const std::vector<std::string>& s)
-        : bookingId(bid), movieId(mid), theaterId(tid), seats(s) {}
+    // Write-ahead log of bookings and cancellations (BookingLog): off by
+    // default. With GroupSync, calls that change bookings return once
+    // their record is on disk, and fail once the log has failed (see
+    // hasLogFailed); records are synced once per window, by io_uring
+    // where available (logBackend).
+    Durability durability = Durability::None;
+    std::string logPath;
+    std::chrono::microseconds groupCommitWindow{500};
+    uint32_t logRingCapacity = 16384;
+    LogBackend logBackend = LogBackend::IoUring;
+    
+    // Log segments and compaction (compactLog): past logSegmentBytes the
+    // log continues in a new file; closed segments are folded into a
+    // snapshot at snapshotPath and deleted, every compactionInterval in
+    // the background once recover() has returned (0: only when called)
+    uint64_t logSegmentBytes = 0;
+    std::string snapshotPath;
+    std::chrono::milliseconds compactionInterval{0};
 };
 
 /**
@@ -49,50 +252,86 @@ struct Booking {
  * 
  * Features:
  * - Seat booking is LOCK-FREE (uses atomic CAS)
- * - Metadata (movies, theaters) uses shared_mutex for read-heavy workloads
- * - Each (movie, theater) combination has its own atomic SeatBitmask
+ * - Metadata (movies, theaters) is read-copy-update: readers do one
+ *   acquire load per entry, writers publish copies (EpochReclaimer)
+ * - Each (movie, theater) combination has its own atomic seat map,
+ *   sized by the theater's capacity (SeatMap::create picks the
+ *   FixedSeatBitmask<N> specialization or WideSeatBitmask), allocated
+ *   in a SeatArena: packed by default, padded to its own cache line
+ *   while contended (rebalanceSeats)
+ * - Optional write-ahead log (BookingLog) with group commit: booking
+ *   threads stage records lock-free, one flusher syncs them per window
  * - Superior performance for concurrent operations
  */
 class BookingService {
 public:
     BookingService();
+    explicit BookingService(const BookingServiceConfig& config);
+    ~BookingService();
+    
+    BookingService(const BookingService&) = delete;
+    BookingService& operator=(const BookingService&) = delete;
     
     // ===== Movie Operations =====
     
     /**
      * @brief Adds a movie (thread-safe)
+     * 
+     * The service keeps its own copy in a pool; adding an existing id
+     * replaces the movie (views of the old one stay valid).
      */
-    void addMovie(std::shared_ptr<Movie> movie);
+    void addMovie(const Movie& movie);
+    void addMovie(std::shared_ptr<Movie> movie) { addMovie(*movie); }
     
     /**
-     * @brief Gets all movies (thread-safe)
+     * @brief Gets all movies, sorted by id (thread-safe)
      */
-    std::vector<std::shared_ptr<Movie>> getAllMovies() const;
+    std::vector<const Movie*> getAllMovies() const;
     
     /**
-     * @brief Gets a movie by ID (thread-safe)
+     * @brief Gets a movie by ID (thread-safe, no allocation)
+     * @return View valid for the lifetime of the service, or nullptr
      */
-    std::shared_ptr<Movie> getMovie(uint32_t movieId) const;
+    const Movie* getMovie(uint32_t movieId) const;
     
     // ===== Theater Operations =====
     
     /**
      * @brief Adds a theater (thread-safe)
+     * 
+     * Copied into the service's pool, like addMovie.
      */
-    void addTheater(std::shared_ptr<Theater> theater);
+    void addTheater(const Theater& theater);
+    void addTheater(std::shared_ptr<Theater> theater) { addTheater(*theater); }
     
     /**
      * @brief Links a movie to a theater (thread-safe)
      */
     bool linkMovieToTheater(uint32_t movieId, uint32_t theaterId);
     
+    /**
+     * @brief Gets a theater by ID (thread-safe, no allocation)
+     * @return View valid for the lifetime of the service, or nullptr
+     */
+    const Theater* getTheater(uint32_t theaterId) const;
+    
     /**
      * @brief Gets theaters for a movie (thread-safe)
      */
-    std::vector<std::shared_ptr<Theater>> getTheatersForMovie(uint32_t movieId) const;
+    std::vector<const Theater*> getTheatersForMovie(uint32_t movieId) const;
     
     // ===== Seat Operations (LOCK-FREE!) =====
     
+    /**
+     * @brief Resolves a show once for repeated handle-based calls (thread-safe)
+     * 
+     * Validates that the movie and theater exist and are linked, and
+     * creates the show's seat map if needed.
+     * 
+     * @return Valid handle, or an invalid one if the show does not exist
+     */
+    ShowHandle resolveShow(uint32_t movieId, uint32_t theaterId);
+    
     /**
      * @brief Gets available seats (lock-free read)
      * 
@@ -105,53 +344,578 @@ public:
      */
     uint32_t getAvailableCount(uint32_t movieId, uint32_t theaterId) const;
     
+    /**
+     * @brief Calls visit(seatIndex) for each free seat of a show (lock-free, no allocation)
+     * 
+     * Seat index N-1 is seat aN. A visitor returning bool stops the walk
+     * by returning false. Does nothing if the handle is invalid.
+     */
+    template <typename Visitor>
+    void forEachAvailableSeat(ShowHandle show, Visitor&& visit) const {
+        if (const Show* resolved = findShow(show)) {
+            SeatLease(*resolved)->forEachAvailable(std::forward<Visitor>(visit));
+        }
+    }
+    
+    /**
+     * @brief Writes a show's free seat IDs ("a1,a4,...") into a caller buffer
+     * 
+     * No heap allocation: meant for high-frequency seat-map polling.
+     * 
+     * @return Number of chars written; only whole seat IDs, stops when full
+     */
+    size_t formatAvailableSeats(ShowHandle show, std::span<char> buffer) const;
+    size_t formatAvailableSeats(uint32_t movieId, uint32_t theaterId, std::span<char> buffer) const;
+    
+    /**
+     * @brief Gets available seats of a resolved show (lock-free, no lookups)
+     * @return Empty if the handle is invalid
+     */
+    std::vector<std::string> getAvailableSeats(ShowHandle show) const;
+    
+    /**
+     * @brief Gets number of available seats of a resolved show (lock-free, no lookups)
+     * @return 0 if the handle is invalid
+     */
+    uint32_t getAvailableCount(ShowHandle show) const;
+    
     /**
      * @brief Books seats - LOCK-FREE OPERATION!
      * 
-     * Uses Compare-And-Swap (CAS) for atomic booking.
+     * Uses Compare-And-Swap (CAS) for atomic booking, or wait-free
+     * fetch_or when configured with ClaimStrategy::FetchOr.
      * Multiple threads can book simultaneously without blocking.
      * 
      * @param movieId Movie ID
      * @param theaterId Theater ID
-     * @param seatIds Vector of seat IDs (e.g., ["a1", "a5"])
-     * @return Booking if successful, nullptr if failed
+     * @param seatIds Vector of seat IDs (e.g., ["a1", "a5"]), a1..a<capacity>,
+     *                at most Booking::MAX_SEATS distinct seats
+     * @return Booking (owned by the service) if successful, nullptr if failed
      */
-    std::shared_ptr<Booking> bookSeats(uint32_t movieId, uint32_t theaterId,
-                                       const std::vector<std::string>& seatIds);
+    const Booking* bookSeats(uint32_t movieId, uint32_t theaterId,
+                             const std::vector<std::string>& seatIds);
     
     /**
-     * @brief Gets a booking by ID (thread-safe)
+     * @brief Books seats of a resolved show - LOCK-FREE hot path
+     * 
+     * Skips the metadata validation and the show lookup: the handle
+     * indexes the seat map directly.
+     * 
+     * @return Booking if successful, nullptr if failed or handle invalid
+     */
+    const Booking* bookSeats(ShowHandle show, const std::vector<std::string>& seatIds);
+    
+    /**
+     * @brief Books seats given as string views - no allocation on the way
+     * 
+     * Seat IDs are parsed, validated and turned into the mask in a
+     * single loop over a stack buffer.
+     */
+    const Booking* bookSeats(uint32_t movieId, uint32_t theaterId,
+                             std::span<const std::string_view> seatIds);
+    const Booking* bookSeats(ShowHandle show, std::span<const std::string_view> seatIds);
+    
+    /**
+     * @brief Books pre-parsed 0-based seat indexes (seat aN = index N-1)
      */
-    std::shared_ptr<Booking> getBooking(uint64_t bookingId) const;
+    const Booking* bookSeats(ShowHandle show, std::span<const uint16_t> seatIndexes);
     
+    /**
+     * @brief Books many requests across shows in one call - LOCK-FREE
+     * 
+     * - Shows are resolved once per distinct (movie, theater), inside one
+     *   epoch guard (one consistent catalog snapshot)
+     * - Items are grouped by show; the non-conflicting items of a group
+     *   are claimed together with one tryBook on their combined mask, and
+     *   only fall back to per-item claims if that attempt fails
+     * - Booking ids for the whole batch come from one fetch_add
+     * 
+     * Each item is all-or-nothing on its own; within a show, earlier
+     * items win seats requested twice in the same batch.
+     * 
+     * @return One result per request, in request order
+     */
+    std::vector<BookingResult> bookBatch(std::span<const BookingRequest> requests);
+    
+    /**
+     * @brief Books `count` adjacent seats wherever they are free - LOCK-FREE
+     * 
+     * Finds the first run of free seats with a bitmap scan and claims it
+     * with the same all-or-nothing tryBook as bookSeats. If another booking
+     * wins part of the run first, the scan resumes from that run's start.
+     * 
+     * @param count 1..Booking::MAX_SEATS
+     * @return Booking if successful, nullptr if no run of that size is free
+     */
+    const Booking* bookAdjacent(uint32_t movieId, uint32_t theaterId, uint32_t count);
+    const Booking* bookAdjacent(ShowHandle show, uint32_t count);
+    
+    /**
+     * @brief Books the best `count` adjacent seats in one row - LOCK-FREE
+     * 
+     * Ranks the free blocks by the theater's SeatLayout (SeatSelector) and
+     * claims the best one with tryBook. If another booking wins part of
+     * it, the next-ranked block is tried; once all ranked blocks are
+     * lost, the map is ranked again.
+     * 
+     * @param count 1..Booking::MAX_SEATS
+     * @return Booking if successful, nullptr if no row has that many free seats together
+     */
+    const Booking* bookBestAvailable(uint32_t movieId, uint32_t theaterId, uint32_t count);
+    const Booking* bookBestAvailable(ShowHandle show, uint32_t count);
+    
+    /**
+     * @brief Gets a booking by ID (lock-free, O(1))
+     * @return Booking owned by the service, or nullptr if unknown or cancelled
+     */
+    const Booking* getBooking(uint64_t bookingId) const;
+    
+    /**
+     * @brief Whether a booking id is unknown, active or cancelled (lock-free)
+     */
+    BookingStatus getBookingStatus(uint64_t bookingId) const;
+    
+    /**
+     * @brief Cancels a booking and frees exactly its seats - LOCK-FREE
+     * 
+     * The record is marked Cancelled with a CAS first, so only one caller
+     * ever releases the seats; then its bits are cleared with fetch_and.
+     * Seats freed this way can be re-booked immediately (with GroupSync,
+     * once the Cancel record is on disk). Pointers to the record stay
+     * valid (the record itself is never modified).
+     * 
+     * @return true if the booking is now cancelled; false if nothing
+     *         changed: the booking is unknown or already cancelled, or,
+     *         with GroupSync, the log has failed (hasLogFailed) - also
+     *         if it fails while this Cancel waits to be synced, in which
+     *         case the booking is active again when the call returns
+     */
+    bool cancelBooking(uint64_t bookingId);
+    
+    /**
+     * @brief Moves a booking to other seats, possibly in another show - LOCK-FREE
+     * 
+     * The old booking is locked against cancel/exchange with one CAS
+     * (Exchanging), the new booking id is taken, the new seats are
+     * claimed, then the old booking is cancelled and the new one
+     * published together (logged as one Exchange + Cancel pair) and
+     * only then the old seats are freed. When the call returns the
+     * customer holds exactly one of the two bookings, in memory and
+     * after a restart; getBooking never shows both live (for an
+     * instant, neither).
+     * 
+     * Seats kept in both sets are never released. Without a log, a move
+     * within one show is a single SeatMap::tryMove (one CAS when the
+     * seats share a word). Otherwise - with a log, or across shows -
+     * both seat sets are taken from the claim until the old seats are
+     * freed: by design, since the old seats may only become free after
+     * the Cancel record that frees them is logged (records of a show
+     * stay in causal order), which no multi-word CAS could ensure.
+     * 
+     * @return The new booking, or nullptr if a new seat is taken, the
+     *         booking is not active, the seats are invalid or, with
+     *         GroupSync, the log has failed or fails before the exchange
+     *         reaches disk (the exchange is then undone). On nullptr the
+     *         old booking is active and unchanged.
+     */
+    const Booking* exchange(uint64_t bookingId, uint32_t newMovieId, uint32_t newTheaterId,
+                            const std::vector<std::string>& newSeatIds);
+    const Booking* exchange(uint64_t bookingId, ShowHandle newShow,
+                            std::span<const uint16_t> newSeatIndexes);
+    
+    // ===== Seat Holds (two-phase booking) =====
+    
+    /**
+     * @brief Holds seats for `ttl` - LOCK-FREE, all-or-nothing like bookSeats
+     * 
+     * Held seats are taken for every other booking or hold and are not
+     * listed by getAvailableSeats. The hold ends with exactly one of
+     * confirmHold, releaseHold or expiry (expireHolds, or a late confirm).
+     * 
+     * @return Hold token, or an invalid HoldId if any seat is taken or invalid
+     */
+    HoldId holdSeats(uint32_t movieId, uint32_t theaterId,
+                     const std::vector<std::string>& seatIds,
+                     std::chrono::milliseconds ttl);
+    HoldId holdSeats(ShowHandle show, const std::vector<std::string>& seatIds,
+                     std::chrono::milliseconds ttl);
+    HoldId holdSeats(ShowHandle show, std::span<const uint16_t> seatIndexes,
+                     std::chrono::milliseconds ttl);
+    
+    /**
+     * @brief Turns a live hold into a booking (seats stay taken)
+     * @return Booking, or nullptr if the hold is unknown, already ended or
+     *         past its TTL, or (GroupSync) the log failed
+     */
+    const Booking* confirmHold(HoldId hold);
+    
+    /**
+     * @brief Gives the held seats back
+     * @return false if the hold is unknown or already ended
+     */
+    bool releaseHold(HoldId hold);
+    
+    /**
+     * @brief Releases every hold whose TTL ended by `now`
+     * 
+     * Driven by a timer wheel: the cost depends on elapsed ticks and
+     * expiring holds, not on the number of shows or live holds. Expired
+     * seats are freed in batches, one releaseHeld per show. Call it
+     * periodically (e.g. every holdTick) from one housekeeping thread;
+     * concurrent calls are serialized.
+     * 
+     * @return Number of holds expired
+     */
+    size_t expireHolds(std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now());
+    
+    /**
+     * @brief Seats currently held (not yet confirmed) in a show
+     */
+    uint32_t getHeldCount(ShowHandle show) const;
+    
+    // ===== Seat Arena Tiers =====
+    
+    /**
+     * @brief Moves seat maps between the packed and padded arena tiers
+     * 
+     * A packed show with at least config.promoteRetries CAS retries since
+     * the last call gets its own cache line; a padded show without
+     * retries for config.demoteRounds calls is packed again. A move waits
+     * for operations in flight on that show (new ones wait for the move)
+     * and is skipped if they do not drain within config.moveTimeout.
+     * Call it periodically from one housekeeping thread, outside any
+     * EpochReclaimer guard; concurrent calls are serialized.
+     * 
+     * @return Number of shows moved
+     */
+    size_t rebalanceSeats();
+    
+    /**
+     * @brief Whether a show's seat map currently has a cache line to itself
+     */
+    bool isSeatMapPadded(ShowHandle show) const;
+    
+    /**
+     * @brief Memory reserved for seat maps (arena chunks)
+     */
+    size_t getSeatArenaBytes() const;
+    
+    // ===== Durability =====
+    
+    /**
+     * @brief The write-ahead log, or nullptr if durability is None or the
+     *        log file could not be opened
+     */
+    const BookingLog* getLog() const { return log_.get(); }
+    
+    /**
+     * @brief Whether changes have stopped being durable: durability was
+     *        asked for but the log could not be opened, or a write failed
+     * 
+     * With GroupSync, every call that changes bookings then fails
+     * (nullptr, false or BookingResult::Status::NotDurable). A change
+     * whose record does not reach disk is undone before the call
+     * returns: bookings are cancelled again, cancelled or exchanged
+     * bookings are active again.
+     */
+    bool hasLogFailed() const {
+        return config_.durability != Durability::None && (!log_ || log_->hasFailed());
+    }
+
+    // ===== Snapshots and Recovery =====
+
+    /**
+     * @brief Writes the catalog, booked seats and bookings to a snapshot
+     *        file (BookingSnapshot.h) - ONLINE, bookings keep running
+     *
+     * Every change logged before the returned walLsn is in the snapshot,
+     * and possibly some later ones: replaying the log from walLsn on top
+     * of it gives the current state. Seat maps are saved as the seats of
+     * live bookings, so holds are not kept. Waits until the log has every
+     * record below walLsn on disk (IoError if it fails first), then
+     * replaces the file atomically. Call outside any EpochReclaimer guard.
+     */
+    SnapshotInfo saveSnapshot(const std::string& path);
+
+    /**
+     * @brief Adopts a snapshot into an empty service
+     *
+     * Maps the file, checks every section, then copies the fixed-size
+     * entries into place (no per-record parsing). Show handles are the
+     * ones of the saved service. Call before any other use of the service.
+     */
+    SnapshotInfo loadSnapshot(const std::string& path);
+
+    /**
+     * @brief Rebuilds the state after a restart: the snapshot, then the
+     *        log records from its walLsn on
+     *
+     * Without a snapshot file the whole log is replayed on top of the
+     * catalog the caller added. The log (config.logPath) was already cut
+     * at its first torn record when the service opened it. Records are
+     * split by show over `threads` workers (0: one per core): each show's
+     * seats are rebuilt by one worker in plain memory and stored once at
+     * the end. If a crash cut the log before the snapshot's walLsn, the
+     * log moves on to walLsn (BookingLog::advanceTo) so that new records
+     * never get lsns the snapshot already covers. Call before any other
+     * use of the service.
+     */
+    RecoveryInfo recover(const std::string& snapshotPath, uint32_t threads = 0);
+
+    /**
+     * @brief Folds closed log segments into a snapshot, then deletes them
+     *
+     * Needs config.logSegmentBytes and config.snapshotPath. Writes an
+     * online snapshot (saveSnapshot: booking threads are not blocked) and
+     * deletes every closed segment below its walLsn, so restart time and
+     * disk use stay bounded by the live state plus the recent segments.
+     * Does nothing with fewer than two segments. Call after recover(),
+     * outside any EpochReclaimer guard; concurrent calls are serialized.
+     * 
+     * @return Number of segments deleted
+     */
+    size_t compactLog();
+
     // ===== Statistics =====
     
+    /**
+     * @brief Gets total number of seats for a show (theater capacity)
+     */
+    uint32_t getCapacity(uint32_t movieId, uint32_t theaterId) const;
+    
     /**
      * @brief Gets occupancy percentage (lock-free)
      */
     double getOccupancyPercentage(uint32_t movieId, uint32_t theaterId) const;
+    
+    /**
+     * @brief Failed CAS attempts retried by bookSeats (all shows)
+     */
+    uint64_t getRetryCount() const;
+    
+    /**
+     * @brief bookSeats calls that gave up after backoff.maxRetries attempts
+     */
+    uint64_t getGiveUpCount() const;
+    
+    /**
+     * @brief compactLog calls (background ones included) that saved a snapshot
+     */
+    uint64_t getCompactionCount() const;
 
 private:
-    // Metadata (uses shared_mutex for read-heavy access)
-    mutable std::shared_mutex metadataMutex_;
-    std::map<uint32_t, std::shared_ptr<Movie>> movies_;
-    std::map<uint32_t, std::shared_ptr<Theater>> theaters_;
-    std::map<uint32_t, std::vector<uint32_t>> movieToTheaters_;
-    
-    // Seat bitmasks - LOCK-FREE!
-    // Key: pair<movieId, theaterId>
-    // Value: atomic SeatBitmask
-    mutable std::shared_mutex seatsMutex_;  // Only for map access, not for booking!
-    std::map<std::pair<uint32_t, uint32_t>, std::shared_ptr<SeatBitmask>> seatMasks_;
-    
-    // Bookings storage (lock for map access, but booking itself is lock-free)
-    mutable std::shared_mutex bookingsMutex_;
-    std::map<uint32_t, std::shared_ptr<Booking>> bookings_;
-    std::atomic<uint64_t> nextBookingId_;
+    const BookingServiceConfig config_;
+    
+    // Contention counters (slow path only) and the options passed to tryBook
+    ContentionStats contentionStats_;
+    ClaimOptions claimOptions_;
+    
+    // Metadata (read-copy-update)
+    // Every catalog entry points to an immutable record. Readers pin an
+    // epoch and load it; writers (serialized by catalogWriterMutex_)
+    // publish an updated copy and retire the old record.
+    // Movies and theaters themselves live in append-only pools with
+    // stable addresses, so records and read APIs hand out plain pointers
+    // (no reference counting on the read path).
+    struct MovieRecord {
+        const Movie* movie;
+        std::vector<uint32_t> theaterIds;  // Linked theaters
+    };
+    
+    struct TheaterRecord {
+        const Theater* theater;
+    };
+    
+    template <typename Record>
+    struct CatalogEntry {
+        std::atomic<const Record*> current{nullptr};
+    };
+    
+    using MovieList = std::vector<const Movie*>;  // Sorted by id
+    
+    std::mutex catalogWriterMutex_;
+    std::deque<Movie> moviePool_;      // Every movie ever added (writer mutex)
+    std::deque<Theater> theaterPool_;
+    ConcurrentHashIndex<CatalogEntry<MovieRecord>> movies_;
+    ConcurrentHashIndex<CatalogEntry<TheaterRecord>> theaters_;
+    std::deque<CatalogEntry<MovieRecord>> movieEntries_;      // Owned entries
+    std::deque<CatalogEntry<TheaterRecord>> theaterEntries_;
+    std::atomic<const MovieList*> movieList_;                 // For getAllMovies
+    
+    // One (movie, theater) show: its atomic seat map + identity
+    struct Show {
+        std::atomic<SeatMap*> seats{nullptr};      // In seatArena_; read through SeatLease
+        std::atomic<bool> moving{false};           // Set while rebalanceSeats copies seats
+        std::shared_ptr<const SeatLayout> layout;  // Always valid, matches seats
+        uint32_t movieId = 0;
+        uint32_t theaterId = 0;
+        uint32_t handle = ShowHandle::INVALID;
+        mutable ContentionStats contention;        // Rolls up into contentionStats_
+        
+        // Tier bookkeeping, written under rebalanceMutex_ only
+        std::atomic<SeatArena::Tier> tier{SeatArena::Tier::Packed};
+        uint64_t retriesSeen = 0;
+        uint32_t quietRounds = 0;
+    };
+    
+    // A show's seat map, pinned so rebalanceSeats cannot move it meanwhile.
+    // Take one at a time, outside other EpochReclaimer guards: a move
+    // waits for every guard entered before it.
+    class SeatLease {
+    public:
+        explicit SeatLease(const Show& show);
+        
+        SeatMap* operator->() const { return seats_; }
+        SeatMap& operator*() const { return *seats_; }
+        
+    private:
+        static EpochReclaimer::Guard pinSettled(const Show& show);
+        
+        EpochReclaimer::Guard guard_;
+        SeatMap* seats_;
+    };
+    
+    static constexpr uint32_t SHOWS_PER_SEGMENT = 4096;
+    static constexpr uint32_t MAX_SHOW_SEGMENTS = 1024;
+    
+    // Shows - LOCK-FREE lookup and booking!
+    // shows_: dense slab, ShowHandle::index -> Show
+    // showIndex_: showKey(movieId, theaterId) -> Show in shows_
+    // seatArena_: the shows' seat maps, packed or padded per show (declared
+    // first so it outlives the shows)
+    SeatArena seatArena_;
+    std::mutex rebalanceMutex_;
+    SegmentedSlab<Show, SHOWS_PER_SEGMENT, MAX_SHOW_SEGMENTS> shows_;
+    ConcurrentHashIndex<Show> showIndex_;
+    uint32_t showCount_ = 0;  // Only changed under showIndex_ writer lock
+    
+    // Bookings storage - LOCK-FREE append and lookup
+    // Append-only slab indexed directly by the booking id; each record is
+    // written in place once, then published by status = Active.
+    // The id is the slot index, so id / BOOKINGS_PER_SEGMENT is the store
+    // segment (shard) that holds it - no lookup table needed.
+    struct BookingSlot {
+        Booking record;
+        uint64_t lsn = 0;  // Its Book (or Exchange) record in log_ (0: not logged)
+        std::atomic<BookingStatus> status{BookingStatus::Unknown};
+    };
+    
+    static constexpr uint32_t BOOKINGS_PER_SEGMENT = 4096;
+    static constexpr uint32_t MAX_BOOKING_SEGMENTS = 16384;  // 64M bookings
+    
+    SegmentedSlab<BookingSlot, BOOKINGS_PER_SEGMENT, MAX_BOOKING_SEGMENTS> bookings_;
+    
+    // Booking ids - LOCK-FREE, mostly thread-local
+    // Threads take ids from private blocks (see allocateBookingId); the
+    // shared counter is only touched once per block, growing from
+    // MIN_ID_BLOCK to MAX_ID_BLOCK ids. Ids are unique and roughly
+    // monotonic; an idle thread's unused block leaves a gap.
+    static constexpr uint64_t MIN_ID_BLOCK = 1;
+    static constexpr uint64_t MAX_ID_BLOCK = BOOKINGS_PER_SEGMENT;
+    
+    const uint64_t instanceId_;  // Keys the per-thread id blocks
+    std::atomic<uint64_t> nextBookingId_;  // First id of the next block
+    
+    // Holds - LOCK-FREE create/confirm/release; expiry by timer wheel
+    // Each hold is written in place in its slot (like bookings), then
+    // published by state = Active. Exactly one CAS out of Active wins.
+    enum class HoldState : uint8_t {
+        Unpublished,
+        Active,
+        Confirmed,
+        Released,
+        Expired
+    };
+    
+    struct HoldSlot {
+        Booking seats;                                 // Show identity + held seats
+        uint32_t show = ShowHandle::INVALID;
+        std::chrono::steady_clock::time_point expiresAt{};
+        uint64_t nextPending = 0;                      // Intake stack link (hold id)
+        std::atomic<HoldState> state{HoldState::Unpublished};
+    };
+    
+    static constexpr uint32_t HOLDS_PER_SEGMENT = 4096;
+    static constexpr uint32_t MAX_HOLD_SEGMENTS = 16384;
+    
+    SegmentedSlab<HoldSlot, HOLDS_PER_SEGMENT, MAX_HOLD_SEGMENTS> holds_;
+    std::atomic<uint64_t> nextHoldId_;
+    
+    // New holds are pushed here lock-free (Treiber stack of hold ids) and
+    // moved into the wheel by expireHolds, the wheel's only user
+    std::atomic<uint64_t> pendingHolds_{0};
+    std::mutex holdWheelMutex_;
+    TimerWheel holdWheel_;
+    const std::chrono::steady_clock::time_point holdEpoch_;  // Tick 0
+    std::vector<std::pair<uint32_t, const HoldSlot*>> expiredHolds_;  // Reused by expireHolds
+    
+    // Write-ahead log (config_.durability). A record is appended before
+    // the change it describes can be seen: Book before the booking is
+    // published, Cancel before its seats are released. GroupSync callers
+    // wait for their record only after dropping every seat lease.
+    // The append and the status change it describes share one epoch
+    // guard, so saveSnapshot can wait for both (see saveSnapshot).
+    std::unique_ptr<BookingLog> log_;
+    
+    // Compaction: compactLog calls are serialized; the background
+    // compactor (config_.compactionInterval) is started by recover()
+    std::mutex compactionMutex_;
+    std::atomic<uint64_t> compactions_{0};
+    std::mutex compactorMutex_;
+    std::condition_variable compactorWake_;
+    bool stopCompactor_ = false;
+    std::thread compactor_;
     
     // Helper methods
-    std::shared_ptr<SeatBitmask> getSeatMask(uint32_t movieId, uint32_t theaterId) const;
-    std::shared_ptr<SeatBitmask> getOrCreateSeatMask(uint32_t movieId, uint32_t theaterId);
+    static uint64_t showKey(uint32_t movieId, uint32_t theaterId) {
+        return (static_cast<uint64_t>(movieId) << 32) | theaterId;
+    }
+    // Catalog readers: caller holds an EpochReclaimer guard
+    const MovieRecord* findMovie(uint32_t movieId) const;
+    const TheaterRecord* findTheater(uint32_t theaterId) const;
+    
+    const Show* findShow(uint32_t movieId, uint32_t theaterId) const;
+    ClaimOptions claimOptionsFor(const Show& show) const;
+    bool moveSeats(Show& show, SeatArena::Tier tier);
+    
+    // Booking path: build the mask on the stack, claim it, write the record
+    template <typename Seats>
+    const Booking* bookShowSeats(ShowHandle handle, Seats seats);
+    const Booking* commitBooking(const Show& show, SeatMap& seats, std::span<const uint64_t> seatMask);
+    const Booking* recordBooking(const Show& show, std::span<const uint64_t> seatMask);
+    uint64_t allocateBookingId();
+    Booking* writeRecord(uint64_t bookingId, const Show& show, std::span<const uint64_t> seatMask);
+    static void fillRecord(Booking& booking, uint64_t bookingId, const Show& show,
+                           std::span<const uint64_t> seatMask);
+    const Booking* claimAdjacent(const Show& show, uint32_t count);
+    const Booking* claimBestAvailable(const Show& show, uint32_t count);
+    
+    // Durability: log a record, wait for it (GroupSync only; false if it
+    // never reaches disk). The booking variant takes back a booking whose
+    // record did not make it. cancelSlot marks a booking Cancelled and
+    // logs it; its seats stay taken until releaseSeats.
+    uint64_t logRecord(LogRecord::Type type, const Booking& booking, std::span<const uint64_t> seatMask);
+    static LogRecord toLogRecord(LogRecord::Type type, const Booking& booking, std::span<const uint64_t> seatMask);
+    bool refusesChanges() const;
+    bool awaitDurable(uint64_t lsn) const;
+    const Booking* awaitDurable(const Booking* booking);
+    bool cancelSlot(BookingSlot& slot, uint64_t& lsn);
+    void releaseSeats(const Booking& booking);
+    void revokeBooking(BookingSlot& slot);
+    void replayLog(const std::vector<std::span<const LogRecord>>& parts, uint32_t threads, RecoveryInfo& info);
+    void runCompactor();
+    template <typename Seats>
+    const Booking* exchangeShowSeats(uint64_t bookingId, ShowHandle handle, Seats seats);
+    
+    // Hold path: same mask building, claimed with tryHold
+    template <typename Seats>
+    HoldId holdShowSeats(ShowHandle handle, Seats seats, std::chrono::milliseconds ttl);
+    const Show* findHoldShow(const HoldSlot& hold, std::span<uint64_t> seatMask) const;
+    uint64_t toHoldTick(std::chrono::steady_clock::time_point time, bool roundUp) const;
+    Show* getOrCreateShow(uint32_t movieId, uint32_t theaterId, uint32_t capacity,
+                          std::shared_ptr<const SeatLayout> layout);
+    const Show* findShow(ShowHandle show) const;
+    uint32_t getTheaterCapacity(uint32_t theaterId) const;
 };
 
 #endif // LOCK_FREE_BOOKING_SERVICE_H
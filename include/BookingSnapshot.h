@@ -0,0 +1,188 @@
+#ifndef BOOKING_SNAPSHOT_H
+#define BOOKING_SNAPSHOT_H
+
+#include "BookingService.h"
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+/**
+ * @brief Binary snapshot format (see BookingService::saveSnapshot)
+ *
+ * One file: a SnapshotHeader, then sections of fixed-size entries at
+ * 8-byte aligned offsets. Every section has its own CRC-32C, and the
+ * header has one over itself, so a reader can check the whole file and
+ * then use the sections in place (mmap) without parsing records.
+ *
+ * Integers are in host byte order; VERSION changes with any layout change.
+ */
+enum class SnapshotSectionId : uint32_t {
+    Movies,        // SnapshotMovie, sorted by id
+    TheaterLinks,  // uint32_t theater ids, referenced by SnapshotMovie
+    Theaters,      // SnapshotTheater
+    LayoutRows,    // SeatLayout::Row, referenced by SnapshotTheater
+    LayoutScores,  // int32_t seat scores, referenced by SnapshotTheater
+    Strings,       // Titles and names, not terminated
+    Shows,         // SnapshotShow, in ShowHandle order
+    SeatWords,     // uint64_t booked-seat words, referenced by SnapshotShow
+    Bookings,      // SnapshotBooking, ascending ids
+    Count
+};
+
+struct SnapshotSection {
+    uint64_t offset = 0;  // From the start of the file
+    uint64_t count = 0;   // Entries
+    uint64_t bytes = 0;
+    uint32_t checksum = 0;
+    uint32_t reserved = 0;
+};
+
+struct SnapshotHeader {
+    static constexpr char MAGIC[8] = {'B', 'K', 'S', 'N', 'A', 'P', '\r', '\n'};
+    static constexpr uint32_t VERSION = 1;
+    static constexpr size_t SECTION_COUNT = static_cast<size_t>(SnapshotSectionId::Count);
+
+    char magic[8] = {};
+    uint32_t version = 0;
+    uint32_t checksum = 0;       // Of the header, with this field 0
+    uint64_t fileSize = 0;
+    uint64_t walLsn = 0;         // First log record not reflected (0: no log)
+    uint64_t nextBookingId = 0;
+    SnapshotSection sections[SECTION_COUNT] = {};
+};
+
+struct SnapshotMovie {
+    uint32_t id;
+    uint32_t titleLength;
+    uint64_t titleOffset;  // Into Strings
+    uint64_t linkOffset;   // Into TheaterLinks
+    uint32_t linkCount;
+    uint32_t reserved = 0;
+};
+
+struct SnapshotTheater {
+    uint32_t id;
+    uint32_t capacity;
+    uint64_t nameOffset;   // Into Strings
+    uint32_t nameLength;
+    uint32_t layoutRowCount = 0;  // 0: no layout
+    uint64_t layoutRowOffset;     // Into LayoutRows
+    uint64_t layoutScoreOffset;   // Into LayoutScores
+    uint32_t layoutScoreCount = 0;
+    uint32_t reserved = 0;
+};
+
+struct SnapshotShow {
+    uint32_t movieId;
+    uint32_t theaterId;
+    uint32_t capacity;
+    uint32_t wordCount;
+    uint64_t wordOffset;  // Into SeatWords
+};
+
+struct SnapshotBooking {
+    Booking record;
+    uint64_t status;  // BookingStatus: Active or Cancelled
+};
+
+static_assert(std::is_trivially_copyable_v<SnapshotHeader> && sizeof(SnapshotHeader) % 8 == 0);
+static_assert(sizeof(SnapshotMovie) == 32 && sizeof(SnapshotTheater) == 48 && sizeof(SnapshotShow) == 24);
+static_assert(std::is_trivially_copyable_v<SnapshotBooking> && sizeof(SnapshotBooking) % 8 == 0);
+
+/**
+ * @brief Writes a snapshot file section by section
+ *
+ * Writes to `path`.tmp and renames it over `path` in finish(), after an
+ * fsync, so a crash mid-write never replaces a good snapshot with a torn
+ * one. Sections go in any order, each between begin and end.
+ */
+class SnapshotWriter {
+public:
+    explicit SnapshotWriter(const std::string& path);
+    ~SnapshotWriter();
+
+    SnapshotWriter(const SnapshotWriter&) = delete;
+    SnapshotWriter& operator=(const SnapshotWriter&) = delete;
+
+    void beginSection(SnapshotSectionId id);
+    void append(const void* data, size_t bytes);
+    void endSection(uint64_t count);
+
+    template <typename T>
+    void writeSection(SnapshotSectionId id, std::span<const T> entries) {
+        beginSection(id);
+        append(entries.data(), entries.size_bytes());
+        endSection(entries.size());
+    }
+
+    /**
+     * @brief Writes the header, syncs and publishes the file
+     * @return false if any write failed (the old snapshot is kept)
+     */
+    bool finish(uint64_t walLsn, uint64_t nextBookingId);
+
+    uint64_t getBytesWritten() const { return offset_; }
+
+private:
+    static constexpr size_t BUFFER_SIZE = 1 << 20;
+
+    void flush();
+
+    std::string path_;
+    std::string tempPath_;
+    int fd_ = -1;
+    bool failed_ = false;
+    bool finished_ = false;
+    uint64_t offset_ = sizeof(SnapshotHeader);
+    SnapshotHeader header_;
+    SnapshotSection* current_ = nullptr;
+    std::vector<char> buffer_;
+};
+
+/**
+ * @brief Read-only mapping of a snapshot file, checked on open
+ */
+class MappedSnapshot {
+public:
+    enum class Status : uint8_t {
+        Ok,
+        IoError,         // Missing or unreadable
+        Corrupt,         // Bad magic, size, bounds or checksum
+        VersionMismatch
+    };
+
+    explicit MappedSnapshot(const std::string& path);
+    ~MappedSnapshot();
+
+    MappedSnapshot(const MappedSnapshot&) = delete;
+    MappedSnapshot& operator=(const MappedSnapshot&) = delete;
+
+    Status getStatus() const { return status_; }
+    const SnapshotHeader& getHeader() const { return *header_; }
+    size_t getSize() const { return size_; }
+
+    /**
+     * @brief A section's entries, in place (valid while the mapping lives)
+     */
+    template <typename T>
+    std::span<const T> section(SnapshotSectionId id) const {
+        const SnapshotSection& s = header_->sections[static_cast<size_t>(id)];
+        return {reinterpret_cast<const T*>(base_ + s.offset), static_cast<size_t>(s.count)};
+    }
+
+    std::string_view string(uint64_t offset, uint32_t length) const;
+
+private:
+    Status check() const;
+
+    Status status_ = Status::IoError;
+    const char* base_ = nullptr;
+    size_t size_ = 0;
+    const SnapshotHeader* header_ = nullptr;
+};
+
+#endif // BOOKING_SNAPSHOT_H
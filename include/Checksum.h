@@ -0,0 +1,18 @@
+#ifndef CHECKSUM_H
+#define CHECKSUM_H
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief CRC-32C (Castagnoli) of a byte range, for on-disk integrity checks
+ *
+ * Uses the SSE4.2 crc32 instruction when the CPU has it (checked once),
+ * otherwise a slice-by-8 table. Both give the same value, so files stay
+ * portable between machines.
+ *
+ * Chainable: crc32c(b, n, crc32c(a, m)) == crc32c of a then b.
+ */
+uint32_t crc32c(const void* data, size_t size, uint32_t crc = 0);
+
+#endif // CHECKSUM_H
@@ -0,0 +1,176 @@
+#ifndef CONCURRENT_HASH_INDEX_H
+#define CONCURRENT_HASH_INDEX_H
+
+#include <cstdint>
+#include <cstddef>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+/**
+ * @brief Insert-only open-addressing hash index: uint64_t key -> T*
+ *
+ * - find() is lock-free: one acquire load of the table pointer, then
+ *   linear probing over 16-byte slots (4 per cache line)
+ * - insertIfAbsent() serializes writers on a mutex; readers never take it
+ * - Entries are never removed, so a slot once published stays valid
+ *
+ * The table doubles when it is half full. The old table is kept (not
+ * freed) until the index is destroyed: a reader may still be probing it,
+ * and the geometric growth bounds the extra memory to the final size.
+ *
+ * Values are not owned by the index.
+ */
+template <typename T>
+class ConcurrentHashIndex {
+public:
+    explicit ConcurrentHashIndex(size_t initialCapacity = 1024) {
+        size_t capacity = 16;
+        while (capacity < initialCapacity) {
+            capacity <<= 1;
+        }
+        tables_.push_back(std::make_unique<Table>(capacity));
+        table_.store(tables_.back().get(), std::memory_order_release);
+    }
+
+    ConcurrentHashIndex(const ConcurrentHashIndex&) = delete;
+    ConcurrentHashIndex& operator=(const ConcurrentHashIndex&) = delete;
+
+    /**
+     * @brief Looks up a key (LOCK-FREE)
+     * @return Value or nullptr if absent
+     */
+    T* find(uint64_t key) const {
+        const Table* table = table_.load(std::memory_order_acquire);
+        return findIn(*table, key);
+    }
+
+    /**
+     * @brief Returns the value for key, inserting create() if absent
+     *
+     * create() runs under the writer lock and only when the key is
+     * missing, so it is called at most once per key.
+     */
+    template <typename Factory>
+    T* insertIfAbsent(uint64_t key, Factory&& create) {
+        if (T* existing = find(key)) {
+            return existing;
+        }
+
+        std::lock_guard<std::mutex> lock(writerMutex_);
+
+        Table* table = table_.load(std::memory_order_relaxed);
+        if (T* existing = findIn(*table, key)) {
+            return existing;  // Inserted by another writer meanwhile
+        }
+
+        T* value = create();
+        if (value == nullptr) {
+            return nullptr;
+        }
+
+        if ((size_ + 1) * 2 > table->capacity) {
+            table = grow(*table);
+        }
+
+        insertInto(*table, key, value);
+        ++size_;
+        return value;
+    }
+
+    /**
+     * @brief Number of entries (approximate while writers are active)
+     */
+    size_t size() const {
+        std::lock_guard<std::mutex> lock(writerMutex_);
+        return size_;
+    }
+
+    /**
+     * @brief Visits every (key, value) of the current table
+     */
+    template <typename Visitor>
+    void forEach(Visitor&& visit) const {
+        const Table* table = table_.load(std::memory_order_acquire);
+        for (size_t i = 0; i < table->capacity; ++i) {
+            T* value = table->slots[i].value.load(std::memory_order_acquire);
+            if (value != nullptr) {
+                visit(table->slots[i].key.load(std::memory_order_relaxed), value);
+            }
+        }
+    }
+
+private:
+    struct Slot {
+        std::atomic<uint64_t> key{0};
+        std::atomic<T*> value{nullptr};  // nullptr = empty; published last
+    };
+
+    struct Table {
+        size_t capacity;
+        std::unique_ptr<Slot[]> slots;
+
+        explicit Table(size_t capacity_)
+            : capacity(capacity_), slots(std::make_unique<Slot[]>(capacity_)) {}
+    };
+
+    std::atomic<Table*> table_{nullptr};
+
+    // Writer side
+    mutable std::mutex writerMutex_;
+    std::vector<std::unique_ptr<Table>> tables_;  // current + outgrown tables
+    size_t size_ = 0;
+
+    // splitmix64 finalizer: spreads packed (movieId << 32 | theaterId) keys
+    static size_t hash(uint64_t key) {
+        key ^= key >> 30;
+        key *= 0xbf58476d1ce4e5b9ULL;
+        key ^= key >> 27;
+        key *= 0x94d049bb133111ebULL;
+        key ^= key >> 31;
+        return static_cast<size_t>(key);
+    }
+
+    static T* findIn(const Table& table, uint64_t key) {
+        size_t mask = table.capacity - 1;
+        for (size_t i = hash(key) & mask;; i = (i + 1) & mask) {
+            T* value = table.slots[i].value.load(std::memory_order_acquire);
+            if (value == nullptr) {
+                return nullptr;
+            }
+            if (table.slots[i].key.load(std::memory_order_relaxed) == key) {
+                return value;
+            }
+        }
+    }
+
+    static void insertInto(Table& table, uint64_t key, T* value) {
+        size_t mask = table.capacity - 1;
+        for (size_t i = hash(key) & mask;; i = (i + 1) & mask) {
+            if (table.slots[i].value.load(std::memory_order_relaxed) == nullptr) {
+                table.slots[i].key.store(key, std::memory_order_relaxed);
+                table.slots[i].value.store(value, std::memory_order_release);
+                return;
+            }
+        }
+    }
+
+    // Called under writerMutex_
+    Table* grow(const Table& old) {
+        auto bigger = std::make_unique<Table>(old.capacity * 2);
+        for (size_t i = 0; i < old.capacity; ++i) {
+            T* value = old.slots[i].value.load(std::memory_order_relaxed);
+            if (value != nullptr) {
+                insertInto(*bigger, old.slots[i].key.load(std::memory_order_relaxed), value);
+            }
+        }
+
+        Table* published = bigger.get();
+        tables_.push_back(std::move(bigger));
+        table_.store(published, std::memory_order_release);
+        return published;
+    }
+};
+
+#endif // CONCURRENT_HASH_INDEX_H
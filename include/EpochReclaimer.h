@@ -0,0 +1,139 @@
+#ifndef EPOCH_RECLAIMER_H
+#define EPOCH_RECLAIMER_H
+
+#include <cstdint>
+#include <cstddef>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <vector>
+
+/**
+ * @brief Epoch-based reclamation for read-copy-update structures
+ *
+ * Readers wrap every access to an RCU-published pointer in a Guard:
+ * - Entering stores the current global epoch in the thread's slot
+ *   (one store + one fence, no shared cache line written)
+ * - Leaving marks the slot idle
+ *
+ * Writers publish a new version, then retire() the old one. Retiring
+ * advances the global epoch and tags the object with the epoch it was
+ * unlinked in; it is freed once every active reader entered after that
+ * epoch, i.e. once no reader can still hold it.
+ *
+ * Frees happen in batches (RECLAIM_THRESHOLD) on the writer side, so
+ * readers never scan, allocate or free. Guards nest.
+ *
+ * One process-wide instance (global()); each thread lazily claims a
+ * cache-line-sized slot, released when the thread exits.
+ */
+class EpochReclaimer {
+public:
+    static constexpr size_t RECLAIM_THRESHOLD = 64;
+
+    /**
+     * @brief RAII read-side critical section
+     */
+    class Guard {
+    public:
+        Guard(const Guard&) = delete;
+        Guard& operator=(const Guard&) = delete;
+        // Movable within the thread that entered it
+        Guard(Guard&& other) noexcept : owner_(other.owner_) { other.owner_ = nullptr; }
+        ~Guard() {
+            if (owner_) {
+                owner_->exit();
+            }
+        }
+
+    private:
+        friend class EpochReclaimer;
+        explicit Guard(EpochReclaimer& owner) : owner_(&owner) { owner_->enter(); }
+
+        EpochReclaimer* owner_;
+    };
+
+    /**
+     * @brief The process-wide reclaimer
+     */
+    static EpochReclaimer& global();
+
+    EpochReclaimer(const EpochReclaimer&) = delete;
+    EpochReclaimer& operator=(const EpochReclaimer&) = delete;
+
+    /**
+     * @brief Enters a read-side critical section on this thread
+     */
+    Guard pin() { return Guard(*this); }
+
+    /**
+     * @brief Schedules an unlinked object for deletion once no reader can hold it
+     */
+    template <typename T>
+    void retire(const T* object) {
+        retire(const_cast<T*>(object), [](void* p) { delete static_cast<T*>(p); });
+    }
+
+    /**
+     * @brief Schedules an unlinked object for deletion with a custom deleter
+     */
+    void retire(void* object, void (*deleter)(void*));
+
+    /**
+     * @brief Waits until every guard entered before this call has exited
+     *
+     * Blocking grace period for writers that must reuse memory in place
+     * instead of retiring it. Guards held by the calling thread are not
+     * waited for. Gives up after `timeout`, e.g. when a reader is itself
+     * waiting for the caller.
+     *
+     * @return false if some earlier reader was still inside at the timeout
+     */
+    bool synchronize(std::chrono::nanoseconds timeout = std::chrono::nanoseconds::max());
+
+    /**
+     * @brief Frees every retired object no reader can still hold
+     * @return Number of objects freed
+     */
+    size_t reclaim();
+
+    /**
+     * @brief Number of retired objects not freed yet
+     */
+    size_t pendingCount() const;
+
+private:
+    static constexpr uint64_t IDLE = UINT64_MAX;
+
+    struct alignas(64) Slot {
+        std::atomic<uint64_t> epoch{IDLE};  // Epoch seen on entry, IDLE outside guards
+        std::atomic<bool> inUse{false};
+        Slot* next = nullptr;
+    };
+
+    struct Retired {
+        void* object;
+        void (*deleter)(void*);
+        uint64_t epoch;  // Epoch in which it was unlinked
+    };
+
+    struct ThreadState;
+
+    EpochReclaimer() = default;
+    ~EpochReclaimer();
+
+    static ThreadState& threadState();
+
+    void enter();
+    void exit();
+    Slot* acquireSlot();
+    size_t reclaimLocked();
+
+    std::atomic<uint64_t> globalEpoch_{1};
+    std::atomic<Slot*> slots_{nullptr};  // Push-only list of thread slots
+
+    mutable std::mutex retiredMutex_;
+    std::vector<Retired> retired_;
+};
+
+#endif // EPOCH_RECLAIMER_H
@@ -0,0 +1,129 @@
+#ifndef FIXED_SEAT_BITMASK_H
+#define FIXED_SEAT_BITMASK_H
+
+#include "SeatMap.h"
+#include "SeatWordOps.h"
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+/**
+ * @brief Seat map whose capacity is a compile-time constant
+ *
+ * WORD_COUNT, ALL_SEATS_MASK and every loop bound are constexpr, so for
+ * N <= 64 tryBook is one validity check plus a single CAS, and
+ * getAvailableCount is a single popcount. Larger N unroll into a fixed
+ * number of word operations with the same all-or-nothing claim/rollback
+ * as WideSeatBitmask.
+ *
+ * Multi-word maps keep their words on one cache line (up to 512 seats).
+ */
+template <uint32_t N>
+class FixedSeatBitmask final : public SeatMap {
+    static_assert(N >= 1 && N <= SeatMap::MAX_CAPACITY, "unsupported seat capacity");
+
+public:
+    static constexpr uint32_t CAPACITY = N;
+    static constexpr uint32_t WORD_COUNT = (N + seat_ops::BITS_PER_WORD - 1) / seat_ops::BITS_PER_WORD;
+
+    // Per-word mask of all N seats
+    static constexpr std::array<uint64_t, WORD_COUNT> ALL_SEATS_MASK = [] {
+        std::array<uint64_t, WORD_COUNT> mask{};
+        for (uint32_t i = 0; i < WORD_COUNT; ++i) {
+            mask[i] = seat_ops::validBits(N, i);
+        }
+        return mask;
+    }();
+
+    /**
+     * @brief Constructor - all seats available
+     */
+    FixedSeatBitmask() = default;
+
+    uint32_t getCapacity() const override { return CAPACITY; }
+    uint32_t getWordCount() const override { return WORD_COUNT; }
+
+    using SeatMap::tryBook;
+
+    bool tryBook(std::span<const uint64_t> seatMask, const ClaimOptions& options) override {
+        if (!seat_ops::isValidMask(words_, CAPACITY, seatMask)) {
+            return false;
+        }
+        if constexpr (WORD_COUNT == 1) {
+            return options.strategy == ClaimStrategy::FetchOr
+                       ? seat_ops::claimWordFetchOr(words_[0], seatMask[0])
+                       : seat_ops::claimWord(words_[0], seatMask[0], options.backoff, options.stats);
+        } else {
+            return seat_ops::tryBook(words_, seatMask, options);
+        }
+    }
+
+    void release(std::span<const uint64_t> seatMask) override {
+        if (seat_ops::isValidMask(words_, CAPACITY, seatMask)) {
+            seat_ops::clearBits(words_, seatMask);
+        }
+    }
+
+    bool tryMove(std::span<const uint64_t> release, std::span<const uint64_t> claim,
+                 const ClaimOptions& options) override {
+        if (!seat_ops::isValidMask(words_, CAPACITY, release) ||
+            !seat_ops::isValidMask(words_, CAPACITY, claim)) {
+            return false;
+        }
+        return seat_ops::tryMove(words_, release, claim, options);
+    }
+
+    bool tryHold(std::span<const uint64_t> seatMask, const ClaimOptions& options) override {
+        if (!tryBook(seatMask, options)) {
+            return false;
+        }
+        // Only after the claim: marking first could clear a rival's held
+        // bits on failure. Readers may see the seats booked until then
+        seat_ops::setBits(held_, seatMask);
+        return true;
+    }
+
+    void confirmHeld(std::span<const uint64_t> seatMask) override {
+        if (seat_ops::isValidMask(words_, CAPACITY, seatMask)) {
+            seat_ops::clearBits(held_, seatMask);
+        }
+    }
+
+    void releaseHeld(std::span<const uint64_t> seatMask) override {
+        if (seat_ops::isValidMask(words_, CAPACITY, seatMask)) {
+            seat_ops::clearBits(held_, seatMask);
+            seat_ops::clearBits(words_, seatMask);
+        }
+    }
+
+    bool areAvailable(std::span<const uint64_t> seatMask) const override {
+        return seat_ops::areAvailable(words_, seatMask);
+    }
+
+    uint32_t getAvailableCount() const override {
+        return CAPACITY - seat_ops::occupiedCount(words_, CAPACITY);
+    }
+
+    uint64_t getOccupiedWord(uint32_t index) const override {
+        return words_[index].load(std::memory_order_acquire);
+    }
+
+    uint64_t getHeldWord(uint32_t index) const override {
+        return held_[index].load(std::memory_order_acquire);
+    }
+
+    uint32_t getHeldCount() const override {
+        return seat_ops::occupiedCount(held_, CAPACITY);
+    }
+
+private:
+    static constexpr size_t WORDS_ALIGNMENT = WORD_COUNT > 1 ? 64 : alignof(std::atomic<uint64_t>);
+
+    // Atomic words: each bit = one seat (0 = available, 1 = occupied)
+    alignas(WORDS_ALIGNMENT) std::array<std::atomic<uint64_t>, WORD_COUNT> words_{};
+    
+    // Held (not yet confirmed) subset of words_
+    std::array<std::atomic<uint64_t>, WORD_COUNT> held_{};
+};
+
+#endif // FIXED_SEAT_BITMASK_H
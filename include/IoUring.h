@@ -0,0 +1,93 @@
+#ifndef IO_URING_H
+#define IO_URING_H
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <sys/uio.h>
+
+/**
+ * @brief Minimal io_uring submission/completion ring (raw syscalls, no liburing)
+ *
+ * Only what BookingLog needs: writes from registered (fixed) buffers,
+ * fdatasync, links between them, and waiting for completions with a
+ * timeout. Not thread-safe: one thread queues, submits and reaps.
+ */
+class IoUring {
+public:
+    struct Completion {
+        uint64_t userData;
+        int32_t result;  // Bytes written, 0, or -errno
+    };
+
+    /**
+     * @brief Sets up a ring with at least `entries` submission slots
+     * @return nullptr if io_uring is unavailable (old kernel, disabled,
+     *         filtered by seccomp) or lacks timed waits
+     */
+    static std::unique_ptr<IoUring> create(uint32_t entries);
+
+    ~IoUring();
+
+    IoUring(const IoUring&) = delete;
+    IoUring& operator=(const IoUring&) = delete;
+
+    /**
+     * @brief Pins buffers for write(..., bufferIndex) (index = position)
+     * @return false if the kernel refused, e.g. over RLIMIT_MEMLOCK
+     */
+    bool registerBuffers(std::span<const iovec> buffers);
+
+    /**
+     * @brief Queues a write at `offset`; bufferIndex < 0: not a fixed buffer
+     *
+     * link: the next queued operation starts only after this one has
+     * completed successfully (it fails with -ECANCELED otherwise).
+     * @return false if the submission queue is full
+     */
+    bool write(int fd, const void* data, uint32_t size, uint64_t offset, int bufferIndex,
+               uint64_t userData, bool link);
+
+    bool fdatasync(int fd, uint64_t userData);
+
+    /**
+     * @brief Submits everything queued, then waits until `minComplete`
+     *        completions are available or `timeout` passes
+     * @return false on an unexpected error (timeouts and signals are not)
+     */
+    bool submitAndWait(uint32_t minComplete,
+                       std::chrono::nanoseconds timeout = std::chrono::nanoseconds::max());
+
+    bool popCompletion(Completion& completion);
+
+private:
+    IoUring() = default;
+
+    struct io_uring_sqe* nextSqe();
+
+    int fd_ = -1;
+
+    // Mappings shared with the kernel
+    void* sqRing_ = nullptr;
+    size_t sqRingSize_ = 0;
+    void* cqRing_ = nullptr;  // == sqRing_ with a single mapping
+    size_t cqRingSize_ = 0;
+    struct io_uring_sqe* sqes_ = nullptr;
+    size_t sqesSize_ = 0;
+
+    uint32_t* sqHead_ = nullptr;
+    uint32_t* sqTail_ = nullptr;
+    uint32_t* sqArray_ = nullptr;
+    uint32_t sqMask_ = 0;
+    uint32_t sqEntries_ = 0;
+    uint32_t* cqHead_ = nullptr;
+    uint32_t* cqTail_ = nullptr;
+    struct io_uring_cqe* cqes_ = nullptr;
+    uint32_t cqMask_ = 0;
+
+    uint32_t queuedTail_ = 0;  // Our tail: entries queued, not yet submitted past *sqTail_
+    uint32_t toSubmit_ = 0;
+};
+
+#endif // IO_URING_H
@@ -0,0 +1,95 @@
+#ifndef SEAT_ARENA_H
+#define SEAT_ARENA_H
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+/**
+ * @brief Chunked storage for seat maps, in two cache layouts
+ *
+ * Seat maps are small (24 bytes for a 20-seat show), so one heap
+ * allocation each wastes allocator headers and scatters hot words next to
+ * unrelated data. The arena carves them out of CHUNK_SIZE chunks instead:
+ * - Packed: blocks rounded to the object's own alignment and laid out
+ *   back to back - the long tail of quiet shows, several per cache line
+ * - Padded: blocks aligned and rounded to a whole cache line, so a hot
+ *   show's words share their line with nobody (no false sharing)
+ *
+ * Freed blocks go to a free list per block shape and are reused first.
+ * Allocation takes a mutex: it only happens when a show is created or
+ * moved between tiers (BookingService::rebalanceSeats), never on the
+ * booking path. Chunks are released when the arena is destroyed.
+ */
+class SeatArena {
+public:
+    enum class Tier : uint8_t {
+        Packed,
+        Padded
+    };
+
+    static constexpr size_t CACHE_LINE_SIZE = 64;
+    static constexpr size_t CHUNK_SIZE = 64 * 1024;
+
+    SeatArena() = default;
+    ~SeatArena();
+
+    SeatArena(const SeatArena&) = delete;
+    SeatArena& operator=(const SeatArena&) = delete;
+
+    /**
+     * @brief Bytes a block takes in a tier (size rounded up to its alignment)
+     */
+    static constexpr size_t blockSize(size_t size, size_t alignment, Tier tier) {
+        size_t unit = blockAlignment(alignment, tier);
+        return (size + unit - 1) / unit * unit;
+    }
+
+    /**
+     * @brief Alignment of a block in a tier
+     */
+    static constexpr size_t blockAlignment(size_t alignment, Tier tier) {
+        return tier == Tier::Padded && alignment < CACHE_LINE_SIZE ? CACHE_LINE_SIZE : alignment;
+    }
+
+    /**
+     * @brief Uninitialized storage for one object
+     * @return nullptr if the block would not fit in a chunk
+     */
+    void* allocate(size_t size, size_t alignment, Tier tier);
+
+    /**
+     * @brief Returns a block from allocate() with the same size, alignment and tier
+     *
+     * The object must already be destroyed, and no thread may still read it.
+     */
+    void deallocate(void* block, size_t size, size_t alignment, Tier tier);
+
+    /**
+     * @brief Bytes of chunk memory taken from the system
+     */
+    size_t getReservedBytes() const;
+
+    /**
+     * @brief Bytes in blocks currently handed out
+     */
+    size_t getLiveBytes() const;
+
+private:
+    struct FreeList {
+        size_t size;
+        size_t alignment;
+        std::vector<void*> blocks;
+    };
+
+    FreeList& freeListFor(size_t size, size_t alignment);
+
+    mutable std::mutex mutex_;
+    std::vector<std::byte*> chunks_;
+    std::byte* cursor_ = nullptr;  // Next free byte of the newest chunk
+    std::vector<FreeList> freeLists_;  // One per block shape (a handful)
+    size_t liveBytes_ = 0;
+};
+
+#endif // SEAT_ARENA_H
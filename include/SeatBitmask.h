@@ -1,10 +1,14 @@
 #ifndef SEAT_BITMASK_H
 #define SEAT_BITMASK_H
 
+#include "BackoffPolicy.h"
+#include "SeatMap.h"
+#include <bit>
 #include <cstdint>
 #include <atomic>
 #include <vector>
 #include <string>
+#include <string_view>
 
 /**
  * @brief Lock-free seat representation using bitmask
@@ -16,7 +20,8 @@
  * - Bit 19 = seat a20
  * 
  * We use std::atomic<uint32_t> for lock-free operations.
- * Booking is done through Compare-And-Swap (CAS).
+ * Booking is done through Compare-And-Swap (CAS); what happens after a
+ * failed CAS is decided by the BackoffPolicy given at construction.
  */
 class SeatBitmask {
 public:
@@ -24,8 +29,10 @@ public:
     
     /**
      * @brief Constructor - all seats available
+     * @param policy Backoff strategy and retry budget for tryBook
      */
-    SeatBitmask() : occupied_(0) {}
+    explicit SeatBitmask(const BackoffPolicy& policy = BackoffPolicy{})
+        : occupied_(0), policy_(policy) {}
     
     /**
      * @brief Converts seat number (1-20) to bit position (0-19)
@@ -42,10 +49,12 @@ public:
     }
     
     /**
-     * @brief Converts seat ID (e.g., "a5") to bit position
+     * @brief Converts seat ID (e.g., "a5") to bit position (no allocation)
      * @return Bit position (0-19) or -1 if invalid
      */
-    static int seatIdToBit(const std::string& seatId);
+    static constexpr int seatIdToBit(std::string_view seatId) {
+        return SeatMap::seatIdToBit(seatId, MAX_SEATS);
+    }
     
     /**
      * @brief Converts bit position to seat ID (e.g., "a5")
@@ -89,6 +98,17 @@ public:
      */
     std::vector<std::string> getAvailableSeats() const;
     
+    /**
+     * @brief Calls visit(bit) for every free seat, ascending (lock-free, no allocation)
+     */
+    template <typename Visitor>
+    void forEachAvailable(Visitor&& visit) const {
+        uint32_t free = ~occupied_.load(std::memory_order_acquire) & ALL_SEATS_MASK;
+        for (; free != 0; free &= free - 1) {
+            visit(static_cast<uint32_t>(std::countr_zero(free)));
+        }
+    }
+    
     /**
      * @brief Gets number of available seats
      */
@@ -97,12 +117,36 @@ public:
     /**
      * @brief Validates that seat ID is valid (a1-a20)
      */
-    static bool isValidSeatId(const std::string& seatId);
+    static constexpr bool isValidSeatId(std::string_view seatId) {
+        return seatIdToBit(seatId) >= 0;
+    }
+    
+    /**
+     * @brief Backoff policy used by tryBook
+     */
+    const BackoffPolicy& getBackoffPolicy() const { return policy_; }
+    
+    /**
+     * @brief Number of failed CAS attempts that were retried
+     */
+    uint64_t getRetryCount() const {
+        return stats_.retries.load(std::memory_order_relaxed);
+    }
+    
+    /**
+     * @brief Number of tryBook calls that gave up after maxRetries
+     */
+    uint64_t getGiveUpCount() const {
+        return stats_.giveUps.load(std::memory_order_relaxed);
+    }
 
 private:
     // Atomic bitmask: each bit = one seat (0 = available, 1 = occupied)
     std::atomic<uint32_t> occupied_;
     
+    BackoffPolicy policy_;
+    ContentionStats stats_;
+    
     // Mask for all 20 seats
     static constexpr uint32_t ALL_SEATS_MASK = (1u << MAX_SEATS) - 1;
 };
@@ -0,0 +1,78 @@
+#ifndef SEAT_LAYOUT_H
+#define SEAT_LAYOUT_H
+
+#include <cstdint>
+#include <cstddef>
+#include <span>
+#include <vector>
+
+/**
+ * @brief Physical seating plan of a theater: rows and per-seat scores
+ *
+ * Seats a1..aN are laid out row by row: each row is a contiguous range of
+ * 0-based seat indexes, rows ascending from the screen. Every seat has an
+ * integer score (higher = better); block scores are answered in O(1)
+ * from prefix sums.
+ *
+ * Immutable once built, so it is shared between shows by shared_ptr.
+ */
+class SeatLayout {
+public:
+    struct Row {
+        uint32_t firstSeat;  // 0-based index of the row's first seat
+        uint32_t length;     // Seats in the row
+    };
+
+    static constexpr int32_t ROW_WEIGHT = 100;    // Per row away from the preferred row
+    static constexpr int32_t CENTER_WEIGHT = 10;  // Per half seat away from the row center
+
+    /**
+     * @brief Builds a layout from explicit rows and seat scores
+     *
+     * Rows must be contiguous and start at seat 0; seatScores has one
+     * entry per seat. Check isValid() for caller-provided data.
+     */
+    SeatLayout(std::vector<Row> rows, std::vector<int32_t> seatScores);
+
+    /**
+     * @brief rowCount equal rows; scores favor the row center and the preferred row
+     */
+    static SeatLayout uniform(uint32_t rowCount, uint32_t seatsPerRow, uint32_t preferredRow);
+
+    /**
+     * @brief Same, with the preferred row two thirds of the way back
+     */
+    static SeatLayout uniform(uint32_t rowCount, uint32_t seatsPerRow) {
+        return uniform(rowCount, seatsPerRow, rowCount * 2 / 3);
+    }
+
+    /**
+     * @brief One row of `capacity` seats, center preferred (default layout)
+     */
+    static SeatLayout singleRow(uint32_t capacity) {
+        return uniform(1, capacity, 0);
+    }
+
+    /**
+     * @brief True if rows cover 0..capacity-1 contiguously and scores match
+     */
+    bool isValid() const;
+
+    uint32_t getCapacity() const { return static_cast<uint32_t>(scores_.size()); }
+    std::span<const Row> getRows() const { return rows_; }
+    int32_t getSeatScore(uint32_t seat) const { return scores_[seat]; }
+
+    /**
+     * @brief Sum of the scores of seats start..start+count-1 (O(1))
+     */
+    int64_t getBlockScore(uint32_t start, uint32_t count) const {
+        return prefix_[start + count] - prefix_[start];
+    }
+
+private:
+    std::vector<Row> rows_;
+    std::vector<int32_t> scores_;
+    std::vector<int64_t> prefix_;  // prefix_[i] = sum of scores_[0..i-1]
+};
+
+#endif // SEAT_LAYOUT_H
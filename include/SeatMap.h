@@ -0,0 +1,383 @@
+#ifndef SEAT_MAP_H
+#define SEAT_MAP_H
+
+#include "BackoffPolicy.h"
+#include "SeatArena.h"
+#include <bit>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+/**
+ * @brief How a booking claims its bits in a seat word
+ *
+ * - CompareExchange: CAS retry loop with fairness backoff (default)
+ * - FetchOr: wait-free fetch_or, rolls back newly set bits on conflict
+ */
+enum class ClaimStrategy {
+    CompareExchange,
+    FetchOr
+};
+
+/**
+ * @brief Everything tryBook needs to know about contention handling
+ */
+struct ClaimOptions {
+    ClaimStrategy strategy = ClaimStrategy::CompareExchange;
+    BackoffPolicy backoff{};           // CAS loop only
+    ContentionStats* stats = nullptr;  // optional, not owned
+};
+
+/**
+ * @brief Type-erased seat map for one (movie, theater) show
+ *
+ * Seats a1..aN map to bits 0..N-1 of consecutive 64-bit words
+ * (0 = available, 1 = occupied). Implementations:
+ * - FixedSeatBitmask<N> - capacity known at compile time (20, 64, 128, 256, 512)
+ * - WideSeatBitmask     - any other capacity, sized at runtime
+ *
+ * BookingService only sees this interface; create() picks the
+ * specialization from the theater's capacity, so the per-capacity
+ * loops inside tryBook/getAvailableCount have constexpr bounds.
+ */
+class SeatMap {
+public:
+    static constexpr uint32_t MAX_CAPACITY = 4096;
+
+    virtual ~SeatMap() = default;
+
+    /**
+     * @brief Creates the best seat map for a capacity
+     *
+     * Uses FixedSeatBitmask<N> for the common screen sizes and
+     * WideSeatBitmask otherwise. Capacity is clamped to 1..MAX_CAPACITY.
+     */
+    static std::unique_ptr<SeatMap> create(uint32_t capacity);
+
+    /**
+     * @brief Same seat map, constructed in an arena block of the given tier
+     * @return nullptr if the arena cannot fit it; free with destroy()
+     */
+    static SeatMap* create(uint32_t capacity, SeatArena& arena, SeatArena::Tier tier);
+
+    /**
+     * @brief Copy of a quiescent seat map (occupied and held seats) in another tier
+     *
+     * No thread may change `seats` while it is copied.
+     * @return nullptr if the arena cannot fit it; free with destroy()
+     */
+    static SeatMap* relocate(const SeatMap& seats, SeatArena& arena, SeatArena::Tier tier);
+
+    /**
+     * @brief Destroys a seat map made by create(capacity, arena, tier) and frees its block
+     */
+    static void destroy(SeatMap* seats, SeatArena& arena, SeatArena::Tier tier);
+
+    static constexpr uint32_t MAX_WORDS = MAX_CAPACITY / 64;  // Words in the largest mask
+    static constexpr size_t MAX_SEAT_ID_LENGTH = 5;           // "a4096"
+
+    /**
+     * @brief Converts seat ID (e.g., "a150") to bit position
+     *
+     * Single pass, no allocation, no exceptions: "a"/"A" followed by
+     * 1-4 digits without a leading zero. Usable in constant expressions.
+     *
+     * @return Bit position (0 to capacity-1) or -1 if invalid
+     */
+    static constexpr int seatIdToBit(std::string_view seatId, uint32_t capacity) {
+        // "a" followed by 1-4 digits (MAX_CAPACITY has 4 digits)
+        if (seatId.size() < 2 || seatId.size() > 5) {
+            return -1;
+        }
+        if ((seatId[0] | 0x20) != 'a') {
+            return -1;
+        }
+        if (seatId[1] == '0') {
+            return -1;  // Leading zero
+        }
+
+        uint32_t num = 0;
+        for (size_t i = 1; i < seatId.size(); ++i) {
+            uint32_t digit = static_cast<uint32_t>(seatId[i] - '0');
+            if (digit > 9) {
+                return -1;
+            }
+            num = num * 10 + digit;
+        }
+
+        if (num > capacity || num > MAX_CAPACITY) {
+            return -1;
+        }
+        return static_cast<int>(num - 1);
+    }
+
+    /**
+     * @brief Validates that seat ID is valid for the given capacity
+     */
+    static constexpr bool isValidSeatId(std::string_view seatId, uint32_t capacity) {
+        return seatIdToBit(seatId, capacity) >= 0;
+    }
+
+    /**
+     * @brief Creates a multi-word mask for a list of seat IDs
+     * @return One word per getWordCount(); invalid seat IDs are ignored
+     */
+    std::vector<uint64_t> createMask(const std::vector<std::string>& seatIds) const;
+
+    /**
+     * @brief Validates seat IDs and ORs them into a caller-provided mask, in one pass
+     * @param mask At least getWordCount() words (e.g., a stack array of MAX_WORDS)
+     * @return false if any seat ID is invalid for this map (mask is then partial)
+     */
+    bool buildMask(std::span<const std::string_view> seatIds, std::span<uint64_t> mask) const;
+    bool buildMask(std::span<const std::string> seatIds, std::span<uint64_t> mask) const;
+
+    /**
+     * @brief Same as buildMask for pre-parsed 0-based seat indexes
+     */
+    bool buildMask(std::span<const uint16_t> seatIndexes, std::span<uint64_t> mask) const;
+
+    /**
+     * @brief Writes seat ID "aN" for a 0-based seat index (no allocation)
+     * @param out At least MAX_SEAT_ID_LENGTH chars
+     * @return Number of chars written
+     */
+    static constexpr size_t formatSeatId(uint32_t seatIndex, char* out) {
+        char digits[MAX_SEAT_ID_LENGTH];
+        size_t count = 0;
+        for (uint32_t num = seatIndex + 1; num != 0; num /= 10) {
+            digits[count++] = static_cast<char>('0' + num % 10);
+        }
+        out[0] = 'a';
+        for (size_t i = 0; i < count; ++i) {
+            out[1 + i] = digits[count - 1 - i];
+        }
+        return 1 + count;
+    }
+
+    /**
+     * @brief Gets list of available seat IDs (allocates; see forEachAvailable)
+     */
+    std::vector<std::string> getAvailableSeats() const;
+
+    /**
+     * @brief Calls visit(seatIndex) for every free seat, ascending (lock-free, no allocation)
+     *
+     * Walks the inverted occupied words with countr_zero, so the cost is
+     * one step per free seat plus one load per word. A visitor returning
+     * bool stops the walk by returning false.
+     */
+    template <typename Visitor>
+    void forEachAvailable(Visitor&& visit) const {
+        uint32_t capacity = getCapacity();
+        uint32_t wordCount = getWordCount();
+
+        for (uint32_t i = 0; i < wordCount; ++i) {
+            uint32_t base = i * 64;
+            uint64_t valid = capacity - base >= 64 ? ~uint64_t{0}
+                                                   : (uint64_t{1} << (capacity - base)) - 1;
+
+            for (uint64_t free = ~getOccupiedWord(i) & valid; free != 0; free &= free - 1) {
+                uint32_t seat = base + static_cast<uint32_t>(std::countr_zero(free));
+                if constexpr (std::is_same_v<std::invoke_result_t<Visitor&, uint32_t>, bool>) {
+                    if (!visit(seat)) {
+                        return;
+                    }
+                } else {
+                    visit(seat);
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Finds the first run of `count` adjacent free seats at or after `from`
+     *
+     * Shift-and-AND over a snapshot of the inverted words: after log2(count)
+     * steps bit i is set iff seats i..i+count-1 are all free. Runs may span
+     * word boundaries. Lock-free read; the result may be stale by the time
+     * it is claimed.
+     *
+     * @param count Run length, 1..64
+     * @return First seat index of the run, or -1 if there is none
+     */
+    int findFreeRun(uint32_t count, uint32_t from = 0) const;
+
+    /**
+     * @brief Copies the free-seat bits (1 = free) of every word into out
+     * @param out At least getWordCount() words
+     * @return Number of words written
+     */
+    uint32_t loadFreeWords(std::span<uint64_t> out) const;
+
+    /**
+     * @brief Shift-and-AND in place: bit i stays set iff bits i..i+count-1 are set
+     * @param bits Bitmap followed by one extra zero word (runs end there)
+     * @param count Run length, 1..64
+     */
+    static void keepRunStarts(std::span<uint64_t> bits, uint32_t count);
+
+    /**
+     * @brief Writes the free seat IDs, comma-separated, into a caller buffer
+     *
+     * Only whole seat IDs are written; the list stops when the buffer is
+     * full (MAX_SEAT_ID_LENGTH + 1 chars per seat always fit everything).
+     *
+     * @return Number of chars written (no terminator)
+     */
+    size_t formatAvailableSeats(std::span<char> buffer) const;
+
+    /**
+     * @brief Number of seats
+     */
+    virtual uint32_t getCapacity() const = 0;
+
+    /**
+     * @brief Number of 64-bit words in a mask for this map
+     */
+    virtual uint32_t getWordCount() const = 0;
+
+    /**
+     * @brief Attempts to book specified seats (LOCK-FREE, all-or-nothing)
+     * @param seatMask One word per getWordCount()
+     * @param options Claim strategy, backoff policy and optional stats
+     * @return true if all seats were booked, false if at least one was occupied
+     */
+    virtual bool tryBook(std::span<const uint64_t> seatMask, const ClaimOptions& options) = 0;
+
+    /**
+     * @brief Attempts to book specified seats with a strategy and default backoff
+     */
+    bool tryBook(std::span<const uint64_t> seatMask, ClaimStrategy strategy) {
+        ClaimOptions options;
+        options.strategy = strategy;
+        return tryBook(seatMask, options);
+    }
+
+    /**
+     * @brief Attempts to book specified seats with the CAS loop
+     */
+    bool tryBook(std::span<const uint64_t> seatMask) {
+        return tryBook(seatMask, ClaimOptions{});
+    }
+
+    /**
+     * @brief Frees booked seats with one fetch_and per word (LOCK-FREE)
+     *
+     * Only for seats the caller owns (e.g. a booking being cancelled):
+     * the bits are cleared unconditionally.
+     */
+    virtual void release(std::span<const uint64_t> seatMask) = 0;
+
+    /**
+     * @brief Replaces seats the caller owns (`release`) by `claim` (LOCK-FREE)
+     *
+     * All-or-nothing: on failure the map is unchanged. When both masks
+     * touch one word it is a single CAS; otherwise the new seats are
+     * claimed before the old ones are freed.
+     *
+     * @return false if a new seat (not in release) is already occupied
+     */
+    virtual bool tryMove(std::span<const uint64_t> release, std::span<const uint64_t> claim,
+                         const ClaimOptions& options) = 0;
+
+    /**
+     * @brief Claims seats like tryBook and marks them held (LOCK-FREE)
+     *
+     * Held seats are occupied for everyone else (tryBook, tryHold,
+     * getAvailableSeats); the held bitmap only records that the claim is
+     * provisional until confirmHeld or releaseHeld. Those two must only be
+     * called with seats the caller holds.
+     *
+     * Held bits are set after the claim and cleared (by releaseHeld)
+     * before the seats are freed, so held stays a subset of occupied. A
+     * concurrent reader of getHeldWord/getHeldCount may briefly see a hold
+     * being taken or released as booked seats. relocate never sees that
+     * state (it needs a quiescent map) and snapshots rebuild seats from
+     * bookings, not from seat maps.
+     *
+     * @return true if all seats were free and are now held
+     */
+    virtual bool tryHold(std::span<const uint64_t> seatMask, const ClaimOptions& options) = 0;
+
+    /**
+     * @brief Turns held seats into booked seats (clears their held bits)
+     */
+    virtual void confirmHeld(std::span<const uint64_t> seatMask) = 0;
+
+    /**
+     * @brief Frees held seats (clears their held, then occupied bits)
+     */
+    virtual void releaseHeld(std::span<const uint64_t> seatMask) = 0;
+
+    /**
+     * @brief Checks if seats are available (lock-free read)
+     */
+    virtual bool areAvailable(std::span<const uint64_t> seatMask) const = 0;
+
+    /**
+     * @brief Gets number of available seats (lock-free read)
+     */
+    virtual uint32_t getAvailableCount() const = 0;
+
+    /**
+     * @brief Gets occupied bits of one word (lock-free read)
+     */
+    virtual uint64_t getOccupiedWord(uint32_t index) const = 0;
+
+    /**
+     * @brief Gets held bits of one word (lock-free read, subset of occupied)
+     *
+     * Read together with getOccupiedWord, a hold in progress may look
+     * booked (see tryHold).
+     */
+    virtual uint64_t getHeldWord(uint32_t index) const = 0;
+
+    /**
+     * @brief Gets number of held seats (lock-free read)
+     *
+     * May briefly miss a hold being taken or released (see tryHold).
+     */
+    virtual uint32_t getHeldCount() const = 0;
+};
+
+/**
+ * @brief Appends comma-separated seat IDs to a fixed caller buffer
+ */
+class SeatLabelWriter {
+public:
+    explicit SeatLabelWriter(std::span<char> buffer) : buffer_(buffer) {}
+
+    /**
+     * @brief Appends one seat ID (0-based index)
+     * @return false (nothing written) if it does not fit
+     */
+    bool append(uint32_t seatIndex) {
+        char label[SeatMap::MAX_SEAT_ID_LENGTH];
+        size_t length = SeatMap::formatSeatId(seatIndex, label);
+        size_t needed = length + (size_ > 0 ? 1 : 0);
+        if (size_ + needed > buffer_.size()) {
+            return false;
+        }
+        if (size_ > 0) {
+            buffer_[size_++] = ',';
+        }
+        for (size_t i = 0; i < length; ++i) {
+            buffer_[size_++] = label[i];
+        }
+        return true;
+    }
+
+    size_t size() const { return size_; }
+    std::string_view view() const { return {buffer_.data(), size_}; }
+
+private:
+    std::span<char> buffer_;
+    size_t size_ = 0;
+};
+
+#endif // SEAT_MAP_H
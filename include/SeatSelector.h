@@ -0,0 +1,63 @@
+#ifndef SEAT_SELECTOR_H
+#define SEAT_SELECTOR_H
+
+#include "SeatLayout.h"
+#include "SeatMap.h"
+#include <cstdint>
+#include <cstddef>
+#include <span>
+
+/**
+ * @brief One candidate block of adjacent seats
+ */
+struct SeatChoice {
+    int32_t start = -1;  // 0-based index of the first seat, -1 = none
+    int64_t score = 0;
+
+    bool isValid() const { return start >= 0; }
+};
+
+/**
+ * @brief "Best available" ranking of seat blocks for one layout
+ *
+ * For a request of `count` seats:
+ * 1. Snapshot the free bits and keep run starts (SeatMap::keepRunStarts),
+ *    word-parallel over the whole map
+ * 2. AND with each row's allowed starts, so blocks never cross a row
+ * 3. Score every remaining start from the layout's prefix sums, minus
+ *    the orphan penalty per single free seat the block would strand
+ *
+ * Only ranks; claiming the winner (and falling back to the next
+ * candidate on conflict) is up to the caller, e.g.
+ * BookingService::bookBestAvailable.
+ */
+class SeatSelector {
+public:
+    static constexpr int64_t DEFAULT_ORPHAN_PENALTY = 1000;
+    static constexpr size_t MAX_CANDIDATES = 8;  // Fallbacks kept per ranking
+
+    explicit SeatSelector(const SeatLayout& layout, int64_t orphanPenalty = DEFAULT_ORPHAN_PENALTY)
+        : layout_(layout), orphanPenalty_(orphanPenalty) {}
+
+    /**
+     * @brief Best blocks of `count` free adjacent seats in one row
+     * @param out Filled best-first, ties broken by lower seat index
+     * @return Number of candidates written (0 if none fits or capacities differ)
+     */
+    size_t rank(const SeatMap& seats, uint32_t count, std::span<SeatChoice> out) const;
+
+    /**
+     * @brief The single best block (invalid choice if none fits)
+     */
+    SeatChoice select(const SeatMap& seats, uint32_t count) const {
+        SeatChoice best;
+        rank(seats, count, std::span<SeatChoice>(&best, 1));
+        return best;
+    }
+
+private:
+    const SeatLayout& layout_;
+    int64_t orphanPenalty_;
+};
+
+#endif // SEAT_SELECTOR_H
@@ -0,0 +1,289 @@
+#ifndef SEAT_WORD_OPS_H
+#define SEAT_WORD_OPS_H
+
+#include "SeatMap.h"
+#include <cstdint>
+#include <cstddef>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <span>
+
+/**
+ * @brief Word-level seat algorithms shared by every seat map
+ *
+ * Written once against a "word container" (anything with size() and
+ * operator[] returning std::atomic<uint64_t>&). When the container has a
+ * constexpr size() (FixedSeatBitmask) the loops below have constexpr
+ * bounds and unroll; WideSeatBitmask passes a runtime-sized view.
+ */
+namespace seat_ops {
+
+constexpr uint32_t BITS_PER_WORD = 64;
+
+/**
+ * @brief Bits of word `index` that map to real seats for a given capacity
+ */
+constexpr uint64_t validBits(uint32_t capacity, uint32_t index) {
+    uint32_t remaining = capacity - index * BITS_PER_WORD;
+    return remaining >= BITS_PER_WORD ? ~uint64_t{0} : (uint64_t{1} << remaining) - 1;
+}
+
+/**
+ * @brief CAS loop on one word with a pluggable backoff
+ * @return true if all `bits` were free and are now set by this call
+ */
+inline bool claimWord(std::atomic<uint64_t>& word, uint64_t bits,
+                      const BackoffPolicy& policy = BackoffPolicy{},
+                      ContentionStats* stats = nullptr) {
+    for (uint32_t retries = 0; retries < policy.maxRetries; ++retries) {
+        uint64_t expected = word.load(std::memory_order_acquire);
+
+        if ((expected & bits) != 0) {
+            return false;
+        }
+
+        if (word.compare_exchange_weak(
+                expected,
+                expected | bits,
+                std::memory_order_release,
+                std::memory_order_acquire)) {
+            return true;
+        }
+
+        if (stats) {
+            stats->recordRetry();
+        }
+        policy.backoff(retries);
+    }
+
+    if (stats) {
+        stats->recordGiveUp();
+    }
+    return false;
+}
+
+/**
+ * @brief Wait-free claim of one word using fetch_or
+ *
+ * Sets the requested bits unconditionally and inspects the previous
+ * value. On conflict only the bits this call newly set are cleared
+ * again, so seats owned by others are never touched. Always finishes
+ * in one (success) or two (conflict) atomic operations, no retries.
+ *
+ * While a conflicting attempt is being rolled back its bits are
+ * briefly visible, so a concurrent request may fail on seats that end
+ * up free. Bookings are never duplicated.
+ */
+inline bool claimWordFetchOr(std::atomic<uint64_t>& word, uint64_t bits) {
+    uint64_t previous = word.fetch_or(bits, std::memory_order_acq_rel);
+
+    if ((previous & bits) == 0) {
+        return true;
+    }
+
+    uint64_t newlySet = bits & ~previous;
+    if (newlySet != 0) {
+        word.fetch_and(~newlySet, std::memory_order_release);
+    }
+    return false;
+}
+
+/**
+ * @brief Claims one word with the requested strategy
+ */
+template <ClaimStrategy Strategy>
+bool claim(std::atomic<uint64_t>& word, uint64_t bits, const ClaimOptions& options) {
+    if constexpr (Strategy == ClaimStrategy::FetchOr) {
+        return claimWordFetchOr(word, bits);
+    } else {
+        return claimWord(word, bits, options.backoff, options.stats);
+    }
+}
+
+/**
+ * @brief All-or-nothing booking across words
+ *
+ * Words are claimed in ascending order; if one conflicts, the words
+ * already claimed by this call are released. Bits we claimed were 0
+ * before we set them, so clearing them cannot touch anyone else's seats.
+ * The mask must have words.size() entries and be within capacity.
+ */
+template <ClaimStrategy Strategy, typename Words>
+bool tryBook(Words& words, std::span<const uint64_t> mask, const ClaimOptions& options) {
+    for (size_t i = 0; i < words.size(); ++i) {
+        if (mask[i] == 0) {
+            continue;
+        }
+
+        if (!claim<Strategy>(words[i], mask[i], options)) {
+            for (size_t j = 0; j < i; ++j) {
+                if (mask[j] != 0) {
+                    words[j].fetch_and(~mask[j], std::memory_order_release);
+                }
+            }
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Runtime strategy dispatch for tryBook
+ */
+template <typename Words>
+bool tryBook(Words& words, std::span<const uint64_t> mask, const ClaimOptions& options) {
+    if (options.strategy == ClaimStrategy::FetchOr) {
+        return tryBook<ClaimStrategy::FetchOr>(words, mask, options);
+    }
+    return tryBook<ClaimStrategy::CompareExchange>(words, mask, options);
+}
+
+/**
+ * @brief Sets the mask bits (no conflict check)
+ */
+template <typename Words>
+void setBits(Words& words, std::span<const uint64_t> mask) {
+    for (size_t i = 0; i < words.size(); ++i) {
+        if (mask[i] != 0) {
+            words[i].fetch_or(mask[i], std::memory_order_release);
+        }
+    }
+}
+
+/**
+ * @brief Clears the mask bits; only for bits the caller owns
+ */
+template <typename Words>
+void clearBits(Words& words, std::span<const uint64_t> mask) {
+    for (size_t i = 0; i < words.size(); ++i) {
+        if (mask[i] != 0) {
+            words[i].fetch_and(~mask[i], std::memory_order_release);
+        }
+    }
+}
+
+/**
+ * @brief Moves an owner's seats within one word with a single CAS
+ *
+ * Clears `release` and sets `claim` in the same compare-exchange, so no
+ * observer ever sees both sets (or neither) occupied. Fails only if a
+ * seat in claim but not in release is taken by someone else.
+ */
+inline bool moveWord(std::atomic<uint64_t>& word, uint64_t release, uint64_t claim,
+                     const BackoffPolicy& policy = BackoffPolicy{},
+                     ContentionStats* stats = nullptr) {
+    uint64_t fresh = claim & ~release;
+
+    for (uint32_t retries = 0; retries < policy.maxRetries; ++retries) {
+        uint64_t expected = word.load(std::memory_order_acquire);
+
+        if ((expected & fresh) != 0) {
+            return false;
+        }
+
+        if (word.compare_exchange_weak(
+                expected,
+                (expected & ~release) | claim,
+                std::memory_order_acq_rel,
+                std::memory_order_acquire)) {
+            return true;
+        }
+
+        if (stats) {
+            stats->recordRetry();
+        }
+        policy.backoff(retries);
+    }
+
+    if (stats) {
+        stats->recordGiveUp();
+    }
+    return false;
+}
+
+/**
+ * @brief Replaces owned seats `release` by `claim` (all-or-nothing)
+ *
+ * If both masks touch a single word this is one moveWord CAS. Otherwise
+ * the new seats are claimed first (tryBook with rollback) and the old
+ * ones released afterwards: the owner briefly holds both sets, but never
+ * loses the old seats to a failed claim. Seats in both masks stay set
+ * throughout. Masks must be valid for the map (see isValidMask).
+ */
+template <typename Words>
+bool tryMove(Words& words, std::span<const uint64_t> release, std::span<const uint64_t> claim,
+             const ClaimOptions& options) {
+    size_t touched = 0;
+    size_t lastTouched = 0;
+    for (size_t i = 0; i < words.size(); ++i) {
+        if ((release[i] | claim[i]) != 0) {
+            ++touched;
+            lastTouched = i;
+        }
+    }
+
+    if (touched == 1) {
+        return moveWord(words[lastTouched], release[lastTouched], claim[lastTouched],
+                        options.backoff, options.stats);
+    }
+
+    std::array<uint64_t, SeatMap::MAX_WORDS> fresh{};
+    std::array<uint64_t, SeatMap::MAX_WORDS> stale{};
+    for (size_t i = 0; i < words.size(); ++i) {
+        fresh[i] = claim[i] & ~release[i];
+        stale[i] = release[i] & ~claim[i];
+    }
+
+    if (!tryBook(words, std::span<const uint64_t>(fresh.data(), words.size()), options)) {
+        return false;
+    }
+    clearBits(words, std::span<const uint64_t>(stale.data(), words.size()));
+    return true;
+}
+
+/**
+ * @brief Validates a request mask: right size, non-empty, within capacity
+ */
+template <typename Words>
+bool isValidMask(const Words& words, uint32_t capacity, std::span<const uint64_t> mask) {
+    if (mask.size() != words.size()) {
+        return false;
+    }
+
+    uint64_t any = 0;
+    for (size_t i = 0; i < words.size(); ++i) {
+        if ((mask[i] & ~validBits(capacity, static_cast<uint32_t>(i))) != 0) {
+            return false;
+        }
+        any |= mask[i];
+    }
+    return any != 0;
+}
+
+template <typename Words>
+bool areAvailable(const Words& words, std::span<const uint64_t> mask) {
+    size_t count = mask.size() < words.size() ? mask.size() : words.size();
+
+    for (size_t i = 0; i < count; ++i) {
+        if ((words[i].load(std::memory_order_acquire) & mask[i]) != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+template <typename Words>
+uint32_t occupiedCount(const Words& words, uint32_t capacity) {
+    uint32_t count = 0;
+
+    for (size_t i = 0; i < words.size(); ++i) {
+        count += std::popcount(words[i].load(std::memory_order_acquire) &
+                               validBits(capacity, static_cast<uint32_t>(i)));
+    }
+    return count;
+}
+
+} // namespace seat_ops
+
+#endif // SEAT_WORD_OPS_H
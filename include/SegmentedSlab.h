@@ -0,0 +1,80 @@
+#ifndef SEGMENTED_SLAB_H
+#define SEGMENTED_SLAB_H
+
+#include <cstdint>
+#include <array>
+#include <atomic>
+
+/**
+ * @brief Dense, index-addressed array that grows without moving elements
+ *
+ * Elements live in fixed-size segments allocated on first touch:
+ * - index >> log2(SEGMENT_SIZE) selects the segment
+ * - index &  (SEGMENT_SIZE - 1) selects the element
+ *
+ * find() is LOCK-FREE (one acquire load + indexing). at() installs a
+ * missing segment with a single CAS; the loser of a race frees its copy.
+ * Segments are never freed or moved before destruction, so element
+ * addresses are stable and can be handed out as raw pointers.
+ *
+ * Synchronizing access to the elements themselves is up to the caller.
+ */
+template <typename T, uint32_t SEGMENT_SIZE, uint32_t MAX_SEGMENTS>
+class SegmentedSlab {
+    static_assert(SEGMENT_SIZE > 0 && (SEGMENT_SIZE & (SEGMENT_SIZE - 1)) == 0,
+                  "SEGMENT_SIZE must be a power of two");
+
+public:
+    static constexpr uint64_t CAPACITY = static_cast<uint64_t>(SEGMENT_SIZE) * MAX_SEGMENTS;
+
+    SegmentedSlab() = default;
+
+    SegmentedSlab(const SegmentedSlab&) = delete;
+    SegmentedSlab& operator=(const SegmentedSlab&) = delete;
+
+    ~SegmentedSlab() {
+        for (auto& segment : segments_) {
+            delete[] segment.load(std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * @brief Element at index, or nullptr if its segment was never touched (LOCK-FREE)
+     */
+    T* find(uint64_t index) const {
+        if (index >= CAPACITY) {
+            return nullptr;
+        }
+        T* segment = segments_[index / SEGMENT_SIZE].load(std::memory_order_acquire);
+        return segment ? &segment[index % SEGMENT_SIZE] : nullptr;
+    }
+
+    /**
+     * @brief Element at index, allocating its segment if needed
+     * @return nullptr if index >= CAPACITY
+     */
+    T* at(uint64_t index) {
+        if (index >= CAPACITY) {
+            return nullptr;
+        }
+
+        auto& slot = segments_[index / SEGMENT_SIZE];
+        T* segment = slot.load(std::memory_order_acquire);
+        if (segment == nullptr) {
+            T* fresh = new T[SEGMENT_SIZE]();
+            if (slot.compare_exchange_strong(segment, fresh,
+                                             std::memory_order_acq_rel,
+                                             std::memory_order_acquire)) {
+                segment = fresh;
+            } else {
+                delete[] fresh;  // Another thread installed it first
+            }
+        }
+        return &segment[index % SEGMENT_SIZE];
+    }
+
+private:
+    std::array<std::atomic<T*>, MAX_SEGMENTS> segments_{};
+};
+
+#endif // SEGMENTED_SLAB_H
@@ -0,0 +1,106 @@
+#ifndef TIMER_WHEEL_H
+#define TIMER_WHEEL_H
+
+#include <cstdint>
+#include <cstddef>
+#include <array>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Hierarchical timer wheel over integer ticks
+ *
+ * LEVELS wheels of SLOTS buckets each; level L buckets are SLOTS^L ticks
+ * wide. A timer goes into the coarsest level its distance needs, and is
+ * cascaded one level down when the wheel reaches its bucket, so:
+ * - schedule() is O(1) (one push_back)
+ * - advance() is O(elapsed ticks + expired timers + cascaded timers),
+ *   independent of how many timers are pending
+ *
+ * Timers further away than SLOTS^LEVELS ticks wait in the last bucket of
+ * the top level and are re-scheduled from there.
+ *
+ * Not thread-safe: one owner schedules and advances (see
+ * BookingService::expireHolds for the multi-producer front end).
+ */
+class TimerWheel {
+public:
+    static constexpr uint32_t SLOT_BITS = 6;
+    static constexpr uint32_t SLOTS = 1u << SLOT_BITS;  // 64 buckets per level
+    static constexpr uint32_t LEVELS = 4;                // 64^4 ticks of range
+
+    explicit TimerWheel(uint64_t startTick = 0) : currentTick_(startTick) {}
+
+    /**
+     * @brief Schedules `id` to expire at `deadlineTick`
+     *
+     * Deadlines at or before the current tick fire on the next tick.
+     */
+    void schedule(uint64_t id, uint64_t deadlineTick);
+
+    /**
+     * @brief Moves the wheel to `nowTick`, calling expire(id) for every due timer
+     * @return Number of timers expired
+     */
+    template <typename Expire>
+    size_t advance(uint64_t nowTick, Expire&& expire) {
+        size_t expired = 0;
+
+        if (size_ == 0) {
+            currentTick_ = nowTick > currentTick_ ? nowTick : currentTick_;
+            return 0;
+        }
+
+        while (currentTick_ < nowTick && size_ > 0) {
+            ++currentTick_;
+            cascade();
+
+            // Swap the bucket out: entries not yet due are re-scheduled
+            // while it is being walked
+            std::vector<Timer>& bucket = slots_[0][currentTick_ & (SLOTS - 1)];
+            if (bucket.empty()) {
+                continue;
+            }
+            scratch_.swap(bucket);
+            for (const Timer& timer : scratch_) {
+                --size_;
+                if (timer.deadline <= currentTick_) {
+                    expire(timer.id);
+                    ++expired;
+                } else {
+                    schedule(timer.id, timer.deadline);
+                }
+            }
+            scratch_.clear();
+        }
+
+        // Nothing left to walk through: jump straight to now
+        if (size_ == 0 && currentTick_ < nowTick) {
+            currentTick_ = nowTick;
+        }
+        return expired;
+    }
+
+    uint64_t getCurrentTick() const { return currentTick_; }
+
+    /**
+     * @brief Timers scheduled and not yet expired
+     */
+    size_t size() const { return size_; }
+
+private:
+    struct Timer {
+        uint64_t id;
+        uint64_t deadline;
+    };
+
+    void place(const Timer& timer, uint64_t due);
+    void cascade();
+
+    uint64_t currentTick_;
+    size_t size_ = 0;
+    std::array<std::array<std::vector<Timer>, SLOTS>, LEVELS> slots_;
+    std::vector<Timer> scratch_;
+};
+
+#endif // TIMER_WHEEL_H
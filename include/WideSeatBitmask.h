@@ -0,0 +1,117 @@
+#ifndef WIDE_SEAT_BITMASK_H
+#define WIDE_SEAT_BITMASK_H
+
+#include "SeatMap.h"
+#include <cstdint>
+#include <cstddef>
+#include <atomic>
+#include <memory>
+#include <span>
+
+/**
+ * @brief Lock-free seat representation for auditoriums of any size
+ *
+ * Same idea as SeatBitmask, but the seat map is an array of
+ * std::atomic<uint64_t> words sized per theater at creation:
+ * - Word 0, bit 0  = seat a1
+ * - Word 0, bit 63 = seat a64
+ * - Word 1, bit 0  = seat a65
+ * - ...
+ *
+ * Words are grouped in cache-line-aligned blocks of 8 (512 seats per line).
+ *
+ * A request touching a single word is booked with a single CAS, exactly
+ * like SeatBitmask::tryBook. A request spanning several words claims them
+ * in ascending order and rolls back the words it already claimed as soon
+ * as one word conflicts, so the booking stays all-or-nothing.
+ *
+ * Capacities with a compile-time specialization use FixedSeatBitmask
+ * instead (see SeatMap::create).
+ */
+class WideSeatBitmask final : public SeatMap {
+public:
+    static constexpr uint32_t BITS_PER_WORD = 64;
+    static constexpr size_t CACHE_LINE_SIZE = 64;
+
+    /**
+     * @brief Constructor - all seats available
+     * @param capacity Number of seats, clamped to 1..MAX_CAPACITY
+     */
+    explicit WideSeatBitmask(uint32_t capacity);
+
+    WideSeatBitmask(const WideSeatBitmask&) = delete;
+    WideSeatBitmask& operator=(const WideSeatBitmask&) = delete;
+
+    /**
+     * @brief Number of 64-bit words needed for a given capacity
+     */
+    static constexpr uint32_t wordsFor(uint32_t capacity) {
+        return (capacity + BITS_PER_WORD - 1) / BITS_PER_WORD;
+    }
+
+    using SeatMap::tryBook;
+
+    bool tryBook(std::span<const uint64_t> seatMask, const ClaimOptions& options) override;
+    void release(std::span<const uint64_t> seatMask) override;
+    bool tryMove(std::span<const uint64_t> release, std::span<const uint64_t> claim,
+                 const ClaimOptions& options) override;
+    bool tryHold(std::span<const uint64_t> seatMask, const ClaimOptions& options) override;
+    void confirmHeld(std::span<const uint64_t> seatMask) override;
+    void releaseHeld(std::span<const uint64_t> seatMask) override;
+    bool areAvailable(std::span<const uint64_t> seatMask) const override;
+    uint32_t getAvailableCount() const override;
+    uint32_t getHeldCount() const override;
+
+    uint64_t getOccupiedWord(uint32_t index) const override {
+        return words()[index].load(std::memory_order_acquire);
+    }
+
+    uint64_t getHeldWord(uint32_t index) const override {
+        return held()[index].load(std::memory_order_acquire);
+    }
+
+    uint32_t getCapacity() const override { return capacity_; }
+    uint32_t getWordCount() const override { return wordCount_; }
+
+private:
+    static constexpr uint32_t WORDS_PER_LINE = CACHE_LINE_SIZE / sizeof(uint64_t);
+
+    struct alignas(CACHE_LINE_SIZE) WordLine {
+        std::atomic<uint64_t> words[WORDS_PER_LINE];
+    };
+
+    // Runtime-sized word container for seat_ops
+    template <typename Word, typename Line>
+    struct WordView {
+        Line* lines;
+        uint32_t count;
+
+        size_t size() const { return count; }
+        Word& operator[](size_t index) const {
+            return lines[index / WORDS_PER_LINE].words[index % WORDS_PER_LINE];
+        }
+    };
+
+    uint32_t capacity_;
+    uint32_t wordCount_;
+    std::unique_ptr<WordLine[]> lines_;
+    std::unique_ptr<WordLine[]> heldLines_;  // Held (not yet confirmed) subset of lines_
+
+    WordView<std::atomic<uint64_t>, WordLine> words() {
+        return {lines_.get(), wordCount_};
+    }
+
+    WordView<const std::atomic<uint64_t>, const WordLine> words() const {
+        return {lines_.get(), wordCount_};
+    }
+
+    WordView<std::atomic<uint64_t>, WordLine> held() {
+        return {heldLines_.get(), wordCount_};
+    }
+
+    WordView<const std::atomic<uint64_t>, const WordLine> held() const {
+        return {heldLines_.get(), wordCount_};
+    }
+};
+
+#endif // WIDE_SEAT_BITMASK_H
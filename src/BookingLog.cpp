@@ -0,0 +1,530 @@
+#include "BookingLog.h"
+#include "Checksum.h"
+#include <algorithm>
+#include <bit>
+#include <cerrno>
+#include <cstdio>
+#include <filesystem>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+uint32_t LogRecord::computeChecksum() const {
+    LogRecord copy = *this;
+    copy.checksum = 0;
+    return crc32c(&copy, sizeof(copy));
+}
+
+namespace {
+    // Leading records that are whole, intact and numbered from firstLsn
+    uint64_t countIntact(int fd, uint64_t records, uint64_t firstLsn) {
+        std::vector<LogRecord> chunk(4096);
+        uint64_t intact = 0;
+        while (intact < records) {
+            size_t wanted = static_cast<size_t>(std::min<uint64_t>(chunk.size(), records - intact));
+            ssize_t got = ::pread(fd, chunk.data(), wanted * sizeof(LogRecord),
+                                  static_cast<off_t>(intact * sizeof(LogRecord)));
+            if (got != static_cast<ssize_t>(wanted * sizeof(LogRecord))) {
+                return intact;
+            }
+            for (size_t i = 0; i < wanted; ++i, ++intact) {
+                if (chunk[i].lsn != firstLsn + intact || !chunk[i].isIntact()) {
+                    return intact;
+                }
+            }
+        }
+        return intact;
+    }
+
+    // Segment files are "<path>.<first lsn, 20 digits>", so names sort by lsn
+    constexpr size_t LSN_DIGITS = 20;
+
+    std::string segmentPath(const std::string& path, uint64_t firstLsn) {
+        char suffix[LSN_DIGITS + 2];
+        std::snprintf(suffix, sizeof(suffix), ".%020llu", static_cast<unsigned long long>(firstLsn));
+        return path + suffix;
+    }
+
+    std::vector<BookingLog::Segment> findSegments(const std::string& path) {
+        namespace fs = std::filesystem;
+        fs::path base(path);
+        fs::path directory = base.has_parent_path() ? base.parent_path() : fs::path(".");
+        std::string prefix = base.filename().string() + ".";
+
+        std::vector<BookingLog::Segment> segments;
+        std::error_code error;
+        for (fs::directory_iterator it(directory, error); !error && it != fs::directory_iterator();
+             it.increment(error)) {
+            std::string name = it->path().filename().string();
+            if (name.size() == prefix.size() + LSN_DIGITS && name.compare(0, prefix.size(), prefix) == 0 &&
+                std::all_of(name.begin() + prefix.size(), name.end(), [](char c) { return c >= '0' && c <= '9'; })) {
+                segments.push_back({it->path().string(), std::stoull(name.substr(prefix.size())), 0});
+            }
+        }
+        std::sort(segments.begin(), segments.end(),
+                  [](const auto& a, const auto& b) { return a.firstLsn < b.firstLsn; });
+        return segments;
+    }
+
+    void syncDirectoryOf(const std::string& path) {
+        std::string directory = path.substr(0, path.find_last_of('/') + 1);
+        int fd = ::open(directory.empty() ? "." : directory.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+        if (fd >= 0) {
+            ::fsync(fd);
+            ::close(fd);
+        }
+    }
+}
+
+std::unique_ptr<BookingLog> BookingLog::open(const std::string& path, const Options& options) {
+    std::vector<Segment> segments;
+    if (options.segmentBytes == 0) {
+        segments.push_back({path, 1, 0});
+    } else {
+        segments = findSegments(path);
+        if (segments.empty()) {
+            segments.push_back({segmentPath(path, 1), 1, 0});
+        }
+    }
+
+    // A crash can leave a torn tail: part of a record, or a whole one
+    // with stale contents. Keep every record before the first torn one
+    // and drop the rest (later segments too), so new records stay
+    // aligned and lsns stay dense
+    int fd = -1;
+    uint64_t tornBytes = 0;
+    bool torn = false;
+    std::vector<Segment> kept;
+    for (Segment segment : segments) {
+        struct stat info;
+        if (torn || (!kept.empty() && segment.firstLsn != kept.back().firstLsn + kept.back().records)) {
+            tornBytes += ::stat(segment.path.c_str(), &info) == 0 ? static_cast<uint64_t>(info.st_size) : 0;
+            ::unlink(segment.path.c_str());
+            torn = true;
+            continue;
+        }
+
+        // Not O_APPEND: groups are written at explicit offsets, possibly
+        // several at once (LogBackend::IoUring)
+        int segmentFd = ::open(segment.path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+        if (segmentFd < 0 || ::fstat(segmentFd, &info) != 0) {
+            if (segmentFd >= 0) {
+                ::close(segmentFd);
+            }
+            if (fd >= 0) {
+                ::close(fd);
+            }
+            return nullptr;
+        }
+        uint64_t size = static_cast<uint64_t>(info.st_size);
+        LogRecord first;
+        if (options.segmentBytes == 0 && ::pread(segmentFd, &first, sizeof(first), 0) == sizeof(first) &&
+            first.isIntact()) {
+            segment.firstLsn = first.lsn;  // Moved on by advanceTo
+        }
+        segment.records = countIntact(segmentFd, size / sizeof(LogRecord), segment.firstLsn);
+        if (segment.records * sizeof(LogRecord) != size) {
+            torn = true;
+            tornBytes += size - segment.records * sizeof(LogRecord);
+            if (::ftruncate(segmentFd, static_cast<off_t>(segment.records * sizeof(LogRecord))) != 0) {
+                ::close(segmentFd);
+                if (fd >= 0) {
+                    ::close(fd);
+                }
+                return nullptr;
+            }
+        }
+
+        // The last segment kept is the one appended to
+        if (fd >= 0) {
+            ::close(fd);
+        }
+        fd = segmentFd;
+        kept.push_back(segment);
+    }
+
+    // A crash mid-group can keep an Exchange but tear the Cancel after
+    // it: the pair only counts whole. Groups never span segments, so
+    // only the last one can end that way.
+    Segment& last = kept.back();
+    LogRecord lastRecord;
+    if (last.records > 0 &&
+        ::pread(fd, &lastRecord, sizeof(lastRecord),
+                static_cast<off_t>((last.records - 1) * sizeof(LogRecord))) == sizeof(lastRecord) &&
+        lastRecord.type == LogRecord::Type::Exchange) {
+        --last.records;
+        tornBytes += sizeof(LogRecord);
+        if (::ftruncate(fd, static_cast<off_t>(last.records * sizeof(LogRecord))) != 0) {
+            ::close(fd);
+            return nullptr;
+        }
+    }
+
+    return std::unique_ptr<BookingLog>(new BookingLog(fd, path, std::move(kept), tornBytes, options));
+}
+
+BookingLog::BookingLog(int fd, const std::string& path, std::vector<Segment> segments, uint64_t tornBytes,
+                       const Options& options)
+    : options_(options), path_(path), fd_(fd),
+      firstLsn_(segments.back().firstLsn + segments.back().records), tornBytes_(tornBytes),
+      mask_(std::bit_ceil(std::max<uint64_t>(options.ringCapacity, 2)) - 1),
+      ring_(new Slot[mask_ + 1]), writeOffset_(segments.back().records * sizeof(LogRecord)),
+      segments_(std::move(segments)) {
+    for (uint64_t position = 0; position <= mask_; ++position) {
+        ring_[position].sequence.store(position, std::memory_order_relaxed);
+    }
+
+    // The records kept by open() are already in the file
+    ::fdatasync(fd_);
+    durableLsn_.store(firstLsn_ - 1, std::memory_order_relaxed);
+
+    // Two entries per group (write + fdatasync). Registered buffers save
+    // the kernel mapping the pages on every write; without them (e.g.
+    // over RLIMIT_MEMLOCK) plain writes still overlap
+    uint32_t groups = 1;
+    if (options.backend == LogBackend::IoUring) {
+        groups = std::max<uint32_t>(options.groupsInFlight, 1);
+        uring_ = IoUring::create(2 * groups);
+    }
+    if (!uring_) {
+        groups = 1;
+    }
+    batches_.assign(groups, std::vector<LogRecord>(mask_ + 1));
+    if (uring_) {
+        std::vector<iovec> buffers;
+        for (auto& batch : batches_) {
+            buffers.push_back({batch.data(), batch.size() * sizeof(LogRecord)});
+        }
+        fixedBuffers_ = uring_->registerBuffers(buffers);
+    }
+
+    startFlusher();
+}
+
+BookingLog::~BookingLog() {
+    stopFlusher();
+    ::close(fd_);
+}
+
+void BookingLog::startFlusher() {
+    stopping_.store(false, std::memory_order_relaxed);
+    flusher_ = std::thread([this]() {
+        if (uring_) {
+            flushLoopUring();
+        } else {
+            flushLoop();
+        }
+    });
+}
+
+void BookingLog::stopFlusher() {
+    stopping_.store(true, std::memory_order_release);
+    flusher_.join();
+}
+
+// ===== Producers (LOCK-FREE) =====
+
+uint64_t BookingLog::append(const LogRecord& record) {
+    return append(std::span<const LogRecord>(&record, 1));
+}
+
+uint64_t BookingLog::append(std::span<const LogRecord> records) {
+    uint64_t first = tail_.fetch_add(records.size(), std::memory_order_relaxed);
+    for (size_t i = 0; i < records.size(); ++i) {
+        uint64_t position = first + i;
+        Slot& slot = ring_[position & mask_];
+
+        // Free once the flusher drained the record one lap ago
+        while (slot.sequence.load(std::memory_order_acquire) != position) {
+            std::this_thread::yield();
+        }
+
+        slot.record = records[i];
+        slot.record.lsn = firstLsn_ + position;
+        slot.sequence.store(position + 1, std::memory_order_release);
+    }
+    return firstLsn_ + first + records.size() - 1;
+}
+
+bool BookingLog::waitDurable(uint64_t lsn) const {
+    for (;;) {
+        // Read the round first: a flush finishing after these checks
+        // bumps it, so wait() cannot miss it
+        uint64_t round = rounds_.load(std::memory_order_acquire);
+        if (durableLsn_.load(std::memory_order_acquire) >= lsn) {
+            return true;
+        }
+        if (failed_.load(std::memory_order_acquire)) {
+            return false;
+        }
+        rounds_.wait(round, std::memory_order_acquire);
+    }
+}
+
+// ===== Segments =====
+
+std::vector<BookingLog::Segment> BookingLog::getSegments() const {
+    std::lock_guard<std::mutex> lock(segmentsMutex_);
+    std::vector<Segment> segments = segments_;
+    segments.back().records = getNextLsn() - segments.back().firstLsn;
+    return segments;
+}
+
+size_t BookingLog::removeSegmentsBefore(uint64_t lsn) {
+    std::lock_guard<std::mutex> lock(segmentsMutex_);
+    size_t removed = 0;
+    while (segments_.size() > 1 && segments_.front().firstLsn + segments_.front().records <= lsn) {
+        ::unlink(segments_.front().path.c_str());
+        segments_.erase(segments_.begin());
+        ++removed;
+    }
+    return removed;
+}
+
+bool BookingLog::advanceTo(uint64_t lsn) {
+    if (lsn <= getNextLsn()) {
+        return true;
+    }
+
+    // With the flusher stopped every appended record is written and the
+    // files are ours until it restarts
+    stopFlusher();
+    bool moved = !failed_.load(std::memory_order_acquire);
+    if (moved && options_.segmentBytes == 0) {
+        // One file: it starts over, open() reads its first lsn back
+        moved = ::ftruncate(fd_, 0) == 0 && ::fdatasync(fd_) == 0;
+        if (moved) {
+            std::lock_guard<std::mutex> lock(segmentsMutex_);
+            segments_ = {{path_, lsn, 0}};
+        }
+    } else if (moved) {
+        // The new segment first: a crash before the old ones are gone
+        // leaves a gap open() drops, and recovery advances again
+        std::string path = segmentPath(path_, lsn);
+        int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        moved = fd >= 0;
+        if (moved) {
+            syncDirectoryOf(path);
+            ::close(fd_);
+            fd_ = fd;
+            std::lock_guard<std::mutex> lock(segmentsMutex_);
+            for (const Segment& segment : segments_) {
+                ::unlink(segment.path.c_str());
+            }
+            segments_ = {{path, lsn, 0}};
+        }
+    }
+    if (moved) {
+        firstLsn_ = lsn - head_;  // head_ == tail_: everything was drained
+        writeOffset_ = 0;
+        durableLsn_.store(lsn - 1, std::memory_order_release);
+    }
+    startFlusher();
+    return moved;
+}
+
+bool BookingLog::rotationDue() const {
+    return options_.segmentBytes != 0 && writeOffset_ >= options_.segmentBytes;
+}
+
+bool BookingLog::rotate() {
+    // Groups are drained in lsn order: the next one starts the segment
+    uint64_t firstLsn = firstLsn_ + head_;
+    std::string path = segmentPath(path_, firstLsn);
+    int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        return false;
+    }
+    syncDirectoryOf(path);
+
+    ::close(fd_);
+    fd_ = fd;
+    writeOffset_ = 0;
+
+    std::lock_guard<std::mutex> lock(segmentsMutex_);
+    segments_.back().records = firstLsn - segments_.back().firstLsn;
+    segments_.push_back({path, firstLsn, 0});
+    return true;
+}
+
+// ===== Flusher =====
+
+void BookingLog::flushLoop() {
+    for (;;) {
+        auto windowEnd = std::chrono::steady_clock::now() + options_.groupCommitWindow;
+        bool stopping = stopping_.load(std::memory_order_acquire);
+
+        if (rotationDue() && !failed_.load(std::memory_order_relaxed) && !rotate()) {
+            failed_.store(true, std::memory_order_release);
+            publish(0, 0);
+        }
+
+        // One group: everything appended since the last one
+        size_t count = drain(batches_[0]);
+        if (count > 0) {
+            if (!failed_.load(std::memory_order_relaxed) && writeBatch(batches_[0], count)) {
+                publish(firstLsn_ + head_ - 1, 1);
+            } else {
+                failed_.store(true, std::memory_order_release);
+                publish(0, 0);
+            }
+        } else if (stopping) {
+            return;  // Every record appended before the stop is written
+        }
+
+        if (!stopping) {
+            std::this_thread::sleep_until(windowEnd);
+        }
+    }
+}
+
+void BookingLog::flushLoopUring() {
+    // Groups are submitted in lsn order and may complete in any order;
+    // the durable lsn only advances over a prefix of synced groups
+    static constexpr uint64_t WRITE_TAG = uint64_t{1} << 63;
+    const uint64_t groups = batches_.size();
+    std::vector<uint64_t> groupEnd(groups, 0);     // Last lsn of the group
+    std::vector<uint32_t> groupBytes(groups, 0);
+    std::vector<bool> groupSynced(groups, false);
+    uint64_t submitted = 0;  // Groups handed to the kernel
+    uint64_t retired = 0;    // Leading groups whose sync completed
+
+    for (;;) {
+        auto windowEnd = std::chrono::steady_clock::now() + options_.groupCommitWindow;
+        bool stopping = stopping_.load(std::memory_order_acquire);
+
+        // A new segment once the groups written to the old one are synced
+        bool rotating = rotationDue() && !failed_.load(std::memory_order_relaxed);
+        if (rotating && submitted == retired) {
+            if (!rotate()) {
+                failed_.store(true, std::memory_order_release);
+                publish(0, 0);
+            }
+            rotating = false;
+        }
+
+        // One group per window while a batch is free
+        size_t count = 0;
+        if (!rotating && submitted - retired < groups) {
+            uint64_t group = submitted % groups;
+            count = drain(batches_[group]);
+            if (count > 0) {
+                uint32_t bytes = static_cast<uint32_t>(count * sizeof(LogRecord));
+                int bufferIndex = fixedBuffers_ ? static_cast<int>(group) : -1;
+                if (!failed_.load(std::memory_order_relaxed) &&
+                    uring_->write(fd_, batches_[group].data(), bytes, writeOffset_, bufferIndex,
+                                  WRITE_TAG | group, true) &&
+                    uring_->fdatasync(fd_, group)) {
+                    groupEnd[group] = firstLsn_ + head_ - 1;
+                    groupBytes[group] = bytes;
+                    groupSynced[group] = false;
+                    ++submitted;
+                } else {
+                    failed_.store(true, std::memory_order_release);
+                    publish(0, 0);
+                }
+                writeOffset_ += bytes;
+            }
+        }
+        if (stopping && count == 0 && submitted == retired) {
+            return;  // Every record appended before the stop is written
+        }
+
+        // Submit, then collect completions until the window ends. With
+        // every batch in flight, or when stopping, wait for one at least.
+        bool mustWait = submitted - retired == groups || stopping || rotating;
+        do {
+            bool inFlight = submitted != retired;
+            if (!inFlight) {
+                if (!stopping) {
+                    std::this_thread::sleep_until(windowEnd);
+                }
+                break;
+            }
+            auto timeout = mustWait ? std::chrono::nanoseconds::max()
+                                    : std::chrono::nanoseconds(windowEnd - std::chrono::steady_clock::now());
+            if (!uring_->submitAndWait(1, timeout)) {
+                failed_.store(true, std::memory_order_release);
+            }
+            mustWait = false;
+
+            IoUring::Completion completion;
+            bool any = false;
+            while (uring_->popCompletion(completion)) {
+                uint64_t group = completion.userData & ~WRITE_TAG;
+                bool write = completion.userData & WRITE_TAG;
+                if (completion.result < 0 ||
+                    (write && static_cast<uint32_t>(completion.result) != groupBytes[group])) {
+                    failed_.store(true, std::memory_order_release);
+                }
+                if (!write) {
+                    groupSynced[group] = true;
+                }
+                any = true;
+            }
+
+            uint64_t synced = 0;
+            uint64_t durable = 0;
+            while (retired < submitted && groupSynced[retired % groups]) {
+                durable = groupEnd[retired % groups];
+                ++retired;
+                ++synced;
+            }
+            if (any) {
+                publish(failed_.load(std::memory_order_relaxed) ? 0 : durable, synced);
+            }
+        } while (!stopping && !rotating && std::chrono::steady_clock::now() < windowEnd);
+    }
+}
+
+void BookingLog::publish(uint64_t durableLsn, uint64_t groups) {
+    if (durableLsn != 0) {
+        durableLsn_.store(durableLsn, std::memory_order_release);
+        flushCount_.fetch_add(groups, std::memory_order_relaxed);
+    }
+    rounds_.fetch_add(1, std::memory_order_release);
+    rounds_.notify_all();
+}
+
+size_t BookingLog::drain(std::vector<LogRecord>& batch) {
+    // Stops at the first slot not yet published, so records are written
+    // in lsn order; copying frees the slots before the slow write
+    size_t count = 0;
+    while (count < batch.size()) {
+        Slot& slot = ring_[head_ & mask_];
+        if (slot.sequence.load(std::memory_order_acquire) != head_ + 1) {
+            break;
+        }
+        // An Exchange only goes with its Cancel: no group (and so no
+        // segment) ends between them
+        if (slot.record.type == LogRecord::Type::Exchange &&
+            (count + 2 > batch.size() ||
+             ring_[(head_ + 1) & mask_].sequence.load(std::memory_order_acquire) != head_ + 2)) {
+            break;
+        }
+        batch[count] = slot.record;
+        batch[count].checksum = batch[count].computeChecksum();
+        ++count;
+        slot.sequence.store(head_ + mask_ + 1, std::memory_order_release);
+        ++head_;
+    }
+    return count;
+}
+
+bool BookingLog::writeBatch(const std::vector<LogRecord>& batch, size_t count) {
+    const char* data = reinterpret_cast<const char*>(batch.data());
+    size_t remaining = count * sizeof(LogRecord);
+    while (remaining > 0) {
+        ssize_t written = ::pwrite(fd_, data, remaining, static_cast<off_t>(writeOffset_));
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        data += written;
+        remaining -= static_cast<size_t>(written);
+        writeOffset_ += static_cast<uint64_t>(written);
+    }
+    return ::fdatasync(fd_) == 0;
+}
@@ -1,67 +1,196 @@
 #include "BookingService.h"
+#include "BookingSnapshot.h"
+#include "EpochReclaimer.h"
+#include "SeatSelector.h"
 #include <algorithm>
+#include <array>
+#include <bit>
 #include <mutex>
+#include <ranges>
+#include <thread>
+#include <unordered_map>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
-BookingService::BookingService() : nextBookingId_(1) {
+namespace {
+    // Swaps in a new immutable version and retires the previous one
+    template <typename T>
+    void publish(std::atomic<const T*>& slot, const T* next) {
+        const T* previous = slot.exchange(next, std::memory_order_acq_rel);
+        if (previous) {
+            EpochReclaimer::global().retire(previous);
+        }
+    }
+    
+    // Per-thread booking id blocks, keyed by service instance (never by
+    // address: a new service may reuse a destroyed one's memory)
+    std::atomic<uint64_t> nextInstanceId{1};
+    
+    struct IdBlock {
+        uint64_t instance = 0;
+        uint64_t next = 0;
+        uint64_t end = 0;
+        uint64_t size = 0;  // Last refill size, doubled per refill
+    };
+    
+    constexpr size_t ID_CACHE_WAYS = 4;  // Services one thread books on at once
+    
+    thread_local std::array<IdBlock, ID_CACHE_WAYS> idCache;
+    thread_local size_t idCacheVictim = 0;
 }
 
-// ===== Movie Operations =====
+BookingService::BookingService() : BookingService(BookingServiceConfig{}) {
+}
 
-void BookingService::addMovie(std::shared_ptr<Movie> movie) {
-    std::unique_lock<std::shared_mutex> lock(metadataMutex_);
-    movies_[movie->id] = movie;
+BookingService::BookingService(const BookingServiceConfig& config)
+    : config_(config), movieList_(new MovieList()),
+      instanceId_(nextInstanceId.fetch_add(1, std::memory_order_relaxed)), nextBookingId_(1), nextHoldId_(1),
+      holdEpoch_(std::chrono::steady_clock::now()) {
+    claimOptions_.strategy = config_.claimStrategy;
+    claimOptions_.backoff = config_.backoff;
+    claimOptions_.stats = &contentionStats_;
+    
+    // A log that cannot be opened leaves log_ null: hasLogFailed() reports
+    // it, and GroupSync calls refuse every change
+    if (config_.durability != Durability::None) {
+        log_ = BookingLog::open(config_.logPath, {.durability = config_.durability,
+                                                  .groupCommitWindow = config_.groupCommitWindow,
+                                                  .ringCapacity = config_.logRingCapacity,
+                                                  .backend = config_.logBackend,
+                                                  .segmentBytes = config_.logSegmentBytes});
+    }
 }
 
-std::vector<std::shared_ptr<Movie>> BookingService::getAllMovies() const {
-    std::shared_lock<std::shared_mutex> lock(metadataMutex_);
-    std::vector<std::shared_ptr<Movie>> result;
-    result.reserve(movies_.size());
+BookingService::~BookingService() {
+    if (compactor_.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(compactorMutex_);
+            stopCompactor_ = true;
+        }
+        compactorWake_.notify_all();
+        compactor_.join();
+    }
     
-    for (const auto& pair : movies_) {
-        result.push_back(pair.second);
+    // Seat maps live in seatArena_; only their destructors are needed
+    for (uint32_t i = 0; i < showCount_; ++i) {
+        Show* show = shows_.find(i);
+        SeatMap::destroy(show->seats.load(std::memory_order_relaxed), seatArena_,
+                         show->tier.load(std::memory_order_relaxed));
     }
+    // Current versions; retired ones belong to the reclaimer
+    for (auto& entry : movieEntries_) {
+        delete entry.current.load(std::memory_order_relaxed);
+    }
+    for (auto& entry : theaterEntries_) {
+        delete entry.current.load(std::memory_order_relaxed);
+    }
+    delete movieList_.load(std::memory_order_relaxed);
+}
+
+// ===== Catalog Lookups (caller holds an epoch guard) =====
+
+const BookingService::MovieRecord* BookingService::findMovie(uint32_t movieId) const {
+    const auto* entry = movies_.find(movieId);
+    return entry ? entry->current.load(std::memory_order_acquire) : nullptr;
+}
+
+const BookingService::TheaterRecord* BookingService::findTheater(uint32_t theaterId) const {
+    const auto* entry = theaters_.find(theaterId);
+    return entry ? entry->current.load(std::memory_order_acquire) : nullptr;
+}
+
+// ===== Movie Operations =====
+
+void BookingService::addMovie(const Movie& added) {
+    std::lock_guard<std::mutex> lock(catalogWriterMutex_);
     
-    return result;
+    // Pooled copy; replaced movies stay in the pool for existing views
+    const Movie* movie = &moviePool_.emplace_back(added);
+    auto* entry = movies_.insertIfAbsent(movie->id, [this]() {
+        return &movieEntries_.emplace_back();
+    });
+    
+    // Replacing a movie keeps its theater links
+    const MovieRecord* previous = entry->current.load(std::memory_order_relaxed);
+    auto* record = new MovieRecord{movie, previous ? previous->theaterIds : std::vector<uint32_t>{}};
+    publish(entry->current, static_cast<const MovieRecord*>(record));
+    
+    // New sorted movie list
+    auto* list = new MovieList(*movieList_.load(std::memory_order_relaxed));
+    auto it = std::lower_bound(list->begin(), list->end(), movie->id,
+        [](const Movie* m, uint32_t id) { return m->id < id; });
+    if (it != list->end() && (*it)->id == movie->id) {
+        *it = movie;
+    } else {
+        list->insert(it, movie);
+    }
+    publish(movieList_, static_cast<const MovieList*>(list));
+}
+
+std::vector<const Movie*> BookingService::getAllMovies() const {
+    auto guard = EpochReclaimer::global().pin();
+    return *movieList_.load(std::memory_order_acquire);
 }
 
-std::shared_ptr<Movie> BookingService::getMovie(uint32_t movieId) const {
-    std::shared_lock<std::shared_mutex> lock(metadataMutex_);
-    auto it = movies_.find(movieId);
-    return (it != movies_.end()) ? it->second : nullptr;
+const Movie* BookingService::getMovie(uint32_t movieId) const {
+    auto guard = EpochReclaimer::global().pin();
+    const MovieRecord* record = findMovie(movieId);
+    return record ? record->movie : nullptr;
 }
 
 // ===== Theater Operations =====
 
-void BookingService::addTheater(std::shared_ptr<Theater> theater) {
-    std::unique_lock<std::shared_mutex> lock(metadataMutex_);
-    theaters_[theater->id] = theater;
+void BookingService::addTheater(const Theater& added) {
+    std::lock_guard<std::mutex> lock(catalogWriterMutex_);
+    
+    const Theater* theater = &theaterPool_.emplace_back(added);
+    auto* entry = theaters_.insertIfAbsent(theater->id, [this]() {
+        return &theaterEntries_.emplace_back();
+    });
+    publish(entry->current, static_cast<const TheaterRecord*>(new TheaterRecord{theater}));
 }
 
 bool BookingService::linkMovieToTheater(uint32_t movieId, uint32_t theaterId) {
-    std::unique_lock<std::shared_mutex> lock(metadataMutex_);
+    std::lock_guard<std::mutex> lock(catalogWriterMutex_);
     
-    // Check that movie and theater exist
-    if (movies_.find(movieId) == movies_.end() || 
-        theaters_.find(theaterId) == theaters_.end()) {
+    // Check that movie and theater exist (no guard needed: we are the only writer)
+    auto* entry = movies_.find(movieId);
+    if (!entry || !findTheater(theaterId)) {
         return false;
     }
     
-    // Add link
-    movieToTheaters_[movieId].push_back(theaterId);
+    // Add link (copy-on-write of this movie's record only)
+    auto* record = new MovieRecord(*entry->current.load(std::memory_order_relaxed));
+    record->theaterIds.push_back(theaterId);
+    publish(entry->current, static_cast<const MovieRecord*>(record));
     
     return true;
 }
 
-std::vector<std::shared_ptr<Theater>> BookingService::getTheatersForMovie(uint32_t movieId) const {
-    std::shared_lock<std::shared_mutex> lock(metadataMutex_);
-    std::vector<std::shared_ptr<Theater>> result;
+const Theater* BookingService::getTheater(uint32_t theaterId) const {
+    auto guard = EpochReclaimer::global().pin();
+    const TheaterRecord* record = findTheater(theaterId);
+    return record ? record->theater : nullptr;
+}
+
+uint32_t BookingService::getTheaterCapacity(uint32_t theaterId) const {
+    auto guard = EpochReclaimer::global().pin();
+    const TheaterRecord* record = findTheater(theaterId);
+    return record ? record->theater->capacity : Theater::DEFAULT_CAPACITY;
+}
+
+std::vector<const Theater*> BookingService::getTheatersForMovie(uint32_t movieId) const {
+    auto guard = EpochReclaimer::global().pin();
+    std::vector<const Theater*> result;
     
-    auto it = movieToTheaters_.find(movieId);
-    if (it != movieToTheaters_.end()) {
-        for (uint32_t theaterId : it->second) {
-            auto theaterIt = theaters_.find(theaterId);
-            if (theaterIt != theaters_.end()) {
-                result.push_back(theaterIt->second);
+    const MovieRecord* movie = findMovie(movieId);
+    if (movie) {
+        for (uint32_t theaterId : movie->theaterIds) {
+            const TheaterRecord* theater = findTheater(theaterId);
+            if (theater) {
+                result.push_back(theater->theater);
             }
         }
     }
@@ -71,153 +200,1758 @@ std::vector<std::shared_ptr<Theater>> BookingService::getTheatersForMovie(uint32
 
 // ===== Seat Operations (LOCK-FREE!) =====
 
-std::shared_ptr<SeatBitmask> BookingService::getSeatMask(
-    uint32_t movieId, uint32_t theaterId) const {
-    
-    std::shared_lock<std::shared_mutex> lock(seatsMutex_);
-    auto key = std::make_pair(movieId, theaterId);
-    auto it = seatMasks_.find(key);
-    return (it != seatMasks_.end()) ? it->second : nullptr;
+const BookingService::Show* BookingService::findShow(uint32_t movieId, uint32_t theaterId) const {
+    // LOCK-FREE lookup (no global lock, no tree walk)
+    return showIndex_.find(showKey(movieId, theaterId));
 }
 
-std::shared_ptr<SeatBitmask> BookingService::getOrCreateSeatMask(
-    uint32_t movieId, uint32_t theaterId) {
-    
-    auto key = std::make_pair(movieId, theaterId);
-    
-    // Try read first (shared lock)
-    {
-        std::shared_lock<std::shared_mutex> lock(seatsMutex_);
-        auto it = seatMasks_.find(key);
-        if (it != seatMasks_.end()) {
-            return it->second;
+BookingService::SeatLease::SeatLease(const Show& show)
+    : guard_(pinSettled(show)), seats_(show.seats.load(std::memory_order_acquire)) {
+}
+
+EpochReclaimer::Guard BookingService::SeatLease::pinSettled(const Show& show) {
+    for (;;) {
+        {
+            // The fence in pin() orders this flag load after our epoch
+            // store, so rebalanceSeats either waits for us or we see it
+            EpochReclaimer::Guard guard = EpochReclaimer::global().pin();
+            if (!show.moving.load(std::memory_order_acquire)) {
+                return guard;
+            }
+        }
+        
+        // A move is in progress: wait for it outside the guard
+        while (show.moving.load(std::memory_order_acquire)) {
+            std::this_thread::yield();
         }
     }
+}
+
+ClaimOptions BookingService::claimOptionsFor(const Show& show) const {
+    ClaimOptions options = claimOptions_;
+    options.stats = &show.contention;
+    return options;
+}
+
+BookingService::Show* BookingService::getOrCreateShow(
+    uint32_t movieId, uint32_t theaterId, uint32_t capacity,
+    std::shared_ptr<const SeatLayout> layout) {
     
-    // Need to create - upgrade to unique lock
-    std::unique_lock<std::shared_mutex> lock(seatsMutex_);
-    
-    // Double-check (might have been created between locks)
-    auto it = seatMasks_.find(key);
-    if (it != seatMasks_.end()) {
-        return it->second;
+    // Insert-if-absent: the factory runs at most once per show,
+    // under the index's writer lock
+    return showIndex_.insertIfAbsent(showKey(movieId, theaterId), [&]() -> Show* {
+        Show* show = shows_.at(showCount_);
+        if (!show) {
+            return nullptr;  // Slab full
+        }
+        // New shows start packed; rebalanceSeats pads the hot ones
+        SeatMap* seats = SeatMap::create(capacity, seatArena_, SeatArena::Tier::Packed);
+        if (!seats) {
+            return nullptr;
+        }
+        if (!layout || !layout->isValid() || layout->getCapacity() != seats->getCapacity()) {
+            layout = std::make_shared<SeatLayout>(SeatLayout::singleRow(seats->getCapacity()));
+        }
+        show->layout = std::move(layout);
+        show->movieId = movieId;
+        show->theaterId = theaterId;
+        show->handle = showCount_++;
+        show->contention.parent = &contentionStats_;
+        show->seats.store(seats, std::memory_order_release);
+        return show;
+    });
+}
+
+const BookingService::Show* BookingService::findShow(ShowHandle handle) const {
+    const Show* show = shows_.find(handle.index);
+    return (show && show->seats.load(std::memory_order_acquire)) ? show : nullptr;
+}
+
+ShowHandle BookingService::resolveShow(uint32_t movieId, uint32_t theaterId) {
+    // Check that movie and theater exist and are linked
+    uint32_t capacity = 0;
+    std::shared_ptr<const SeatLayout> layout;
+    {
+        auto guard = EpochReclaimer::global().pin();
+        
+        const MovieRecord* movie = findMovie(movieId);
+        const TheaterRecord* theater = findTheater(theaterId);
+        if (!movie || !theater) {
+            return ShowHandle{};
+        }
+        capacity = theater->theater->capacity;
+        layout = theater->theater->layout;
+        
+        const auto& linked = movie->theaterIds;
+        if (std::find(linked.begin(), linked.end(), theaterId) == linked.end()) {
+            return ShowHandle{};
+        }
     }
     
-    // Create new
-    auto mask = std::make_shared<SeatBitmask>();
-    seatMasks_[key] = mask;
-    return mask;
+    // Get or create the show (and its seat map)
+    Show* show = getOrCreateShow(movieId, theaterId, capacity, std::move(layout));
+    return show ? ShowHandle{show->handle} : ShowHandle{};
 }
 
 std::vector<std::string> BookingService::getAvailableSeats(
     uint32_t movieId, uint32_t theaterId) const {
     
-    auto mask = getSeatMask(movieId, theaterId);
-    if (!mask) {
+    const Show* show = findShow(movieId, theaterId);
+    if (!show) {
         // No bookings yet - all seats available
+        uint32_t capacity = getTheaterCapacity(theaterId);
         std::vector<std::string> all;
-        for (uint32_t i = 1; i <= SeatBitmask::MAX_SEATS; ++i) {
-            all.push_back("a" + std::to_string(i));
+        all.reserve(capacity);
+        for (uint32_t seat = 0; seat < capacity; ++seat) {
+            char label[SeatMap::MAX_SEAT_ID_LENGTH];
+            all.emplace_back(label, SeatMap::formatSeatId(seat, label));
         }
         return all;
     }
     
     // LOCK-FREE READ!
-    return mask->getAvailableSeats();
+    SeatLease seats(*show);
+    return seats->getAvailableSeats();
 }
 
 uint32_t BookingService::getAvailableCount(
     uint32_t movieId, uint32_t theaterId) const {
     
-    auto mask = getSeatMask(movieId, theaterId);
-    if (!mask) {
-        return SeatBitmask::MAX_SEATS;
+    const Show* show = findShow(movieId, theaterId);
+    if (!show) {
+        return getTheaterCapacity(theaterId);
     }
     
     // LOCK-FREE READ!
-    return mask->getAvailableCount();
+    SeatLease seats(*show);
+    return seats->getAvailableCount();
+}
+
+std::vector<std::string> BookingService::getAvailableSeats(ShowHandle handle) const {
+    const Show* show = findShow(handle);
+    return show ? SeatLease(*show)->getAvailableSeats() : std::vector<std::string>{};
+}
+
+size_t BookingService::formatAvailableSeats(ShowHandle handle, std::span<char> buffer) const {
+    const Show* show = findShow(handle);
+    return show ? SeatLease(*show)->formatAvailableSeats(buffer) : 0;
+}
+
+size_t BookingService::formatAvailableSeats(
+    uint32_t movieId, uint32_t theaterId, std::span<char> buffer) const {
+    
+    if (const Show* show = findShow(movieId, theaterId)) {
+        return SeatLease(*show)->formatAvailableSeats(buffer);
+    }
+    
+    // No bookings yet - all seats available
+    SeatLabelWriter writer(buffer);
+    uint32_t capacity = getTheaterCapacity(theaterId);
+    for (uint32_t seat = 0; seat < capacity; ++seat) {
+        if (!writer.append(seat)) {
+            break;
+        }
+    }
+    return writer.size();
+}
+
+uint32_t BookingService::getAvailableCount(ShowHandle handle) const {
+    const Show* show = findShow(handle);
+    return show ? SeatLease(*show)->getAvailableCount() : 0;
 }
 
-std::shared_ptr<Booking> BookingService::bookSeats(
+const Booking* BookingService::bookSeats(
     uint32_t movieId, uint32_t theaterId,
     const std::vector<std::string>& seatIds) {
     
-    // Validate seat IDs
     if (seatIds.empty()) {
         return nullptr;
     }
     
-    for (const auto& seatId : seatIds) {
-        if (!SeatBitmask::isValidSeatId(seatId)) {
+    ShowHandle show = resolveShow(movieId, theaterId);
+    if (!show.isValid()) {
+        return nullptr;
+    }
+    
+    return bookSeats(show, seatIds);
+}
+
+const Booking* BookingService::bookSeats(
+    uint32_t movieId, uint32_t theaterId,
+    std::span<const std::string_view> seatIds) {
+    
+    if (seatIds.empty()) {
+        return nullptr;
+    }
+    
+    ShowHandle show = resolveShow(movieId, theaterId);
+    if (!show.isValid()) {
+        return nullptr;
+    }
+    
+    return bookSeats(show, seatIds);
+}
+
+template <typename Seats>
+const Booking* BookingService::bookShowSeats(ShowHandle handle, Seats seats) {
+    const Show* show = findShow(handle);
+    if (!show || seats.empty() || refusesChanges()) {
+        return nullptr;
+    }
+    
+    const Booking* booking = nullptr;
+    {
+        // Validate seats and create the bitmask in one pass (one word per 64 seats)
+        SeatLease seatMap(*show);
+        std::array<uint64_t, SeatMap::MAX_WORDS> words{};
+        std::span<uint64_t> seatMask(words.data(), seatMap->getWordCount());
+        if (!seatMap->buildMask(seats, seatMask)) {
             return nullptr;
         }
+        
+        booking = commitBooking(*show, *seatMap, seatMask);
+    }
+    return awaitDurable(booking);
+}
+
+const Booking* BookingService::bookSeats(
+    ShowHandle handle, const std::vector<std::string>& seatIds) {
+    return bookShowSeats(handle, std::span<const std::string>(seatIds));
+}
+
+const Booking* BookingService::bookSeats(
+    ShowHandle handle, std::span<const std::string_view> seatIds) {
+    return bookShowSeats(handle, seatIds);
+}
+
+const Booking* BookingService::bookSeats(
+    ShowHandle handle, std::span<const uint16_t> seatIndexes) {
+    return bookShowSeats(handle, seatIndexes);
+}
+
+const Booking* BookingService::bookAdjacent(
+    uint32_t movieId, uint32_t theaterId, uint32_t count) {
+    
+    ShowHandle show = resolveShow(movieId, theaterId);
+    if (!show.isValid()) {
+        return nullptr;
     }
     
-    // Check that movie and theater exist and are linked
-    {
-        std::shared_lock<std::shared_mutex> lock(metadataMutex_);
+    return bookAdjacent(show, count);
+}
+
+const Booking* BookingService::bookAdjacent(ShowHandle handle, uint32_t count) {
+    const Show* show = findShow(handle);
+    if (!show || count == 0 || count > Booking::MAX_SEATS || refusesChanges()) {
+        return nullptr;
+    }
+    
+    return awaitDurable(claimAdjacent(*show, count));
+}
+
+const Booking* BookingService::claimAdjacent(const Show& show, uint32_t count) {
+    SeatLease seats(show);
+    uint32_t from = 0;
+    
+    // Every failed claim means another booking took part of the run, so
+    // the attempts are bounded like the CAS loop itself
+    for (uint32_t attempt = 0; attempt < config_.backoff.maxRetries; ++attempt) {
+        int start = seats->findFreeRun(count, from);
+        if (start < 0) {
+            return nullptr;  // No block of that size left
+        }
         
-        if (movies_.find(movieId) == movies_.end() || 
-            theaters_.find(theaterId) == theaters_.end()) {
-            return nullptr;
+        // The run covers at most two words
+        std::array<uint64_t, SeatMap::MAX_WORDS> words{};
+        std::span<uint64_t> seatMask(words.data(), seats->getWordCount());
+        for (uint32_t seat = start; seat < start + count; ++seat) {
+            seatMask[seat / 64] |= (uint64_t{1} << (seat % 64));
         }
         
-        auto it = movieToTheaters_.find(movieId);
-        if (it == movieToTheaters_.end()) {
-            return nullptr;
+        if (const Booking* booking = commitBooking(show, *seats, seatMask)) {
+            return booking;
         }
         
-        bool found = false;
-        for (uint32_t tid : it->second) {
-            if (tid == theaterId) {
-                found = true;
-                break;
-            }
+        // Lost the race: rescan from where this run started
+        from = static_cast<uint32_t>(start);
+    }
+    
+    return nullptr;
+}
+
+const Booking* BookingService::bookBestAvailable(
+    uint32_t movieId, uint32_t theaterId, uint32_t count) {
+    
+    ShowHandle show = resolveShow(movieId, theaterId);
+    if (!show.isValid()) {
+        return nullptr;
+    }
+    
+    return bookBestAvailable(show, count);
+}
+
+const Booking* BookingService::bookBestAvailable(ShowHandle handle, uint32_t count) {
+    const Show* show = findShow(handle);
+    if (!show || count == 0 || count > Booking::MAX_SEATS || refusesChanges()) {
+        return nullptr;
+    }
+    
+    return awaitDurable(claimBestAvailable(*show, count));
+}
+
+const Booking* BookingService::claimBestAvailable(const Show& show, uint32_t count) {
+    SeatLease seats(show);
+    SeatSelector selector(*show.layout);
+    
+    for (uint32_t attempt = 0; attempt < config_.backoff.maxRetries; ++attempt) {
+        std::array<SeatChoice, SeatSelector::MAX_CANDIDATES> candidates;
+        size_t candidateCount = selector.rank(*seats, count, candidates);
+        if (candidateCount == 0) {
+            return nullptr;  // No row has a block of that size left
         }
         
-        if (!found) {
-            return nullptr;
+        // Fall back down the ranking: a lost block rarely means the
+        // next one is gone too
+        for (size_t i = 0; i < candidateCount; ++i) {
+            uint32_t start = static_cast<uint32_t>(candidates[i].start);
+            std::array<uint64_t, SeatMap::MAX_WORDS> words{};
+            std::span<uint64_t> seatMask(words.data(), seats->getWordCount());
+            for (uint32_t seat = start; seat < start + count; ++seat) {
+                seatMask[seat / 64] |= (uint64_t{1} << (seat % 64));
+            }
+            
+            if (const Booking* booking = commitBooking(show, *seats, seatMask)) {
+                return booking;
+            }
         }
     }
     
-    // Create bitmask for requested seats
-    uint32_t seatMask = SeatBitmask::createMask(seatIds);
-    if (seatMask == 0) {
-        return nullptr;  // Invalid seat IDs
+    return nullptr;
+}
+
+const Booking* BookingService::commitBooking(
+    const Show& show, SeatMap& seats, std::span<const uint64_t> seatMask) {
+    
+    // The record keeps the seats inline
+    uint32_t seatCount = 0;
+    for (uint64_t word : seatMask) {
+        seatCount += std::popcount(word);
+    }
+    if (seatCount > Booking::MAX_SEATS) {
+        return nullptr;
     }
     
-    // Get or create seat mask for this combination
-    auto currentSeatBitmask = getOrCreateSeatMask(movieId, theaterId);
+    // Booking store full (ids are never reused)
+    if (nextBookingId_.load(std::memory_order_relaxed) >= decltype(bookings_)::CAPACITY) {
+        return nullptr;
+    }
     
-    // LOCK-FREE BOOKING! Uses atomic CAS
-    if (!currentSeatBitmask->tryBook(seatMask)) {
+    // LOCK-FREE BOOKING! Uses atomic CAS (or fetch_or)
+    if (!seats.tryBook(seatMask, claimOptionsFor(show))) {
         return nullptr;  // At least one seat was already occupied
     }
     
-    // Booking succeeded! Create the record
-    uint32_t bookingId = nextBookingId_.fetch_add(1, std::memory_order_relaxed);
-    auto booking = std::make_shared<Booking>(bookingId, movieId, theaterId, seatIds);
+    // The check above misses an id block that straddles the end of the
+    // store: give the seats back rather than leave them without a record
+    const Booking* booking = recordBooking(show, seatMask);
+    if (!booking) {
+        seats.release(seatMask);
+    }
+    return booking;
+}
+
+const Booking* BookingService::recordBooking(const Show& show, std::span<const uint64_t> seatMask) {
+    return writeRecord(allocateBookingId(), show, seatMask);
+}
+
+uint64_t BookingService::allocateBookingId() {
+    IdBlock* block = nullptr;
+    for (IdBlock& entry : idCache) {
+        if (entry.instance == instanceId_) {
+            block = &entry;
+            break;
+        }
+    }
+    if (!block) {
+        block = &idCache[idCacheVictim];
+        idCacheVictim = (idCacheVictim + 1) % ID_CACHE_WAYS;
+        *block = IdBlock{instanceId_, 0, 0, 0};
+    }
+    
+    // Refill from the global counter: small blocks first so a thread that
+    // books once does not strand thousands of ids, doubling up to one
+    // store segment
+    if (block->next == block->end) {
+        block->size = std::clamp<uint64_t>(block->size * 2, MIN_ID_BLOCK, MAX_ID_BLOCK);
+        block->next = nextBookingId_.fetch_add(block->size, std::memory_order_relaxed);
+        block->end = block->next + block->size;
+    }
+    return block->next++;
+}
+
+Booking* BookingService::writeRecord(uint64_t bookingId, const Show& show, std::span<const uint64_t> seatMask) {
+    // Booking succeeded! Write the record in place: the id owns its
+    // slot, so no other thread writes it
+    BookingSlot* slot = bookings_.at(bookingId);
+    if (!slot) {
+        return nullptr;
+    }
+    
+    Booking& booking = slot->record;
+    fillRecord(booking, bookingId, show, seatMask);
+    // Caller holds an epoch guard (a lease), so saveSnapshot sees the
+    // booking if its log position is past this record
+    slot->lsn = logRecord(LogRecord::Type::Book, booking, seatMask);
+    slot->status.store(BookingStatus::Active, std::memory_order_release);
+    
+    return &booking;
+}
+
+void BookingService::fillRecord(Booking& booking, uint64_t bookingId, const Show& show,
+                                std::span<const uint64_t> seatMask) {
+    booking.bookingId = bookingId;
+    booking.movieId = show.movieId;
+    booking.theaterId = show.theaterId;
+    for (size_t i = 0; i < seatMask.size(); ++i) {
+        for (uint64_t word = seatMask[i]; word != 0; word &= word - 1) {
+            booking.seats[booking.seatCount++] =
+                static_cast<uint16_t>(i * 64 + std::countr_zero(word));
+        }
+    }
+}
+
+// ===== Durability =====
+
+uint64_t BookingService::logRecord(LogRecord::Type type, const Booking& booking,
+                                   std::span<const uint64_t> seatMask) {
+    return log_ ? log_->append(toLogRecord(type, booking, seatMask)) : 0;
+}
+
+LogRecord BookingService::toLogRecord(LogRecord::Type type, const Booking& booking,
+                                      std::span<const uint64_t> seatMask) {
+    LogRecord record;
+    record.type = type;
+    record.bookingId = booking.bookingId;
+    record.movieId = booking.movieId;
+    record.theaterId = booking.theaterId;
+    for (size_t i = 0; i < seatMask.size(); ++i) {
+        for (uint64_t word = seatMask[i]; word != 0; word &= word - 1) {
+            record.seats[record.seatCount++] = static_cast<uint16_t>(i * 64 + std::countr_zero(word));
+        }
+    }
+    return record;
+}
+
+bool BookingService::refusesChanges() const {
+    return config_.durability == Durability::GroupSync && hasLogFailed();
+}
+
+bool BookingService::awaitDurable(uint64_t lsn) const {
+    if (config_.durability != Durability::GroupSync) {
+        return true;
+    }
+    return log_ && log_->waitDurable(lsn);
+}
+
+const Booking* BookingService::awaitDurable(const Booking* booking) {
+    if (!booking) {
+        return nullptr;
+    }
+    BookingSlot* slot = bookings_.find(booking->bookingId);
+    if (awaitDurable(slot->lsn)) {
+        return booking;
+    }
+    
+    // A restart would not bring it back: cancel it rather than report it
+    revokeBooking(*slot);
+    return nullptr;
+}
+
+void BookingService::revokeBooking(BookingSlot& slot) {
+    uint64_t lsn = 0;
+    if (cancelSlot(slot, lsn)) {
+        releaseSeats(slot.record);
+    }
+}
+
+// ===== Batch Booking =====
+
+std::vector<BookingResult> BookingService::bookBatch(std::span<const BookingRequest> requests) {
+    using Status = BookingResult::Status;
+    std::vector<BookingResult> results(requests.size());
+    if (refusesChanges()) {
+        for (BookingResult& result : results) {
+            result.status = Status::NotDurable;
+        }
+        return results;
+    }
+    
+    // Group items by show, keeping request order inside each show
+    std::vector<std::pair<uint64_t, uint32_t>> keyed(requests.size());
+    for (uint32_t i = 0; i < keyed.size(); ++i) {
+        keyed[i] = {showKey(requests[i].movieId, requests[i].theaterId), i};
+    }
+    std::sort(keyed.begin(), keyed.end());
+    
+    struct Group {
+        size_t begin;
+        size_t end;
+        const Show* show;
+    };
+    std::vector<Group> groups;
     
-    // Save booking
+    // Resolve each distinct show once, all under one epoch guard
     {
-        std::unique_lock<std::shared_mutex> lock(bookingsMutex_);
-        bookings_[bookingId] = booking;
+        auto guard = EpochReclaimer::global().pin();
+        for (size_t i = 0; i < keyed.size();) {
+            uint64_t key = keyed[i].first;
+            size_t end = i + 1;
+            while (end < keyed.size() && keyed[end].first == key) {
+                ++end;
+            }
+            
+            // Existing shows were validated when created (links are never removed)
+            const Show* show = showIndex_.find(key);
+            if (!show) {
+                const BookingRequest& first = requests[keyed[i].second];
+                show = findShow(resolveShow(first.movieId, first.theaterId));
+            }
+            groups.push_back({i, end, show});
+            i = end;
+        }
     }
     
-    return booking;
+    // Parse every item's seats into its own mask (one pass per item)
+    std::vector<uint64_t> masks;
+    std::vector<size_t> maskOffset(requests.size(), 0);
+    std::vector<const Show*> itemShow(requests.size(), nullptr);
+    std::vector<uint32_t> maskWords(requests.size(), 0);
+    masks.reserve(requests.size());
+    for (const Group& group : groups) {
+        if (!group.show) {
+            continue;  // Results stay InvalidRequest
+        }
+        SeatLease seats(*group.show);
+        uint32_t wordCount = seats->getWordCount();
+        for (size_t k = group.begin; k < group.end; ++k) {
+            uint32_t item = keyed[k].second;
+            itemShow[item] = group.show;
+            maskWords[item] = wordCount;
+            maskOffset[item] = masks.size();
+            masks.resize(masks.size() + wordCount, 0);
+            std::span<uint64_t> mask(masks.data() + maskOffset[item], wordCount);
+            
+            const auto& seatIds = requests[item].seatIds;
+            uint32_t seatCount = 0;
+            if (!seatIds.empty() && seats->buildMask(std::span<const std::string>(seatIds), mask)) {
+                for (uint64_t word : mask) {
+                    seatCount += std::popcount(word);
+                }
+            }
+            if (seatCount == 0 || seatCount > Booking::MAX_SEATS) {
+                std::fill(mask.begin(), mask.end(), 0);  // Invalid: skipped below
+            } else {
+                results[item].status = Status::SeatsTaken;  // Until claimed
+            }
+        }
+    }
+    
+    // Claim seats: one combined attempt per show for the items that do
+    // not overlap each other, per-item attempts otherwise
+    std::vector<uint32_t> claimed;
+    std::vector<uint32_t> combinedItems;
+    std::vector<uint32_t> singleItems;
+    for (const Group& group : groups) {
+        if (!group.show) {
+            continue;
+        }
+        SeatLease lease(*group.show);
+        SeatMap& seats = *lease;
+        ClaimOptions options = claimOptionsFor(*group.show);
+        uint32_t wordCount = seats.getWordCount();
+        auto maskOf = [&](uint32_t item) {
+            return std::span<const uint64_t>(masks.data() + maskOffset[item], wordCount);
+        };
+        
+        std::array<uint64_t, SeatMap::MAX_WORDS> combined{};
+        combinedItems.clear();
+        singleItems.clear();
+        for (size_t k = group.begin; k < group.end; ++k) {
+            uint32_t item = keyed[k].second;
+            if (results[item].status != Status::SeatsTaken) {
+                continue;
+            }
+            auto mask = maskOf(item);
+            bool overlaps = false;
+            for (uint32_t w = 0; w < wordCount; ++w) {
+                overlaps = overlaps || (combined[w] & mask[w]) != 0;
+            }
+            if (overlaps) {
+                singleItems.push_back(item);  // Loses to an earlier item unless that one fails
+                continue;
+            }
+            for (uint32_t w = 0; w < wordCount; ++w) {
+                combined[w] |= mask[w];
+            }
+            combinedItems.push_back(item);
+        }
+        
+        if (combinedItems.empty()) {
+            continue;
+        }
+        if (seats.tryBook(std::span<const uint64_t>(combined.data(), wordCount), options)) {
+            claimed.insert(claimed.end(), combinedItems.begin(), combinedItems.end());
+        } else {
+            // Someone outside the batch holds a seat: find out which items
+            // still fit, in request order
+            singleItems.insert(singleItems.end(), combinedItems.begin(), combinedItems.end());
+            std::sort(singleItems.begin(), singleItems.end());
+        }
+        for (uint32_t item : singleItems) {
+            if (seats.tryBook(maskOf(item), options)) {
+                claimed.push_back(item);
+            }
+        }
+    }
+    
+    // One id range for the whole batch, then the records in place, in
+    // one epoch guard (writeRecord needs one; see saveSnapshot)
+    uint64_t firstId = claimed.empty() ? 0 : nextBookingId_.fetch_add(claimed.size(), std::memory_order_relaxed);
+    const Booking* lastBooked = nullptr;
+    std::vector<uint32_t> unstored;
+    {
+        auto guard = EpochReclaimer::global().pin();
+        for (size_t k = 0; k < claimed.size(); ++k) {
+            uint32_t item = claimed[k];
+            const Show* show = itemShow[item];
+            auto mask = std::span<const uint64_t>(masks.data() + maskOffset[item], maskWords[item]);
+            
+            if (Booking* booking = writeRecord(firstId + k, *show, mask)) {
+                results[item] = {Status::Booked, booking};
+                lastBooked = booking;
+            } else {
+                unstored.push_back(item);
+            }
+        }
+    }
+    for (uint32_t item : unstored) {
+        SeatLease(*itemShow[item])->release(
+            std::span<const uint64_t>(masks.data() + maskOffset[item], maskWords[item]));
+        results[item].status = Status::StoreFull;
+    }
+    
+    // This thread appended the records in order: the last one covers all
+    if (lastBooked && !awaitDurable(bookings_.find(lastBooked->bookingId)->lsn)) {
+        for (BookingResult& result : results) {
+            if (result.ok()) {
+                revokeBooking(*bookings_.find(result.booking->bookingId));
+                result = {Status::NotDurable, nullptr};
+            }
+        }
+    }
+    return results;
+}
+
+// ===== Exchange =====
+
+const Booking* BookingService::exchange(
+    uint64_t bookingId, uint32_t newMovieId, uint32_t newTheaterId,
+    const std::vector<std::string>& newSeatIds) {
+    
+    if (newSeatIds.empty()) {
+        return nullptr;
+    }
+    
+    ShowHandle show = resolveShow(newMovieId, newTheaterId);
+    if (!show.isValid()) {
+        return nullptr;
+    }
+    
+    return exchangeShowSeats(bookingId, show, std::span<const std::string>(newSeatIds));
 }
 
-std::shared_ptr<Booking> BookingService::getBooking(uint64_t bookingId) const {
-    std::shared_lock<std::shared_mutex> lock(bookingsMutex_);
-    auto it = bookings_.find(bookingId);
-    return (it != bookings_.end()) ? it->second : nullptr;
+const Booking* BookingService::exchange(
+    uint64_t bookingId, ShowHandle newShow, std::span<const uint16_t> newSeatIndexes) {
+    return exchangeShowSeats(bookingId, newShow, newSeatIndexes);
 }
 
-double BookingService::getOccupancyPercentage(
-    uint32_t movieId, uint32_t theaterId) const {
+template <typename Seats>
+const Booking* BookingService::exchangeShowSeats(uint64_t bookingId, ShowHandle handle, Seats seats) {
+    const Show* target = findShow(handle);
+    BookingSlot* slot = bookings_.find(bookingId);
+    if (!target || !slot || seats.empty() || refusesChanges()) {
+        return nullptr;
+    }
     
-    uint32_t available = getAvailableCount(movieId, theaterId);
-    uint32_t occupied = SeatBitmask::MAX_SEATS - available;
+    std::array<uint64_t, SeatMap::MAX_WORDS> newWords{};
+    std::span<uint64_t> newMask;
+    {
+        SeatLease seatMap(*target);
+        newMask = std::span<uint64_t>(newWords.data(), seatMap->getWordCount());
+        if (!seatMap->buildMask(seats, newMask)) {
+            return nullptr;
+        }
+    }
+    
+    uint32_t seatCount = 0;
+    for (uint64_t word : newMask) {
+        seatCount += std::popcount(word);
+    }
+    if (seatCount > Booking::MAX_SEATS) {
+        return nullptr;
+    }
     
-    return (static_cast<double>(occupied) / SeatBitmask::MAX_SEATS) * 100.0;
+    // Lock the old booking: cancels and other exchanges fail until we
+    // commit or roll back
+    BookingStatus expected = BookingStatus::Active;
+    if (!slot->status.compare_exchange_strong(expected, BookingStatus::Exchanging,
+                                              std::memory_order_acq_rel)) {
+        return nullptr;
+    }
+    
+    // The new id and its slot first: once seats have moved nothing may
+    // fail, or they could not always be moved back (the old seats may
+    // be booked by someone else meanwhile). A lost claim leaves an
+    // unused id, like an idle thread's id block.
+    uint64_t newId = allocateBookingId();
+    BookingSlot* newSlot = bookings_.at(newId);
+    if (!newSlot) {
+        slot->status.store(BookingStatus::Active, std::memory_order_release);
+        return nullptr;
+    }
+    
+    const Booking& old = slot->record;
+    const Show* source = showIndex_.find(showKey(old.movieId, old.theaterId));
+    std::array<uint64_t, SeatMap::MAX_WORDS> oldWords{};
+    std::span<uint64_t> oldMask;
+    if (source) {
+        oldMask = std::span<uint64_t>(oldWords.data(), SeatLease(*source)->getWordCount());
+        for (uint16_t seat : old.seatIndexes()) {
+            oldMask[seat / 64] |= (uint64_t{1} << (seat % 64));
+        }
+    }
+    
+    // Seats to claim and to free: within one show, kept seats are neither
+    std::array<uint64_t, SeatMap::MAX_WORDS> claimWords{};
+    std::array<uint64_t, SeatMap::MAX_WORDS> freedWords{};
+    std::span<uint64_t> claimMask(claimWords.data(), newMask.size());
+    std::span<uint64_t> freedMask(freedWords.data(), oldMask.size());
+    bool anyClaim = false;
+    bool anyFreed = false;
+    for (size_t w = 0; w < claimMask.size(); ++w) {
+        claimMask[w] = source == target ? newMask[w] & ~oldMask[w] : newMask[w];
+        anyClaim = anyClaim || claimMask[w] != 0;
+    }
+    for (size_t w = 0; w < freedMask.size(); ++w) {
+        freedMask[w] = source == target ? oldMask[w] & ~newMask[w] : oldMask[w];
+        anyFreed = anyFreed || freedMask[w] != 0;
+    }
+    
+    // Same show without a log: move in place (tryMove). Otherwise claim
+    // the new seats first and free the old ones after the Cancel record,
+    // so nobody can book them before the log says they are free. Both
+    // seat sets are taken in between: deliberately, as one CAS across
+    // shows could not be ordered with the log records.
+    bool inPlace = source == target && !log_;
+    {
+        SeatLease seatMap(*target);
+        ClaimOptions options = claimOptionsFor(*target);
+        
+        bool claimed = inPlace ? seatMap->tryMove(oldMask, newMask, options)
+                               : !anyClaim || seatMap->tryBook(claimMask, options);
+        if (!claimed) {
+            slot->status.store(BookingStatus::Active, std::memory_order_release);
+            return nullptr;
+        }
+    }
+    
+    // Commit: the replacement and the cancel are logged as one Exchange +
+    // Cancel pair (replayed both or neither) and published in the same
+    // guard, so a snapshot sees both changes or neither (see saveSnapshot)
+    Booking& booking = newSlot->record;
+    uint64_t lsn = 0;
+    {
+        auto guard = EpochReclaimer::global().pin();
+        fillRecord(booking, newId, *target, newMask);
+        if (log_) {
+            std::array<LogRecord, 2> records = {toLogRecord(LogRecord::Type::Exchange, booking, newMask),
+                                                toLogRecord(LogRecord::Type::Cancel, old, freedMask)};
+            lsn = log_->append(records);
+            newSlot->lsn = lsn - 1;
+        }
+        // Old one first: a reader may see neither for an instant, never both
+        slot->status.store(BookingStatus::Cancelled, std::memory_order_release);
+        newSlot->status.store(BookingStatus::Active, std::memory_order_release);
+    }
+    
+    // GroupSync frees the old seats only once the pair is on disk. If it
+    // never gets there, undo the commit: nobody can have booked the old
+    // seats, so only the claimed ones go back (never in place: that
+    // needs no log)
+    if (!awaitDurable(lsn)) {
+        newSlot->status.store(BookingStatus::Cancelled, std::memory_order_release);
+        slot->status.store(BookingStatus::Active, std::memory_order_release);
+        if (anyClaim) {
+            SeatLease(*target)->release(claimMask);
+        }
+        return nullptr;
+    }
+    if (source && !inPlace && anyFreed) {
+        SeatLease(*source)->release(freedMask);
+    }
+    return &booking;
+}
+
+// ===== Seat Holds =====
+
+HoldId BookingService::holdSeats(
+    uint32_t movieId, uint32_t theaterId,
+    const std::vector<std::string>& seatIds,
+    std::chrono::milliseconds ttl) {
+    
+    if (seatIds.empty()) {
+        return HoldId{};
+    }
+    
+    ShowHandle show = resolveShow(movieId, theaterId);
+    if (!show.isValid()) {
+        return HoldId{};
+    }
+    
+    return holdSeats(show, seatIds, ttl);
+}
+
+HoldId BookingService::holdSeats(
+    ShowHandle handle, const std::vector<std::string>& seatIds,
+    std::chrono::milliseconds ttl) {
+    return holdShowSeats(handle, std::span<const std::string>(seatIds), ttl);
+}
+
+HoldId BookingService::holdSeats(
+    ShowHandle handle, std::span<const uint16_t> seatIndexes,
+    std::chrono::milliseconds ttl) {
+    return holdShowSeats(handle, seatIndexes, ttl);
+}
+
+template <typename Seats>
+HoldId BookingService::holdShowSeats(ShowHandle handle, Seats seats, std::chrono::milliseconds ttl) {
+    const Show* show = findShow(handle);
+    if (!show || seats.empty()) {
+        return HoldId{};
+    }
+    
+    SeatLease seatMap(*show);
+    std::array<uint64_t, SeatMap::MAX_WORDS> words{};
+    std::span<uint64_t> seatMask(words.data(), seatMap->getWordCount());
+    if (!seatMap->buildMask(seats, seatMask)) {
+        return HoldId{};
+    }
+    
+    // The hold keeps the seats inline, like a booking
+    uint32_t seatCount = 0;
+    for (uint64_t word : seatMask) {
+        seatCount += std::popcount(word);
+    }
+    if (seatCount > Booking::MAX_SEATS ||
+        nextHoldId_.load(std::memory_order_relaxed) >= decltype(holds_)::CAPACITY) {
+        return HoldId{};
+    }
+    
+    if (!seatMap->tryHold(seatMask, claimOptionsFor(*show))) {
+        return HoldId{};  // At least one seat was already taken
+    }
+    
+    uint64_t holdId = nextHoldId_.fetch_add(1, std::memory_order_relaxed);
+    HoldSlot* slot = holds_.at(holdId);
+    if (!slot) {
+        seatMap->releaseHeld(seatMask);
+        return HoldId{};
+    }
+    
+    Booking& held = slot->seats;
+    held.movieId = show->movieId;
+    held.theaterId = show->theaterId;
+    for (size_t i = 0; i < seatMask.size(); ++i) {
+        for (uint64_t word = seatMask[i]; word != 0; word &= word - 1) {
+            held.seats[held.seatCount++] = static_cast<uint16_t>(i * 64 + std::countr_zero(word));
+        }
+    }
+    slot->show = handle.index;
+    slot->expiresAt = std::chrono::steady_clock::now() + ttl;
+    slot->state.store(HoldState::Active, std::memory_order_release);
+    
+    // Hand it to the expiry engine (lock-free push)
+    uint64_t head = pendingHolds_.load(std::memory_order_relaxed);
+    do {
+        slot->nextPending = head;
+    } while (!pendingHolds_.compare_exchange_weak(head, holdId,
+                                                  std::memory_order_release,
+                                                  std::memory_order_relaxed));
+    
+    return HoldId{holdId};
+}
+
+const BookingService::Show* BookingService::findHoldShow(
+    const HoldSlot& hold, std::span<uint64_t> seatMask) const {
+    
+    const Show* show = findShow(ShowHandle{hold.show});
+    if (!show) {
+        return nullptr;
+    }
+    for (uint16_t seat : hold.seats.seatIndexes()) {
+        seatMask[seat / 64] |= (uint64_t{1} << (seat % 64));
+    }
+    return show;
+}
+
+const Booking* BookingService::confirmHold(HoldId hold) {
+    HoldSlot* slot = holds_.find(hold.value);
+    if (!slot || slot->state.load(std::memory_order_acquire) != HoldState::Active || refusesChanges()) {
+        return nullptr;
+    }
+    
+    std::array<uint64_t, SeatMap::MAX_WORDS> words{};
+    const Show* show = findHoldShow(*slot, words);
+    if (!show) {
+        return nullptr;
+    }
+    
+    const Booking* booking = nullptr;
+    {
+        SeatLease seatMap(*show);
+        std::span<const uint64_t> seatMask(words.data(), seatMap->getWordCount());
+        
+        HoldState expected = HoldState::Active;
+        if (std::chrono::steady_clock::now() >= slot->expiresAt) {
+            // Past its TTL but not swept yet: expire it here
+            if (slot->state.compare_exchange_strong(expected, HoldState::Expired,
+                                                    std::memory_order_acq_rel)) {
+                seatMap->releaseHeld(seatMask);
+            }
+            return nullptr;
+        }
+        
+        // Booking store full (ids are never reused): keep the hold
+        if (nextBookingId_.load(std::memory_order_relaxed) >= decltype(bookings_)::CAPACITY) {
+            return nullptr;
+        }
+        
+        if (!slot->state.compare_exchange_strong(expected, HoldState::Confirmed,
+                                                 std::memory_order_acq_rel)) {
+            return nullptr;  // Released or expired concurrently
+        }
+        
+        seatMap->confirmHeld(seatMask);
+        booking = recordBooking(*show, seatMask);
+        if (!booking) {
+            seatMap->release(seatMask);  // Store full after all (see commitBooking)
+        }
+    }
+    return awaitDurable(booking);
+}
+
+bool BookingService::releaseHold(HoldId hold) {
+    HoldSlot* slot = holds_.find(hold.value);
+    if (!slot) {
+        return false;
+    }
+    
+    HoldState expected = HoldState::Active;
+    if (!slot->state.compare_exchange_strong(expected, HoldState::Released,
+                                             std::memory_order_acq_rel)) {
+        return false;
+    }
+    
+    std::array<uint64_t, SeatMap::MAX_WORDS> words{};
+    if (const Show* show = findHoldShow(*slot, words)) {
+        SeatLease seatMap(*show);
+        seatMap->releaseHeld(std::span<const uint64_t>(words.data(), seatMap->getWordCount()));
+    }
+    return true;
+}
+
+uint64_t BookingService::toHoldTick(std::chrono::steady_clock::time_point time, bool roundUp) const {
+    if (time <= holdEpoch_) {
+        return 0;
+    }
+    auto tick = std::max<std::chrono::nanoseconds>(config_.holdTick, std::chrono::milliseconds(1));
+    auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(time - holdEpoch_);
+    uint64_t ticks = static_cast<uint64_t>(elapsed / tick);
+    return (roundUp && elapsed % tick != std::chrono::nanoseconds::zero()) ? ticks + 1 : ticks;
+}
+
+size_t BookingService::expireHolds(std::chrono::steady_clock::time_point now) {
+    std::lock_guard<std::mutex> lock(holdWheelMutex_);
+    
+    // Claims a due hold if it is still active
+    expiredHolds_.clear();
+    auto expire = [this](uint64_t id) {
+        HoldSlot* slot = holds_.find(id);
+        HoldState expected = HoldState::Active;
+        if (slot->state.compare_exchange_strong(expected, HoldState::Expired,
+                                                std::memory_order_acq_rel)) {
+            expiredHolds_.emplace_back(slot->show, slot);
+        }
+    };
+    
+    // Schedule holds created since the last call; deadlines round up,
+    // so a hold never expires before its TTL. Ones the wheel has already
+    // passed are due now.
+    uint64_t holdId = pendingHolds_.exchange(0, std::memory_order_acquire);
+    while (holdId != 0) {
+        const HoldSlot* slot = holds_.find(holdId);
+        uint64_t deadline = toHoldTick(slot->expiresAt, true);
+        if (deadline <= holdWheel_.getCurrentTick()) {
+            expire(holdId);
+        } else {
+            holdWheel_.schedule(holdId, deadline);
+        }
+        holdId = slot->nextPending;
+    }
+    
+    holdWheel_.advance(toHoldTick(now, false), expire);
+    
+    // Free their seats in batches: one mask and one releaseHeld per show
+    std::sort(expiredHolds_.begin(), expiredHolds_.end(),
+              [](const auto& a, const auto& b) { return a.first < b.first; });
+    
+    for (size_t i = 0; i < expiredHolds_.size();) {
+        std::array<uint64_t, SeatMap::MAX_WORDS> words{};
+        const Show* show = nullptr;
+        size_t next = i;
+        for (; next < expiredHolds_.size() && expiredHolds_[next].first == expiredHolds_[i].first; ++next) {
+            show = findHoldShow(*expiredHolds_[next].second, words);
+        }
+        if (show) {
+            SeatLease seatMap(*show);
+            seatMap->releaseHeld(std::span<const uint64_t>(words.data(), seatMap->getWordCount()));
+        }
+        i = next;
+    }
+    
+    return expiredHolds_.size();
+}
+
+uint32_t BookingService::getHeldCount(ShowHandle handle) const {
+    const Show* show = findShow(handle);
+    return show ? SeatLease(*show)->getHeldCount() : 0;
+}
+
+const Booking* BookingService::getBooking(uint64_t bookingId) const {
+    const BookingSlot* slot = bookings_.find(bookingId);
+    if (!slot) {
+        return nullptr;
+    }
+    BookingStatus status = slot->status.load(std::memory_order_acquire);
+    return (status == BookingStatus::Active || status == BookingStatus::Exchanging) ? &slot->record : nullptr;
+}
+
+BookingStatus BookingService::getBookingStatus(uint64_t bookingId) const {
+    const BookingSlot* slot = bookings_.find(bookingId);
+    return slot ? slot->status.load(std::memory_order_acquire) : BookingStatus::Unknown;
+}
+
+bool BookingService::cancelBooking(uint64_t bookingId) {
+    BookingSlot* slot = bookings_.find(bookingId);
+    if (!slot || refusesChanges()) {
+        return false;
+    }
+    
+    uint64_t lsn = 0;
+    if (!cancelSlot(*slot, lsn)) {
+        return false;
+    }
+    
+    // GroupSync frees the seats only once the Cancel is on disk: if it
+    // never gets there, nobody has booked them and the booking is
+    // simply active again
+    if (!awaitDurable(lsn)) {
+        slot->status.store(BookingStatus::Active, std::memory_order_release);
+        return false;
+    }
+    releaseSeats(slot->record);
+    return true;
+}
+
+bool BookingService::cancelSlot(BookingSlot& slot, uint64_t& lsn) {
+    // Claim the cancellation first: a second cancel must never clear
+    // bits that a new booking has taken since. Logged in the same guard
+    // (see saveSnapshot) and before the seats are free, so any later
+    // booking of them comes after this record.
+    auto guard = EpochReclaimer::global().pin();
+    BookingStatus expected = BookingStatus::Active;
+    if (!slot.status.compare_exchange_strong(expected, BookingStatus::Cancelled,
+                                             std::memory_order_acq_rel)) {
+        return false;
+    }
+    std::array<uint64_t, SeatMap::MAX_WORDS> words{};
+    for (uint16_t seat : slot.record.seatIndexes()) {
+        words[seat / 64] |= (uint64_t{1} << (seat % 64));
+    }
+    lsn = logRecord(LogRecord::Type::Cancel, slot.record, words);
+    return true;
+}
+
+void BookingService::releaseSeats(const Booking& booking) {
+    const Show* show = showIndex_.find(showKey(booking.movieId, booking.theaterId));
+    if (!show) {
+        return;
+    }
+    std::array<uint64_t, SeatMap::MAX_WORDS> words{};
+    for (uint16_t seat : booking.seatIndexes()) {
+        words[seat / 64] |= (uint64_t{1} << (seat % 64));
+    }
+    SeatLease seatMap(*show);
+    seatMap->release(std::span<const uint64_t>(words.data(), seatMap->getWordCount()));
+}
+
+// ===== Seat Arena Tiers =====
+
+size_t BookingService::rebalanceSeats() {
+    std::lock_guard<std::mutex> lock(rebalanceMutex_);
+    
+    size_t moved = 0;
+    for (uint32_t i = 0;; ++i) {
+        Show* show = shows_.find(i);
+        if (!show || !show->seats.load(std::memory_order_acquire)) {
+            break;  // Shows are dense: the first empty slot ends the scan
+        }
+        
+        // CAS retries since the last call decide the tier
+        uint64_t retries = show->contention.retries.load(std::memory_order_relaxed);
+        uint64_t recent = retries - show->retriesSeen;
+        show->retriesSeen = retries;
+        
+        SeatArena::Tier tier = show->tier.load(std::memory_order_relaxed);
+        SeatArena::Tier wanted = tier;
+        if (tier == SeatArena::Tier::Packed) {
+            if (recent >= config_.promoteRetries) {
+                wanted = SeatArena::Tier::Padded;
+            }
+        } else {
+            show->quietRounds = recent == 0 ? show->quietRounds + 1 : 0;
+            if (show->quietRounds >= config_.demoteRounds) {
+                wanted = SeatArena::Tier::Packed;
+            }
+        }
+        
+        if (wanted != tier && moveSeats(*show, wanted)) {
+            ++moved;
+        }
+    }
+    return moved;
+}
+
+bool BookingService::moveSeats(Show& show, SeatArena::Tier tier) {
+    // Only rebalanceSeats replaces the map, so these are current
+    SeatArena::Tier from = show.tier.load(std::memory_order_relaxed);
+    SeatMap* current = show.seats.load(std::memory_order_relaxed);
+    
+    // Turn new operations away, then wait for the ones in flight. A
+    // thread waiting on this move from inside another guard would never
+    // drain, so give up after moveTimeout rather than deadlock.
+    show.moving.store(true, std::memory_order_seq_cst);
+    if (!EpochReclaimer::global().synchronize(config_.moveTimeout)) {
+        show.moving.store(false, std::memory_order_release);
+        return false;
+    }
+    
+    SeatMap* copy = SeatMap::relocate(*current, seatArena_, tier);
+    if (copy) {
+        show.seats.store(copy, std::memory_order_release);
+        show.tier.store(tier, std::memory_order_relaxed);
+        show.quietRounds = 0;
+    }
+    show.moving.store(false, std::memory_order_release);
+    if (!copy) {
+        return false;
+    }
+    
+    // Readers still holding the old map entered before the swap: one
+    // grace period and its block can be reused
+    EpochReclaimer::global().synchronize();
+    SeatMap::destroy(current, seatArena_, from);
+    return true;
+}
+
+bool BookingService::isSeatMapPadded(ShowHandle handle) const {
+    const Show* show = findShow(handle);
+    return show && show->tier.load(std::memory_order_relaxed) == SeatArena::Tier::Padded;
+}
+
+size_t BookingService::getSeatArenaBytes() const {
+    return seatArena_.getReservedBytes();
+}
+
+std::vector<std::string> Booking::seatIds() const {
+    std::vector<std::string> ids;
+    ids.reserve(seatCount);
+    for (uint16_t seat : seatIndexes()) {
+        ids.push_back("a" + std::to_string(seat + 1));
+    }
+    return ids;
+}
+
+// ===== Snapshots =====
+
+SnapshotInfo BookingService::saveSnapshot(const std::string& path) {
+    using Section = SnapshotSectionId;
+    SnapshotInfo info;
+    
+    // Log position first, then wait out every guard entered before it: a
+    // record below walLsn was appended in a guard that also published its
+    // status change, so the scans below see all of them
+    info.walLsn = log_ ? log_->getNextLsn() : 0;
+    EpochReclaimer::global().synchronize();
+    const uint64_t nextBookingId = nextBookingId_.load(std::memory_order_acquire);
+    
+    SnapshotWriter writer(path);
+    std::vector<char> strings;
+    
+    // Catalog: the current records, stable under the writer mutex
+    {
+        std::lock_guard<std::mutex> lock(catalogWriterMutex_);
+        
+        std::vector<SnapshotMovie> movies;
+        std::vector<uint32_t> links;
+        for (const Movie* movie : *movieList_.load(std::memory_order_acquire)) {
+            const MovieRecord* record = findMovie(movie->id);
+            movies.push_back({.id = movie->id,
+                              .titleLength = static_cast<uint32_t>(movie->title.size()),
+                              .titleOffset = strings.size(),
+                              .linkOffset = links.size(),
+                              .linkCount = static_cast<uint32_t>(record->theaterIds.size())});
+            strings.insert(strings.end(), movie->title.begin(), movie->title.end());
+            links.insert(links.end(), record->theaterIds.begin(), record->theaterIds.end());
+        }
+        
+        std::vector<SnapshotTheater> theaters;
+        std::vector<SeatLayout::Row> rows;
+        std::vector<int32_t> scores;
+        for (const auto& entry : theaterEntries_) {
+            const Theater* theater = entry.current.load(std::memory_order_acquire)->theater;
+            SnapshotTheater saved{.id = theater->id,
+                                  .capacity = theater->capacity,
+                                  .nameOffset = strings.size(),
+                                  .nameLength = static_cast<uint32_t>(theater->name.size()),
+                                  .layoutRowOffset = rows.size(),
+                                  .layoutScoreOffset = scores.size()};
+            strings.insert(strings.end(), theater->name.begin(), theater->name.end());
+            if (theater->layout && !theater->layout->getRows().empty()) {
+                const SeatLayout& layout = *theater->layout;
+                saved.layoutRowCount = static_cast<uint32_t>(layout.getRows().size());
+                saved.layoutScoreCount = layout.getCapacity();
+                rows.insert(rows.end(), layout.getRows().begin(), layout.getRows().end());
+                for (uint32_t seat = 0; seat < layout.getCapacity(); ++seat) {
+                    scores.push_back(layout.getSeatScore(seat));
+                }
+            }
+            theaters.push_back(saved);
+        }
+        
+        writer.writeSection(Section::Movies, std::span<const SnapshotMovie>(movies));
+        writer.writeSection(Section::TheaterLinks, std::span<const uint32_t>(links));
+        writer.writeSection(Section::Theaters, std::span<const SnapshotTheater>(theaters));
+        writer.writeSection(Section::LayoutRows, std::span<const SeatLayout::Row>(rows));
+        writer.writeSection(Section::LayoutScores, std::span<const int32_t>(scores));
+        writer.writeSection(Section::Strings, std::span<const char>(strings));
+    }
+    
+    // Shows in handle order. One created from here on is left out, and so
+    // are its bookings: their records are all past walLsn.
+    std::vector<SnapshotShow> shows;
+    uint64_t wordCount = 0;
+    for (uint32_t i = 0;; ++i) {
+        const Show* show = findShow(ShowHandle{i});
+        if (!show) {
+            break;
+        }
+        SeatLease seats(*show);
+        shows.push_back({show->movieId, show->theaterId, seats->getCapacity(), seats->getWordCount(), wordCount});
+        wordCount += seats->getWordCount();
+    }
+    writer.writeSection(Section::Shows, std::span<const SnapshotShow>(shows));
+    
+    // Bookings, streamed. The seat words are rebuilt from the live ones
+    // rather than copied from the seat maps, which also carry holds.
+    std::vector<uint64_t> words(wordCount, 0);
+    writer.beginSection(Section::Bookings);
+    for (uint64_t id = 1; id < nextBookingId; ++id) {
+        const BookingSlot* slot = bookings_.find(id);
+        if (!slot) {
+            id = (id / BOOKINGS_PER_SEGMENT + 1) * BOOKINGS_PER_SEGMENT - 1;  // Untouched segment
+            continue;
+        }
+        BookingStatus status = slot->status.load(std::memory_order_acquire);
+        if (status == BookingStatus::Unknown) {
+            continue;  // Unused id, or published after walLsn
+        }
+        const Booking& record = slot->record;
+        const Show* show = showIndex_.find(showKey(record.movieId, record.theaterId));
+        if (!show || show->handle >= shows.size()) {
+            continue;
+        }
+        
+        // An exchange in flight either rolls back or logs its Cancel
+        if (status != BookingStatus::Cancelled) {
+            status = BookingStatus::Active;
+            uint64_t* showWords = words.data() + shows[show->handle].wordOffset;
+            for (uint16_t seat : record.seatIndexes()) {
+                showWords[seat / 64] |= (uint64_t{1} << (seat % 64));
+            }
+        }
+        SnapshotBooking saved{record, static_cast<uint64_t>(status)};
+        writer.append(&saved, sizeof(saved));
+        ++info.bookingCount;
+    }
+    writer.endSection(info.bookingCount);
+    writer.writeSection(Section::SeatWords, std::span<const uint64_t>(words));
+    
+    // Only publish a position the log can replay from: records staged
+    // below walLsn may still be waiting for their group commit
+    if (log_ && !log_->waitDurable(info.walLsn - 1)) {
+        return info;
+    }
+    if (!writer.finish(info.walLsn, nextBookingId)) {
+        return info;
+    }
+    info.status = SnapshotInfo::Status::Ok;
+    info.showCount = shows.size();
+    info.bytes = writer.getBytesWritten();
+    return info;
+}
+
+SnapshotInfo BookingService::loadSnapshot(const std::string& path) {
+    using Section = SnapshotSectionId;
+    using Status = SnapshotInfo::Status;
+    SnapshotInfo info;
+    
+    MappedSnapshot snapshot(path);
+    switch (snapshot.getStatus()) {
+        case MappedSnapshot::Status::Ok:
+            break;
+        case MappedSnapshot::Status::IoError:
+            return info;
+        case MappedSnapshot::Status::Corrupt:
+            info.status = Status::Corrupt;
+            return info;
+        case MappedSnapshot::Status::VersionMismatch:
+            info.status = Status::VersionMismatch;
+            return info;
+    }
+    
+    std::lock_guard<std::mutex> lock(catalogWriterMutex_);
+    if (!moviePool_.empty() || !theaterPool_.empty() || showCount_ != 0 ||
+        nextBookingId_.load(std::memory_order_relaxed) != 1) {
+        info.status = Status::NotEmpty;
+        return info;
+    }
+    
+    const SnapshotHeader& header = snapshot.getHeader();
+    auto movies = snapshot.section<SnapshotMovie>(Section::Movies);
+    auto links = snapshot.section<uint32_t>(Section::TheaterLinks);
+    auto theaters = snapshot.section<SnapshotTheater>(Section::Theaters);
+    auto rows = snapshot.section<SeatLayout::Row>(Section::LayoutRows);
+    auto scores = snapshot.section<int32_t>(Section::LayoutScores);
+    auto strings = snapshot.section<char>(Section::Strings);
+    auto shows = snapshot.section<SnapshotShow>(Section::Shows);
+    auto words = snapshot.section<uint64_t>(Section::SeatWords);
+    auto bookings = snapshot.section<SnapshotBooking>(Section::Bookings);
+    
+    // Check every reference before changing anything: the checksums only
+    // prove the file is the one that was written
+    info.status = Status::Corrupt;
+    auto fits = [](uint64_t offset, uint64_t count, size_t size) {
+        return offset <= size && count <= size - offset;
+    };
+    for (const SnapshotMovie& saved : movies) {
+        if (!fits(saved.titleOffset, saved.titleLength, strings.size()) ||
+            !fits(saved.linkOffset, saved.linkCount, links.size())) {
+            return info;
+        }
+    }
+    for (const SnapshotTheater& saved : theaters) {
+        if (!fits(saved.nameOffset, saved.nameLength, strings.size()) ||
+            !fits(saved.layoutRowOffset, saved.layoutRowCount, rows.size()) ||
+            !fits(saved.layoutScoreOffset, saved.layoutScoreCount, scores.size())) {
+            return info;
+        }
+    }
+    for (const SnapshotShow& saved : shows) {
+        if (saved.capacity == 0 || saved.capacity > SeatMap::MAX_CAPACITY ||
+            saved.wordCount != (saved.capacity + 63) / 64 ||
+            !fits(saved.wordOffset, saved.wordCount, words.size())) {
+            return info;
+        }
+        uint32_t tail = saved.capacity % 64;
+        if (tail != 0 && (words[saved.wordOffset + saved.wordCount - 1] >> tail) != 0) {
+            return info;  // Seats past the capacity
+        }
+    }
+    if (header.nextBookingId == 0 || header.nextBookingId > decltype(bookings_)::CAPACITY) {
+        return info;
+    }
+    for (const SnapshotBooking& saved : bookings) {
+        const Booking& record = saved.record;
+        if (record.bookingId == 0 || record.bookingId >= header.nextBookingId ||
+            record.seatCount > Booking::MAX_SEATS ||
+            (saved.status != static_cast<uint64_t>(BookingStatus::Active) &&
+             saved.status != static_cast<uint64_t>(BookingStatus::Cancelled))) {
+            return info;
+        }
+        for (uint16_t seat : record.seatIndexes()) {
+            if (seat >= SeatMap::MAX_CAPACITY) {
+                return info;
+            }
+        }
+    }
+    
+    // Catalog
+    for (const SnapshotTheater& saved : theaters) {
+        std::shared_ptr<const SeatLayout> layout;
+        if (saved.layoutRowCount > 0) {
+            auto layoutRows = rows.subspan(saved.layoutRowOffset, saved.layoutRowCount);
+            auto layoutScores = scores.subspan(saved.layoutScoreOffset, saved.layoutScoreCount);
+            layout = std::make_shared<const SeatLayout>(
+                std::vector<SeatLayout::Row>(layoutRows.begin(), layoutRows.end()),
+                std::vector<int32_t>(layoutScores.begin(), layoutScores.end()));
+        }
+        const Theater* theater = &theaterPool_.emplace_back(
+            saved.id, std::string(snapshot.string(saved.nameOffset, saved.nameLength)),
+            saved.capacity, std::move(layout));
+        auto* entry = theaters_.insertIfAbsent(saved.id, [this]() {
+            return &theaterEntries_.emplace_back();
+        });
+        publish(entry->current, static_cast<const TheaterRecord*>(new TheaterRecord{theater}));
+    }
+    
+    auto* list = new MovieList();
+    list->reserve(movies.size());
+    for (const SnapshotMovie& saved : movies) {
+        const Movie* movie = &moviePool_.emplace_back(
+            saved.id, std::string(snapshot.string(saved.titleOffset, saved.titleLength)));
+        auto* entry = movies_.insertIfAbsent(saved.id, [this]() {
+            return &movieEntries_.emplace_back();
+        });
+        auto theaterIds = links.subspan(saved.linkOffset, saved.linkCount);
+        publish(entry->current, static_cast<const MovieRecord*>(
+            new MovieRecord{movie, std::vector<uint32_t>(theaterIds.begin(), theaterIds.end())}));
+        list->push_back(movie);
+    }
+    std::sort(list->begin(), list->end(), [](const Movie* a, const Movie* b) { return a->id < b->id; });
+    publish(movieList_, static_cast<const MovieList*>(list));
+    
+    // Shows, created in handle order so saved handles stay valid. Shows
+    // without a theater layout share one single-row layout per capacity.
+    std::unordered_map<uint32_t, std::shared_ptr<const SeatLayout>> singleRows;
+    for (size_t i = 0; i < shows.size(); ++i) {
+        const SnapshotShow& saved = shows[i];
+        std::shared_ptr<const SeatLayout> layout;
+        if (const TheaterRecord* theater = findTheater(saved.theaterId)) {
+            layout = theater->theater->layout;
+        }
+        if (!layout || !layout->isValid() || layout->getCapacity() != saved.capacity) {
+            auto& shared = singleRows[saved.capacity];
+            if (!shared) {
+                shared = std::make_shared<const SeatLayout>(SeatLayout::singleRow(saved.capacity));
+            }
+            layout = shared;
+        }
+        
+        Show* show = getOrCreateShow(saved.movieId, saved.theaterId, saved.capacity, std::move(layout));
+        if (!show || show->handle != i) {
+            return info;  // Duplicate show
+        }
+        SeatLease seats(*show);
+        auto booked = words.subspan(saved.wordOffset, saved.wordCount);
+        if (seats->getWordCount() != saved.wordCount) {
+            return info;
+        }
+        if (std::any_of(booked.begin(), booked.end(), [](uint64_t word) { return word != 0; })) {
+            seats->tryBook(booked, ClaimOptions{});
+        }
+    }
+    
+    // Bookings: plain copies into their slots
+    for (const SnapshotBooking& saved : bookings) {
+        BookingSlot* slot = bookings_.at(saved.record.bookingId);
+        slot->record = saved.record;
+        slot->status.store(static_cast<BookingStatus>(saved.status), std::memory_order_release);
+    }
+    nextBookingId_.store(header.nextBookingId, std::memory_order_release);
+    
+    info.status = Status::Ok;
+    info.walLsn = header.walLsn;
+    info.showCount = shows.size();
+    info.bookingCount = bookings.size();
+    info.bytes = snapshot.getSize();
+    return info;
+}
+
+// ===== Recovery =====
+
+RecoveryInfo BookingService::recover(const std::string& snapshotPath, uint32_t threads) {
+    using Status = RecoveryInfo::Status;
+    auto start = std::chrono::steady_clock::now();
+    RecoveryInfo info;
+    
+    // The latest snapshot, if there is one
+    uint64_t fromLsn = 1;
+    struct stat fileInfo;
+    if (!snapshotPath.empty() && ::stat(snapshotPath.c_str(), &fileInfo) == 0) {
+        info.snapshot = loadSnapshot(snapshotPath);
+        if (!info.snapshot.ok()) {
+            info.status = Status::SnapshotFailed;
+            return info;
+        }
+        info.snapshotLoaded = true;
+        fromLsn = std::max<uint64_t>(info.snapshot.walLsn, 1);
+    }
+    
+    // The log tail, mapped in place segment by segment. Nothing has been
+    // appended yet, so the files hold exactly the records before
+    // getNextLsn(); compaction only deleted segments below fromLsn.
+    if (log_) {
+        info.tornBytes = log_->getTornBytes();
+        std::vector<std::pair<void*, size_t>> mappings;
+        std::vector<std::span<const LogRecord>> parts;
+        uint64_t nextLsn = fromLsn;
+        for (const BookingLog::Segment& segment : log_->getSegments()) {
+            uint64_t endLsn = segment.firstLsn + segment.records;
+            if (endLsn <= fromLsn) {
+                continue;
+            }
+            if (segment.firstLsn > nextLsn) {
+                break;  // Records between the snapshot and this segment are gone
+            }
+            size_t bytes = static_cast<size_t>(segment.records * sizeof(LogRecord));
+            int fd = ::open(segment.path.c_str(), O_RDONLY | O_CLOEXEC);
+            void* mapping = fd < 0 ? MAP_FAILED
+                                   : ::mmap(nullptr, bytes, PROT_READ, MAP_PRIVATE | MAP_POPULATE, fd, 0);
+            if (fd >= 0) {
+                ::close(fd);
+            }
+            if (mapping == MAP_FAILED) {
+                break;
+            }
+            mappings.emplace_back(mapping, bytes);
+            const auto* records = static_cast<const LogRecord*>(mapping);
+            parts.emplace_back(records + (nextLsn - segment.firstLsn), records + segment.records);
+            nextLsn = endLsn;
+        }
+        
+        if (nextLsn < log_->getNextLsn()) {
+            info.status = Status::LogUnreadable;
+        } else if (!parts.empty()) {
+            replayLog(parts, threads, info);
+        }
+        for (auto [mapping, bytes] : mappings) {
+            ::munmap(mapping, bytes);
+        }
+        
+        // A crash lost records the snapshot holds: new ones go past them,
+        // or the next recovery from this snapshot would skip them
+        if (info.ok() && !log_->advanceTo(fromLsn)) {
+            info.status = Status::LogFailed;
+        }
+        if (!info.ok()) {
+            return info;
+        }
+    }
+    
+    if (log_ && !config_.snapshotPath.empty() && config_.compactionInterval.count() > 0 &&
+        !compactor_.joinable()) {
+        compactor_ = std::thread([this]() { runCompactor(); });
+    }
+    
+    info.elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+    return info;
+}
+
+void BookingService::replayLog(const std::vector<std::span<const LogRecord>>& parts, uint32_t threads,
+                               RecoveryInfo& info) {
+    const uint32_t workers = threads != 0 ? threads : std::max(1u, std::thread::hardware_concurrency());
+    info.workers = workers;
+    
+    // Serial pass: resolve every record's show (creating the ones the
+    // snapshot did not have yet), give each show a private copy of its
+    // seat words and hand its records to worker (show % workers)
+    struct Replayed {
+        Show* show;
+        size_t wordOffset;
+    };
+    std::vector<Replayed> shows;
+    std::vector<uint64_t> words;
+    std::unordered_map<uint64_t, uint32_t> showIndex;  // showKey -> shows index (UINT32_MAX: none)
+    std::vector<std::vector<std::pair<const LogRecord*, uint32_t>>> work(workers);  // (record, show)
+    uint64_t recordCount = 0;
+    
+    for (const LogRecord& record : parts | std::views::join) {
+        ++recordCount;
+        auto [it, inserted] = showIndex.try_emplace(showKey(record.movieId, record.theaterId), UINT32_MAX);
+        if (inserted) {
+            Show* show = nullptr;
+            uint32_t capacity = 0;
+            std::shared_ptr<const SeatLayout> layout;
+            {
+                auto guard = EpochReclaimer::global().pin();
+                const TheaterRecord* theater = findTheater(record.theaterId);
+                if (theater && findMovie(record.movieId)) {
+                    capacity = theater->theater->capacity;
+                    layout = theater->theater->layout;
+                }
+            }
+            if (capacity != 0) {
+                show = getOrCreateShow(record.movieId, record.theaterId, capacity, std::move(layout));
+            }
+            if (show) {
+                it->second = static_cast<uint32_t>(shows.size());
+                SeatLease seats(*show);
+                shows.push_back({show, words.size()});
+                for (uint32_t w = 0; w < seats->getWordCount(); ++w) {
+                    words.push_back(seats->getOccupiedWord(w));
+                }
+            }
+        }
+        
+        bool valid = it->second != UINT32_MAX && record.bookingId != 0 &&
+                     record.bookingId < decltype(bookings_)::CAPACITY &&
+                     record.seatCount <= LogRecord::MAX_SEATS &&
+                     (record.type == LogRecord::Type::Book || record.type == LogRecord::Type::Exchange ||
+                      record.type == LogRecord::Type::Cancel);
+        if (valid) {
+            uint32_t capacity = shows[it->second].show->layout->getCapacity();
+            for (uint16_t seat : std::span<const uint16_t>(record.seats, record.seatCount)) {
+                valid = valid && seat < capacity;
+            }
+        }
+        if (!valid) {
+            ++info.skippedRecords;
+            continue;
+        }
+        work[it->second % workers].emplace_back(&record, it->second);
+    }
+    
+    // Parallel pass: each show belongs to one worker, which applies its
+    // records in lsn order to the private words and the booking slots
+    // (a booking's records are all in its show), then stores the result
+    // with one claim and one release per show
+    std::vector<uint64_t> maxIds(workers, 0);
+    auto replay = [&](uint32_t worker) {
+        uint64_t maxId = 0;
+        for (auto [r, s] : work[worker]) {
+            const LogRecord& record = *r;
+            uint64_t* showWords = words.data() + shows[s].wordOffset;
+            BookingSlot* slot = bookings_.at(record.bookingId);
+            std::span<const uint16_t> seats(record.seats, record.seatCount);
+            
+            if (record.type != LogRecord::Type::Cancel) {
+                for (uint16_t seat : seats) {
+                    showWords[seat / 64] |= (uint64_t{1} << (seat % 64));
+                }
+                Booking& booking = slot->record;
+                booking.bookingId = record.bookingId;
+                booking.movieId = record.movieId;
+                booking.theaterId = record.theaterId;
+                booking.seatCount = record.seatCount;
+                std::copy(seats.begin(), seats.end(), booking.seats);
+                slot->lsn = record.lsn;
+                slot->status.store(BookingStatus::Active, std::memory_order_relaxed);
+            } else {
+                for (uint16_t seat : seats) {
+                    showWords[seat / 64] &= ~(uint64_t{1} << (seat % 64));
+                }
+                slot->status.store(BookingStatus::Cancelled, std::memory_order_relaxed);
+            }
+            maxId = std::max(maxId, record.bookingId);
+        }
+        
+        for (size_t s = worker; s < shows.size(); s += workers) {
+            SeatLease seats(*shows[s].show);
+            uint32_t wordCount = seats->getWordCount();
+            std::array<uint64_t, SeatMap::MAX_WORDS> claim{};
+            std::array<uint64_t, SeatMap::MAX_WORDS> release{};
+            for (uint32_t w = 0; w < wordCount; ++w) {
+                uint64_t before = seats->getOccupiedWord(w);
+                uint64_t after = words[shows[s].wordOffset + w];
+                claim[w] = after & ~before;
+                release[w] = before & ~after;
+            }
+            seats->release(std::span<const uint64_t>(release.data(), wordCount));
+            seats->tryBook(std::span<const uint64_t>(claim.data(), wordCount), ClaimOptions{});
+        }
+        maxIds[worker] = maxId;
+    };
+    
+    std::vector<std::thread> pool;
+    for (uint32_t worker = 1; worker < workers; ++worker) {
+        pool.emplace_back(replay, worker);
+    }
+    replay(0);
+    for (auto& thread : pool) {
+        thread.join();
+    }
+    
+    // New ids continue after every replayed one
+    uint64_t maxId = *std::max_element(maxIds.begin(), maxIds.end());
+    if (maxId + 1 > nextBookingId_.load(std::memory_order_relaxed)) {
+        nextBookingId_.store(maxId + 1, std::memory_order_release);
+    }
+    info.replayedRecords = recordCount - info.skippedRecords;
+}
+
+// ===== Log Compaction =====
+
+size_t BookingService::compactLog() {
+    std::lock_guard<std::mutex> lock(compactionMutex_);
+    if (!log_ || config_.snapshotPath.empty() || log_->getSegments().size() < 2) {
+        return 0;
+    }
+    
+    // Closed segments were synced whole before the log moved on, and the
+    // snapshot holds every change logged before its walLsn, all of them
+    // durable once it is saved: the segments below it are never needed
+    // again, even if a crash drops the records staged after it
+    SnapshotInfo info = saveSnapshot(config_.snapshotPath);
+    if (!info.ok()) {
+        return 0;
+    }
+    compactions_.fetch_add(1, std::memory_order_relaxed);
+    return log_->removeSegmentsBefore(info.walLsn);
+}
+
+void BookingService::runCompactor() {
+    std::unique_lock<std::mutex> lock(compactorMutex_);
+    while (!compactorWake_.wait_for(lock, config_.compactionInterval, [this]() { return stopCompactor_; })) {
+        lock.unlock();
+        compactLog();
+        lock.lock();
+    }
+}
+
+uint32_t BookingService::getCapacity(uint32_t movieId, uint32_t theaterId) const {
+    const Show* show = findShow(movieId, theaterId);
+    return show ? SeatLease(*show)->getCapacity() : getTheaterCapacity(theaterId);
+}
+
+double BookingService::getOccupancyPercentage(
+    uint32_t movieId, uint32_t theaterId) const {
+    
+    uint32_t capacity = getCapacity(movieId, theaterId);
+    uint32_t available = getAvailableCount(movieId, theaterId);
+    uint32_t occupied = capacity - available;
+    
+    return (static_cast<double>(occupied) / capacity) * 100.0;
+}
+
+uint64_t BookingService::getRetryCount() const {
+    return contentionStats_.retries.load(std::memory_order_relaxed);
+}
+
+uint64_t BookingService::getGiveUpCount() const {
+    return contentionStats_.giveUps.load(std::memory_order_relaxed);
+}
+
+uint64_t BookingService::getCompactionCount() const {
+    return compactions_.load(std::memory_order_relaxed);
 }
@@ -0,0 +1,204 @@
+#include "BookingSnapshot.h"
+#include "Checksum.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+    // Entry size of each section, in SnapshotSectionId order
+    constexpr size_t ENTRY_SIZES[SnapshotHeader::SECTION_COUNT] = {
+        sizeof(SnapshotMovie),
+        sizeof(uint32_t),
+        sizeof(SnapshotTheater),
+        sizeof(SeatLayout::Row),
+        sizeof(int32_t),
+        1,
+        sizeof(SnapshotShow),
+        sizeof(uint64_t),
+        sizeof(SnapshotBooking),
+    };
+
+    uint32_t headerChecksum(SnapshotHeader header) {
+        header.checksum = 0;
+        return crc32c(&header, sizeof(header));
+    }
+
+    bool writeAll(int fd, const char* data, size_t size, uint64_t offset) {
+        while (size > 0) {
+            ssize_t written = ::pwrite(fd, data, size, static_cast<off_t>(offset));
+            if (written < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                return false;
+            }
+            data += written;
+            size -= static_cast<size_t>(written);
+            offset += static_cast<uint64_t>(written);
+        }
+        return true;
+    }
+}
+
+// ===== SnapshotWriter =====
+
+SnapshotWriter::SnapshotWriter(const std::string& path)
+    : path_(path), tempPath_(path + ".tmp") {
+    fd_ = ::open(tempPath_.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    failed_ = fd_ < 0;
+    buffer_.reserve(BUFFER_SIZE);
+}
+
+SnapshotWriter::~SnapshotWriter() {
+    if (fd_ >= 0) {
+        ::close(fd_);
+    }
+    if (!finished_) {
+        ::unlink(tempPath_.c_str());
+    }
+}
+
+void SnapshotWriter::beginSection(SnapshotSectionId id) {
+    // Sections start 8-byte aligned, so entries can be used in place
+    static constexpr char padding[8] = {};
+    append(padding, (8 - offset_ % 8) % 8);
+
+    current_ = &header_.sections[static_cast<size_t>(id)];
+    current_->offset = offset_;
+    current_->checksum = 0;
+}
+
+void SnapshotWriter::append(const void* data, size_t bytes) {
+    if (current_) {
+        current_->checksum = crc32c(data, bytes, current_->checksum);
+    }
+    const char* p = static_cast<const char*>(data);
+    while (bytes > 0) {
+        size_t chunk = std::min(bytes, BUFFER_SIZE - buffer_.size());
+        buffer_.insert(buffer_.end(), p, p + chunk);
+        p += chunk;
+        bytes -= chunk;
+        offset_ += chunk;
+        if (buffer_.size() == BUFFER_SIZE) {
+            flush();
+        }
+    }
+}
+
+void SnapshotWriter::endSection(uint64_t count) {
+    current_->count = count;
+    current_->bytes = offset_ - current_->offset;
+    current_ = nullptr;
+}
+
+void SnapshotWriter::flush() {
+    if (!failed_ && !buffer_.empty()) {
+        failed_ = !writeAll(fd_, buffer_.data(), buffer_.size(), offset_ - buffer_.size());
+    }
+    buffer_.clear();
+}
+
+bool SnapshotWriter::finish(uint64_t walLsn, uint64_t nextBookingId) {
+    flush();
+
+    std::memcpy(header_.magic, SnapshotHeader::MAGIC, sizeof(header_.magic));
+    header_.version = SnapshotHeader::VERSION;
+    header_.fileSize = offset_;
+    header_.walLsn = walLsn;
+    header_.nextBookingId = nextBookingId;
+    header_.checksum = headerChecksum(header_);
+
+    failed_ = failed_ ||
+              !writeAll(fd_, reinterpret_cast<const char*>(&header_), sizeof(header_), 0) ||
+              ::fsync(fd_) != 0;
+    if (failed_) {
+        return false;
+    }
+    ::close(fd_);
+    fd_ = -1;
+
+    // Atomic replace, then make the rename itself durable
+    if (std::rename(tempPath_.c_str(), path_.c_str()) != 0) {
+        return false;
+    }
+    finished_ = true;
+    std::string directory = path_.substr(0, path_.find_last_of('/') + 1);
+    int dirFd = ::open(directory.empty() ? "." : directory.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (dirFd >= 0) {
+        ::fsync(dirFd);
+        ::close(dirFd);
+    }
+    return true;
+}
+
+// ===== MappedSnapshot =====
+
+MappedSnapshot::MappedSnapshot(const std::string& path) {
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return;
+    }
+    struct stat info;
+    if (::fstat(fd, &info) != 0) {
+        ::close(fd);
+        return;
+    }
+    size_ = static_cast<size_t>(info.st_size);
+    if (size_ < sizeof(SnapshotHeader)) {
+        ::close(fd);
+        status_ = Status::Corrupt;
+        return;
+    }
+
+    void* mapping = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE | MAP_POPULATE, fd, 0);
+    ::close(fd);  // The mapping keeps the file
+    if (mapping == MAP_FAILED) {
+        return;
+    }
+    base_ = static_cast<const char*>(mapping);
+    header_ = reinterpret_cast<const SnapshotHeader*>(base_);
+    status_ = check();
+}
+
+MappedSnapshot::~MappedSnapshot() {
+    if (base_) {
+        ::munmap(const_cast<char*>(base_), size_);
+    }
+}
+
+MappedSnapshot::Status MappedSnapshot::check() const {
+    if (std::memcmp(header_->magic, SnapshotHeader::MAGIC, sizeof(header_->magic)) != 0) {
+        return Status::Corrupt;
+    }
+    if (header_->version != SnapshotHeader::VERSION) {
+        return Status::VersionMismatch;
+    }
+    if (header_->checksum != headerChecksum(*header_) || header_->fileSize != size_) {
+        return Status::Corrupt;
+    }
+
+    for (size_t i = 0; i < SnapshotHeader::SECTION_COUNT; ++i) {
+        const SnapshotSection& s = header_->sections[i];
+        if (s.offset % 8 != 0 || s.offset > size_ || s.bytes > size_ - s.offset ||
+            s.count > s.bytes / ENTRY_SIZES[i] || s.count * ENTRY_SIZES[i] != s.bytes) {
+            return Status::Corrupt;
+        }
+        if (crc32c(base_ + s.offset, s.bytes) != s.checksum) {
+            return Status::Corrupt;
+        }
+    }
+    return Status::Ok;
+}
+
+std::string_view MappedSnapshot::string(uint64_t offset, uint32_t length) const {
+    auto strings = section<char>(SnapshotSectionId::Strings);
+    if (offset > strings.size() || length > strings.size() - offset) {
+        return {};
+    }
+    return {strings.data() + offset, length};
+}
@@ -0,0 +1,77 @@
+#include "Checksum.h"
+#include <array>
+#include <cstring>
+
+namespace {
+    constexpr uint32_t POLYNOMIAL = 0x82F63B78;  // CRC-32C, reflected
+
+    // table[k][b]: CRC of byte b followed by k zero bytes
+    constexpr std::array<std::array<uint32_t, 256>, 8> makeTables() {
+        std::array<std::array<uint32_t, 256>, 8> tables{};
+        for (uint32_t b = 0; b < 256; ++b) {
+            uint32_t crc = b;
+            for (int bit = 0; bit < 8; ++bit) {
+                crc = (crc >> 1) ^ ((crc & 1) ? POLYNOMIAL : 0);
+            }
+            tables[0][b] = crc;
+        }
+        for (size_t k = 1; k < 8; ++k) {
+            for (uint32_t b = 0; b < 256; ++b) {
+                uint32_t previous = tables[k - 1][b];
+                tables[k][b] = (previous >> 8) ^ tables[0][previous & 0xFF];
+            }
+        }
+        return tables;
+    }
+
+    constexpr auto TABLES = makeTables();
+
+    uint32_t crc32cTable(const unsigned char* p, size_t size, uint32_t crc) {
+        for (; size >= 8; p += 8, size -= 8) {
+            uint64_t word;
+            std::memcpy(&word, p, 8);
+            word ^= crc;  // Little-endian: the CRC lines up with the first 4 bytes
+            crc = TABLES[7][word & 0xFF] ^ TABLES[6][(word >> 8) & 0xFF] ^
+                  TABLES[5][(word >> 16) & 0xFF] ^ TABLES[4][(word >> 24) & 0xFF] ^
+                  TABLES[3][(word >> 32) & 0xFF] ^ TABLES[2][(word >> 40) & 0xFF] ^
+                  TABLES[1][(word >> 48) & 0xFF] ^ TABLES[0][word >> 56];
+        }
+        for (; size > 0; ++p, --size) {
+            crc = (crc >> 8) ^ TABLES[0][(crc ^ *p) & 0xFF];
+        }
+        return crc;
+    }
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+    __attribute__((target("sse4.2")))
+    uint32_t crc32cHardware(const unsigned char* p, size_t size, uint32_t crc) {
+        uint64_t crc64 = crc;
+        for (; size >= 8; p += 8, size -= 8) {
+            uint64_t word;
+            std::memcpy(&word, p, 8);
+            crc64 = __builtin_ia32_crc32di(crc64, word);
+        }
+        crc = static_cast<uint32_t>(crc64);
+        for (; size > 0; ++p, --size) {
+            crc = __builtin_ia32_crc32qi(crc, *p);
+        }
+        return crc;
+    }
+
+    const bool HAS_HARDWARE_CRC = []() {
+        __builtin_cpu_init();  // May run before the CPU model is initialized
+        return __builtin_cpu_supports("sse4.2") != 0;
+    }();
+#endif
+}
+
+uint32_t crc32c(const void* data, size_t size, uint32_t crc) {
+    const auto* p = static_cast<const unsigned char*>(data);
+    crc = ~crc;
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+    if (HAS_HARDWARE_CRC) {
+        return ~crc32cHardware(p, size, crc);
+    }
+#endif
+    return ~crc32cTable(p, size, crc);
+}
@@ -0,0 +1,150 @@
+#include "EpochReclaimer.h"
+#include <algorithm>
+#include <thread>
+
+struct EpochReclaimer::ThreadState {
+    Slot* slot = nullptr;
+    uint32_t depth = 0;  // Nested guards
+
+    ~ThreadState() {
+        if (slot) {
+            slot->epoch.store(IDLE, std::memory_order_release);
+            slot->inUse.store(false, std::memory_order_release);
+        }
+    }
+};
+
+EpochReclaimer& EpochReclaimer::global() {
+    static EpochReclaimer instance;
+    return instance;
+}
+
+EpochReclaimer::ThreadState& EpochReclaimer::threadState() {
+    thread_local ThreadState state;
+    return state;
+}
+
+EpochReclaimer::~EpochReclaimer() {
+    // No readers left at static destruction
+    for (const auto& r : retired_) {
+        r.deleter(r.object);
+    }
+    Slot* slot = slots_.load(std::memory_order_acquire);
+    while (slot) {
+        Slot* next = slot->next;
+        delete slot;
+        slot = next;
+    }
+}
+
+EpochReclaimer::Slot* EpochReclaimer::acquireSlot() {
+    // Reuse a slot released by an exited thread
+    for (Slot* slot = slots_.load(std::memory_order_acquire); slot; slot = slot->next) {
+        bool expected = false;
+        if (!slot->inUse.load(std::memory_order_relaxed) &&
+            slot->inUse.compare_exchange_strong(expected, true, std::memory_order_acq_rel)) {
+            return slot;
+        }
+    }
+
+    Slot* slot = new Slot();
+    slot->inUse.store(true, std::memory_order_relaxed);
+    Slot* head = slots_.load(std::memory_order_relaxed);
+    do {
+        slot->next = head;
+    } while (!slots_.compare_exchange_weak(head, slot,
+                                           std::memory_order_release,
+                                           std::memory_order_relaxed));
+    return slot;
+}
+
+void EpochReclaimer::enter() {
+    ThreadState& state = threadState();
+    if (state.depth++ > 0) {
+        return;
+    }
+    if (!state.slot) {
+        state.slot = acquireSlot();
+    }
+
+    // Announce the epoch, then fence before reading any RCU pointer;
+    // pairs with the fence in reclaimLocked (store-load ordering)
+    state.slot->epoch.store(globalEpoch_.load(std::memory_order_acquire),
+                            std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+}
+
+void EpochReclaimer::exit() {
+    ThreadState& state = threadState();
+    if (--state.depth == 0) {
+        state.slot->epoch.store(IDLE, std::memory_order_release);
+    }
+}
+
+void EpochReclaimer::retire(void* object, void (*deleter)(void*)) {
+    std::lock_guard<std::mutex> lock(retiredMutex_);
+
+    // Readers entering from now on see the new epoch, and therefore the
+    // version published before this call
+    uint64_t epoch = globalEpoch_.fetch_add(1, std::memory_order_acq_rel);
+    retired_.push_back({object, deleter, epoch});
+
+    if (retired_.size() >= RECLAIM_THRESHOLD) {
+        reclaimLocked();
+    }
+}
+
+bool EpochReclaimer::synchronize(std::chrono::nanoseconds timeout) {
+    // Guards entered from now on announce `target` or later; the fence
+    // pairs with the one in enter(), like reclaimLocked
+    uint64_t target = globalEpoch_.fetch_add(1, std::memory_order_acq_rel) + 1;
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    auto start = std::chrono::steady_clock::now();
+    Slot* own = threadState().slot;
+    for (Slot* slot = slots_.load(std::memory_order_acquire); slot; slot = slot->next) {
+        if (slot == own) {
+            continue;
+        }
+        while (slot->epoch.load(std::memory_order_acquire) < target) {
+            if (std::chrono::steady_clock::now() - start >= timeout) {
+                return false;
+            }
+            std::this_thread::yield();
+        }
+    }
+    return true;
+}
+
+size_t EpochReclaimer::reclaim() {
+    std::lock_guard<std::mutex> lock(retiredMutex_);
+    return reclaimLocked();
+}
+
+size_t EpochReclaimer::pendingCount() const {
+    std::lock_guard<std::mutex> lock(retiredMutex_);
+    return retired_.size();
+}
+
+size_t EpochReclaimer::reclaimLocked() {
+    // Pairs with the fence in enter(): a reader we miss here is
+    // guaranteed to see the already-published new versions
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    uint64_t oldestActive = IDLE;
+    for (Slot* slot = slots_.load(std::memory_order_acquire); slot; slot = slot->next) {
+        oldestActive = std::min(oldestActive, slot->epoch.load(std::memory_order_acquire));
+    }
+
+    // Anything unlinked before the oldest active reader entered is unreachable
+    auto reachable = std::partition(retired_.begin(), retired_.end(),
+        [oldestActive](const Retired& r) { return r.epoch >= oldestActive; });
+
+    size_t freed = 0;
+    for (auto it = reachable; it != retired_.end(); ++it) {
+        it->deleter(it->object);
+        ++freed;
+    }
+    retired_.erase(reachable, retired_.end());
+    return freed;
+}
@@ -0,0 +1,193 @@
+#include "IoUring.h"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace {
+    int setup(uint32_t entries, io_uring_params* params) {
+        return static_cast<int>(::syscall(__NR_io_uring_setup, entries, params));
+    }
+
+    int enter(int fd, uint32_t toSubmit, uint32_t minComplete, uint32_t flags, const void* arg, size_t argSize) {
+        return static_cast<int>(::syscall(__NR_io_uring_enter, fd, toSubmit, minComplete, flags, arg, argSize));
+    }
+
+    // The rings' head and tail are shared with the kernel
+    uint32_t loadAcquire(uint32_t* value) {
+        return std::atomic_ref<uint32_t>(*value).load(std::memory_order_acquire);
+    }
+
+    void storeRelease(uint32_t* value, uint32_t next) {
+        std::atomic_ref<uint32_t>(*value).store(next, std::memory_order_release);
+    }
+
+    template <typename T>
+    T* at(void* base, uint32_t offset) {
+        return reinterpret_cast<T*>(static_cast<char*>(base) + offset);
+    }
+}
+
+std::unique_ptr<IoUring> IoUring::create(uint32_t entries) {
+    io_uring_params params;
+    std::memset(&params, 0, sizeof(params));
+    int fd = setup(entries, &params);
+    if (fd < 0) {
+        return nullptr;
+    }
+
+    std::unique_ptr<IoUring> ring(new IoUring());
+    ring->fd_ = fd;
+    if (!(params.features & IORING_FEAT_EXT_ARG)) {
+        return nullptr;  // No timed waits (before Linux 5.11)
+    }
+
+    ring->sqRingSize_ = params.sq_off.array + params.sq_entries * sizeof(uint32_t);
+    ring->cqRingSize_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    bool single = params.features & IORING_FEAT_SINGLE_MMAP;
+    if (single) {
+        ring->sqRingSize_ = ring->cqRingSize_ = std::max(ring->sqRingSize_, ring->cqRingSize_);
+    }
+
+    void* sq = ::mmap(nullptr, ring->sqRingSize_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                      fd, IORING_OFF_SQ_RING);
+    if (sq == MAP_FAILED) {
+        return nullptr;
+    }
+    ring->sqRing_ = sq;
+
+    void* cq = sq;
+    if (!single) {
+        cq = ::mmap(nullptr, ring->cqRingSize_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                    fd, IORING_OFF_CQ_RING);
+        if (cq == MAP_FAILED) {
+            return nullptr;
+        }
+    }
+    ring->cqRing_ = cq;
+
+    ring->sqesSize_ = params.sq_entries * sizeof(io_uring_sqe);
+    void* sqes = ::mmap(nullptr, ring->sqesSize_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                        fd, IORING_OFF_SQES);
+    if (sqes == MAP_FAILED) {
+        return nullptr;
+    }
+    ring->sqes_ = static_cast<io_uring_sqe*>(sqes);
+
+    ring->sqHead_ = at<uint32_t>(sq, params.sq_off.head);
+    ring->sqTail_ = at<uint32_t>(sq, params.sq_off.tail);
+    ring->sqArray_ = at<uint32_t>(sq, params.sq_off.array);
+    ring->sqMask_ = *at<uint32_t>(sq, params.sq_off.ring_mask);
+    ring->sqEntries_ = params.sq_entries;
+    ring->cqHead_ = at<uint32_t>(cq, params.cq_off.head);
+    ring->cqTail_ = at<uint32_t>(cq, params.cq_off.tail);
+    ring->cqes_ = at<io_uring_cqe>(cq, params.cq_off.cqes);
+    ring->cqMask_ = *at<uint32_t>(cq, params.cq_off.ring_mask);
+    ring->queuedTail_ = *ring->sqTail_;
+    return ring;
+}
+
+IoUring::~IoUring() {
+    if (sqes_) {
+        ::munmap(sqes_, sqesSize_);
+    }
+    if (cqRing_ && cqRing_ != sqRing_) {
+        ::munmap(cqRing_, cqRingSize_);
+    }
+    if (sqRing_) {
+        ::munmap(sqRing_, sqRingSize_);
+    }
+    if (fd_ >= 0) {
+        ::close(fd_);  // Also drops the registered buffers
+    }
+}
+
+bool IoUring::registerBuffers(std::span<const iovec> buffers) {
+    return ::syscall(__NR_io_uring_register, fd_, IORING_REGISTER_BUFFERS, buffers.data(),
+                     static_cast<unsigned>(buffers.size())) == 0;
+}
+
+io_uring_sqe* IoUring::nextSqe() {
+    if (queuedTail_ - loadAcquire(sqHead_) >= sqEntries_) {
+        return nullptr;
+    }
+    uint32_t index = queuedTail_ & sqMask_;
+    io_uring_sqe* sqe = &sqes_[index];
+    std::memset(sqe, 0, sizeof(*sqe));
+    sqArray_[index] = index;
+    ++queuedTail_;
+    ++toSubmit_;
+    return sqe;
+}
+
+bool IoUring::write(int fd, const void* data, uint32_t size, uint64_t offset, int bufferIndex,
+                    uint64_t userData, bool link) {
+    io_uring_sqe* sqe = nextSqe();
+    if (!sqe) {
+        return false;
+    }
+    sqe->opcode = bufferIndex >= 0 ? IORING_OP_WRITE_FIXED : IORING_OP_WRITE;
+    sqe->fd = fd;
+    sqe->addr = reinterpret_cast<uint64_t>(data);
+    sqe->len = size;
+    sqe->off = offset;
+    sqe->buf_index = static_cast<uint16_t>(bufferIndex >= 0 ? bufferIndex : 0);
+    sqe->flags = link ? IOSQE_IO_LINK : 0;
+    sqe->user_data = userData;
+    return true;
+}
+
+bool IoUring::fdatasync(int fd, uint64_t userData) {
+    io_uring_sqe* sqe = nextSqe();
+    if (!sqe) {
+        return false;
+    }
+    sqe->opcode = IORING_OP_FSYNC;
+    sqe->fd = fd;
+    sqe->fsync_flags = IORING_FSYNC_DATASYNC;
+    sqe->user_data = userData;
+    return true;
+}
+
+bool IoUring::submitAndWait(uint32_t minComplete, std::chrono::nanoseconds timeout) {
+    storeRelease(sqTail_, queuedTail_);
+
+    uint32_t flags = minComplete > 0 ? IORING_ENTER_GETEVENTS : 0;
+    __kernel_timespec ts{};
+    io_uring_getevents_arg arg{};
+    const void* argument = nullptr;
+    size_t argumentSize = 0;
+    if (minComplete > 0 && timeout != std::chrono::nanoseconds::max()) {
+        timeout = std::max(timeout, std::chrono::nanoseconds(0));
+        ts.tv_sec = timeout.count() / 1000000000;
+        ts.tv_nsec = timeout.count() % 1000000000;
+        arg.sigmask_sz = _NSIG / 8;
+        arg.ts = reinterpret_cast<uint64_t>(&ts);
+        flags |= IORING_ENTER_EXT_ARG;
+        argument = &arg;
+        argumentSize = sizeof(arg);
+    }
+
+    int submitted = enter(fd_, toSubmit_, minComplete, flags, argument, argumentSize);
+    if (submitted < 0) {
+        return errno == ETIME || errno == EINTR || errno == EAGAIN || errno == EBUSY;
+    }
+    toSubmit_ -= static_cast<uint32_t>(submitted);
+    return true;
+}
+
+bool IoUring::popCompletion(Completion& completion) {
+    uint32_t head = *cqHead_;  // Only we move the head
+    if (head == loadAcquire(cqTail_)) {
+        return false;
+    }
+    const io_uring_cqe& cqe = cqes_[head & cqMask_];
+    completion = {cqe.user_data, cqe.res};
+    storeRelease(cqHead_, head + 1);
+    return true;
+}
@@ -0,0 +1,74 @@
+#include "SeatArena.h"
+#include <new>
+
+SeatArena::~SeatArena() {
+    for (std::byte* chunk : chunks_) {
+        ::operator delete(chunk, std::align_val_t{CACHE_LINE_SIZE});
+    }
+}
+
+SeatArena::FreeList& SeatArena::freeListFor(size_t size, size_t alignment) {
+    for (FreeList& list : freeLists_) {
+        if (list.size == size && list.alignment == alignment) {
+            return list;
+        }
+    }
+    freeLists_.push_back({size, alignment, {}});
+    return freeLists_.back();
+}
+
+void* SeatArena::allocate(size_t size, size_t alignment, Tier tier) {
+    size_t blockAlign = blockAlignment(alignment, tier);
+    size_t bytes = blockSize(size, alignment, tier);
+    if (bytes > CHUNK_SIZE || blockAlign > CACHE_LINE_SIZE) {
+        return nullptr;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    liveBytes_ += bytes;
+
+    FreeList& list = freeListFor(bytes, blockAlign);
+    if (!list.blocks.empty()) {
+        void* block = list.blocks.back();
+        list.blocks.pop_back();
+        return block;
+    }
+
+    // Bump allocate; chunks are cache-line aligned, so aligning the
+    // offset aligns the address
+    auto offsetOf = [this](std::byte* p) { return static_cast<size_t>(p - chunks_.back()); };
+    if (cursor_) {
+        size_t offset = (offsetOf(cursor_) + blockAlign - 1) / blockAlign * blockAlign;
+        if (offset + bytes <= CHUNK_SIZE) {
+            cursor_ = chunks_.back() + offset + bytes;
+            return chunks_.back() + offset;
+        }
+    }
+
+    // The old chunk's tail is too short: start a new one
+    auto* chunk = static_cast<std::byte*>(::operator new(CHUNK_SIZE, std::align_val_t{CACHE_LINE_SIZE}));
+    chunks_.push_back(chunk);
+    cursor_ = chunk + bytes;
+    return chunk;
+}
+
+void SeatArena::deallocate(void* block, size_t size, size_t alignment, Tier tier) {
+    if (!block) {
+        return;
+    }
+    size_t bytes = blockSize(size, alignment, tier);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    liveBytes_ -= bytes;
+    freeListFor(bytes, blockAlignment(alignment, tier)).blocks.push_back(block);
+}
+
+size_t SeatArena::getReservedBytes() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return chunks_.size() * CHUNK_SIZE;
+}
+
+size_t SeatArena::getLiveBytes() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return liveBytes_;
+}
@@ -1,46 +1,4 @@
 #include "SeatBitmask.h"
-#include <algorithm>
-#include <cctype>
-#include <thread>
-#include <chrono>
-
-
-int SeatBitmask::seatIdToBit(const std::string& seatId) {
-    if (seatId.length() < 2 || seatId.length() > 3) {
-        return -1;
-    }
-    
-    // Case-insensitive check for 'a'
-    if (std::tolower(seatId[0]) != 'a') {
-        return -1;
-    }
-    
-    // Extract number portion
-    std::string numStr = seatId.substr(1);
-    
-    // Validate it's all digits
-    if (!std::all_of(numStr.begin(), numStr.end(), ::isdigit)) {
-        return -1;
-    }
-    
-    // Reject leading zeros (except "0" itself, but we reject 0 anyway)
-    if (numStr.length() > 1 && numStr[0] == '0') {
-        return -1;
-    }
-    
-    try {
-        int num = std::stoi(numStr);
-        if (num >= 1 && num <= static_cast<int>(MAX_SEATS)) {
-            return seatNumberToBit(num);
-        }
-    } catch (const std::invalid_argument&) {
-        return -1;
-    } catch (const std::out_of_range&) {
-        return -1;
-    }
-    
-    return -1;
-}
 
 std::string SeatBitmask::bitToSeatId(uint32_t bit) {
     if (bit >= MAX_SEATS) {
@@ -67,10 +25,8 @@ bool SeatBitmask::tryBook(uint32_t seatMask) {
     uint32_t expected = 0;
     uint32_t desired = 0;
 
-    constexpr uint32_t MAX_RETRIES = 100;
-
-    // CAS failed → backoff
-    for (uint32_t retries = 0; retries < MAX_RETRIES; ++retries) {
+    // CAS failed → backoff (per policy_)
+    for (uint32_t retries = 0; retries < policy_.maxRetries; ++retries) {
 
         // Explicitly reload current state
         expected = occupied_.load(std::memory_order_acquire);
@@ -92,13 +48,11 @@ bool SeatBitmask::tryBook(uint32_t seatMask) {
             return true;
         }
 
-         // Fairness / backoff
-        std::this_thread::yield();
-        std::this_thread::sleep_for(
-            std::chrono::nanoseconds(50 * (retries + 1))
-        );
+        stats_.recordRetry();
+        policy_.backoff(retries);
     }
 
+    stats_.recordGiveUp();
     return false;
 }
 
@@ -111,13 +65,12 @@ bool SeatBitmask::areAvailable(uint32_t seatMask) const {
 
 std::vector<std::string> SeatBitmask::getAvailableSeats() const {
     std::vector<std::string> available;
-    uint32_t current = occupied_.load(std::memory_order_acquire);
+    available.reserve(MAX_SEATS);
     
-    for (uint32_t bit = 0; bit < MAX_SEATS; ++bit) {
-        if ((current & (1u << bit)) == 0) {
-            available.push_back(bitToSeatId(bit));
-        }
-    }
+    forEachAvailable([&available](uint32_t bit) {
+        char label[SeatMap::MAX_SEAT_ID_LENGTH];
+        available.emplace_back(label, SeatMap::formatSeatId(bit, label));
+    });
     
     return available;
 }
@@ -128,7 +81,3 @@ uint32_t SeatBitmask::getAvailableCount() const {
     uint32_t occupiedCount = __builtin_popcount(current & ALL_SEATS_MASK);
     return MAX_SEATS - occupiedCount;
 }
-
-bool SeatBitmask::isValidSeatId(const std::string& seatId) {
-    return seatIdToBit(seatId) >= 0;
-}
@@ -0,0 +1,41 @@
+#include "SeatLayout.h"
+#include <cstdlib>
+#include <utility>
+
+SeatLayout::SeatLayout(std::vector<Row> rows, std::vector<int32_t> seatScores)
+    : rows_(std::move(rows)), scores_(std::move(seatScores)), prefix_(scores_.size() + 1, 0) {
+    for (size_t i = 0; i < scores_.size(); ++i) {
+        prefix_[i + 1] = prefix_[i] + scores_[i];
+    }
+}
+
+SeatLayout SeatLayout::uniform(uint32_t rowCount, uint32_t seatsPerRow, uint32_t preferredRow) {
+    std::vector<Row> rows;
+    std::vector<int32_t> scores;
+    rows.reserve(rowCount);
+    scores.reserve(static_cast<size_t>(rowCount) * seatsPerRow);
+
+    for (uint32_t r = 0; r < rowCount; ++r) {
+        rows.push_back({r * seatsPerRow, seatsPerRow});
+
+        int32_t rowScore = -ROW_WEIGHT * std::abs(static_cast<int32_t>(r) - static_cast<int32_t>(preferredRow));
+        for (uint32_t c = 0; c < seatsPerRow; ++c) {
+            // |2c - (n-1)| = distance from the center in half seats
+            int32_t offCenter = std::abs(static_cast<int32_t>(2 * c) - static_cast<int32_t>(seatsPerRow - 1));
+            scores.push_back(rowScore - CENTER_WEIGHT * offCenter);
+        }
+    }
+
+    return SeatLayout(std::move(rows), std::move(scores));
+}
+
+bool SeatLayout::isValid() const {
+    uint32_t next = 0;
+    for (const Row& row : rows_) {
+        if (row.firstSeat != next || row.length == 0) {
+            return false;
+        }
+        next += row.length;
+    }
+    return !rows_.empty() && next == scores_.size();
+}
@@ -0,0 +1,210 @@
+#include "SeatMap.h"
+#include "FixedSeatBitmask.h"
+#include "WideSeatBitmask.h"
+#include "SeatBitmask.h"
+#include <algorithm>
+#include <array>
+#include <new>
+#include <type_traits>
+
+namespace {
+    // Calls visit(std::type_identity<Map>{}) with the seat map type used for a capacity
+    template <typename Visit>
+    decltype(auto) visitSeatMapType(uint32_t capacity, Visit&& visit) {
+        // Common screen sizes get a compile-time specialization
+        switch (capacity) {
+            case SeatBitmask::MAX_SEATS:
+                return visit(std::type_identity<FixedSeatBitmask<SeatBitmask::MAX_SEATS>>{});
+            case 64:
+                return visit(std::type_identity<FixedSeatBitmask<64>>{});
+            case 128:
+                return visit(std::type_identity<FixedSeatBitmask<128>>{});
+            case 256:
+                return visit(std::type_identity<FixedSeatBitmask<256>>{});
+            case 512:
+                return visit(std::type_identity<FixedSeatBitmask<512>>{});
+            default:
+                return visit(std::type_identity<WideSeatBitmask>{});
+        }
+    }
+
+    template <typename Map>
+    Map* construct(void* block, uint32_t capacity) {
+        if constexpr (std::is_same_v<Map, WideSeatBitmask>) {
+            return new (block) Map(capacity);
+        } else {
+            return new (block) Map();
+        }
+    }
+}
+
+std::unique_ptr<SeatMap> SeatMap::create(uint32_t capacity) {
+    capacity = std::clamp(capacity, 1u, MAX_CAPACITY);
+
+    return visitSeatMapType(capacity, [capacity](auto type) -> std::unique_ptr<SeatMap> {
+        using Map = typename decltype(type)::type;
+        if constexpr (std::is_same_v<Map, WideSeatBitmask>) {
+            return std::make_unique<Map>(capacity);
+        } else {
+            return std::make_unique<Map>();
+        }
+    });
+}
+
+SeatMap* SeatMap::create(uint32_t capacity, SeatArena& arena, SeatArena::Tier tier) {
+    capacity = std::clamp(capacity, 1u, MAX_CAPACITY);
+
+    return visitSeatMapType(capacity, [&](auto type) -> SeatMap* {
+        using Map = typename decltype(type)::type;
+        void* block = arena.allocate(sizeof(Map), alignof(Map), tier);
+        return block ? construct<Map>(block, capacity) : nullptr;
+    });
+}
+
+SeatMap* SeatMap::relocate(const SeatMap& seats, SeatArena& arena, SeatArena::Tier tier) {
+    SeatMap* copy = create(seats.getCapacity(), arena, tier);
+    if (!copy) {
+        return nullptr;
+    }
+
+    // Empty copy, so both claims succeed: confirmed seats, then held ones
+    std::array<uint64_t, MAX_WORDS> booked{};
+    std::array<uint64_t, MAX_WORDS> held{};
+    uint32_t wordCount = seats.getWordCount();
+    for (uint32_t i = 0; i < wordCount; ++i) {
+        held[i] = seats.getHeldWord(i);
+        booked[i] = seats.getOccupiedWord(i) & ~held[i];
+    }
+    copy->tryBook(std::span<const uint64_t>(booked.data(), wordCount), ClaimOptions{});
+    copy->tryHold(std::span<const uint64_t>(held.data(), wordCount), ClaimOptions{});
+    return copy;
+}
+
+void SeatMap::destroy(SeatMap* seats, SeatArena& arena, SeatArena::Tier tier) {
+    if (!seats) {
+        return;
+    }
+    visitSeatMapType(seats->getCapacity(), [&](auto type) {
+        using Map = typename decltype(type)::type;
+        Map* map = static_cast<Map*>(seats);
+        map->~Map();
+        arena.deallocate(map, sizeof(Map), alignof(Map), tier);
+    });
+}
+
+namespace {
+    // One loop: parse, validate and set each seat's bit
+    template <typename SeatIds>
+    bool addSeatIds(const SeatIds& seatIds, uint32_t capacity, std::span<uint64_t> mask) {
+        for (const auto& seatId : seatIds) {
+            int bit = SeatMap::seatIdToBit(seatId, capacity);
+            if (bit < 0) {
+                return false;
+            }
+            mask[bit / 64] |= (uint64_t{1} << (bit % 64));
+        }
+        return true;
+    }
+}
+
+std::vector<uint64_t> SeatMap::createMask(const std::vector<std::string>& seatIds) const {
+    std::vector<uint64_t> mask(getWordCount(), 0);
+    uint32_t capacity = getCapacity();
+
+    for (const auto& seatId : seatIds) {
+        int bit = seatIdToBit(seatId, capacity);
+        if (bit >= 0) {
+            mask[bit / 64] |= (uint64_t{1} << (bit % 64));
+        }
+    }
+
+    return mask;
+}
+
+bool SeatMap::buildMask(std::span<const std::string_view> seatIds, std::span<uint64_t> mask) const {
+    return mask.size() >= getWordCount() && addSeatIds(seatIds, getCapacity(), mask);
+}
+
+bool SeatMap::buildMask(std::span<const std::string> seatIds, std::span<uint64_t> mask) const {
+    return mask.size() >= getWordCount() && addSeatIds(seatIds, getCapacity(), mask);
+}
+
+bool SeatMap::buildMask(std::span<const uint16_t> seatIndexes, std::span<uint64_t> mask) const {
+    if (mask.size() < getWordCount()) {
+        return false;
+    }
+    uint32_t capacity = getCapacity();
+    for (uint16_t seat : seatIndexes) {
+        if (seat >= capacity) {
+            return false;
+        }
+        mask[seat / 64] |= (uint64_t{1} << (seat % 64));
+    }
+    return true;
+}
+
+std::vector<std::string> SeatMap::getAvailableSeats() const {
+    std::vector<std::string> available;
+    available.reserve(getAvailableCount());
+
+    forEachAvailable([&available](uint32_t seat) {
+        char label[MAX_SEAT_ID_LENGTH];
+        available.emplace_back(label, formatSeatId(seat, label));
+    });
+
+    return available;
+}
+
+uint32_t SeatMap::loadFreeWords(std::span<uint64_t> out) const {
+    uint32_t capacity = getCapacity();
+    uint32_t wordCount = getWordCount();
+    for (uint32_t i = 0; i < wordCount; ++i) {
+        uint32_t remaining = capacity - i * 64;
+        uint64_t valid = remaining >= 64 ? ~uint64_t{0} : (uint64_t{1} << remaining) - 1;
+        out[i] = ~getOccupiedWord(i) & valid;
+    }
+    return wordCount;
+}
+
+void SeatMap::keepRunStarts(std::span<uint64_t> bits, uint32_t count) {
+    size_t wordCount = bits.size() - 1;
+
+    // Grow run length len -> len + step; bits[i + 1] is still the previous
+    // step's value when bits[i] reads it, so one ascending pass per step
+    for (uint32_t len = 1; len < count;) {
+        uint32_t step = std::min(len, count - len);
+        for (size_t i = 0; i < wordCount; ++i) {
+            bits[i] &= (bits[i] >> step) | (bits[i + 1] << (64 - step));
+        }
+        len += step;
+    }
+}
+
+int SeatMap::findFreeRun(uint32_t count, uint32_t from) const {
+    uint32_t capacity = getCapacity();
+    if (count == 0 || count > 64 || count > capacity || from >= capacity) {
+        return -1;
+    }
+
+    // Free bits; the extra zero word ends runs at the last word
+    std::array<uint64_t, MAX_WORDS + 1> run{};
+    uint32_t wordCount = loadFreeWords(run);
+    keepRunStarts(std::span<uint64_t>(run.data(), wordCount + 1), count);
+
+    for (uint32_t i = from / 64; i < wordCount; ++i) {
+        uint64_t candidates = run[i];
+        if (i == from / 64) {
+            candidates &= ~uint64_t{0} << (from % 64);
+        }
+        if (candidates != 0) {
+            return static_cast<int>(i * 64 + std::countr_zero(candidates));
+        }
+    }
+    return -1;
+}
+
+size_t SeatMap::formatAvailableSeats(std::span<char> buffer) const {
+    SeatLabelWriter writer(buffer);
+    forEachAvailable([&writer](uint32_t seat) { return writer.append(seat); });
+    return writer.size();
+}
@@ -0,0 +1,79 @@
+#include "SeatSelector.h"
+#include <array>
+#include <bit>
+
+namespace {
+    bool isSet(const std::array<uint64_t, SeatMap::MAX_WORDS + 1>& bits, uint32_t seat) {
+        return (bits[seat / 64] >> (seat % 64)) & 1;
+    }
+
+    // Keeps out sorted best-first; strict > keeps the lower seat on ties
+    size_t insertCandidate(std::span<SeatChoice> out, size_t size, SeatChoice choice) {
+        if (size == out.size() && choice.score <= out[size - 1].score) {
+            return size;
+        }
+        size_t pos = size < out.size() ? size : size - 1;
+        while (pos > 0 && choice.score > out[pos - 1].score) {
+            out[pos] = out[pos - 1];
+            --pos;
+        }
+        out[pos] = choice;
+        return size < out.size() ? size + 1 : size;
+    }
+}
+
+size_t SeatSelector::rank(const SeatMap& seats, uint32_t count, std::span<SeatChoice> out) const {
+    uint32_t capacity = layout_.getCapacity();
+    if (out.empty() || count == 0 || count > 64 || count > capacity ||
+        seats.getCapacity() != capacity) {
+        return 0;
+    }
+
+    // Free bits (one snapshot) and the starts of free runs of `count` seats
+    std::array<uint64_t, SeatMap::MAX_WORDS + 1> free{};
+    uint32_t wordCount = seats.loadFreeWords(free);
+    std::array<uint64_t, SeatMap::MAX_WORDS + 1> starts = free;
+    SeatMap::keepRunStarts(std::span<uint64_t>(starts.data(), wordCount + 1), count);
+
+    size_t size = 0;
+    for (const SeatLayout::Row& row : layout_.getRows()) {
+        if (row.length < count) {
+            continue;
+        }
+        uint32_t rowEnd = row.firstSeat + row.length;
+        uint32_t lastStart = rowEnd - count;
+
+        // Candidate starts inside this row, one word at a time
+        for (uint32_t w = row.firstSeat / 64; w <= lastStart / 64; ++w) {
+            uint64_t candidates = starts[w];
+            if (w == row.firstSeat / 64) {
+                candidates &= ~uint64_t{0} << (row.firstSeat % 64);
+            }
+            if (w == lastStart / 64 && lastStart % 64 != 63) {
+                candidates &= (uint64_t{2} << (lastStart % 64)) - 1;
+            }
+
+            for (; candidates != 0; candidates &= candidates - 1) {
+                uint32_t start = w * 64 + static_cast<uint32_t>(std::countr_zero(candidates));
+                uint32_t end = start + count;  // First seat after the block
+
+                int64_t score = layout_.getBlockScore(start, count);
+
+                // A lone free seat left between the block and the row edge
+                // or an occupied seat is hard to sell later
+                if (start > row.firstSeat && isSet(free, start - 1) &&
+                    (start - 1 == row.firstSeat || !isSet(free, start - 2))) {
+                    score -= orphanPenalty_;
+                }
+                if (end < rowEnd && isSet(free, end) &&
+                    (end + 1 == rowEnd || !isSet(free, end + 1))) {
+                    score -= orphanPenalty_;
+                }
+
+                size = insertCandidate(out, size, SeatChoice{static_cast<int32_t>(start), score});
+            }
+        }
+    }
+
+    return size;
+}
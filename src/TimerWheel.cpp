@@ -0,0 +1,46 @@
+#include "TimerWheel.h"
+
+void TimerWheel::schedule(uint64_t id, uint64_t deadlineTick) {
+    place({id, deadlineTick}, deadlineTick > currentTick_ ? deadlineTick : currentTick_ + 1);
+}
+
+void TimerWheel::place(const Timer& timer, uint64_t due) {
+    uint64_t delta = due - currentTick_;
+    ++size_;
+
+    // Coarsest level needed: level L covers distances below SLOTS^(L+1)
+    for (uint32_t level = 0; level < LEVELS; ++level) {
+        uint32_t shift = SLOT_BITS * level;
+        if (delta < (uint64_t{1} << (shift + SLOT_BITS))) {
+            slots_[level][(due >> shift) & (SLOTS - 1)].push_back(timer);
+            return;
+        }
+    }
+
+    // Out of range: park in the top-level bucket cascaded last
+    uint32_t topShift = SLOT_BITS * (LEVELS - 1);
+    slots_[LEVELS - 1][((currentTick_ >> topShift) - 1) & (SLOTS - 1)].push_back(timer);
+}
+
+void TimerWheel::cascade() {
+    // Top-down, so timers moved from level L+1 into level L this tick
+    // are seen when level L's bucket is cascaded
+    for (uint32_t level = LEVELS - 1; level > 0; --level) {
+        uint32_t shift = SLOT_BITS * level;
+        if ((currentTick_ & ((uint64_t{1} << shift) - 1)) != 0) {
+            continue;
+        }
+
+        std::vector<Timer>& bucket = slots_[level][(currentTick_ >> shift) & (SLOTS - 1)];
+        if (bucket.empty()) {
+            continue;
+        }
+        scratch_.swap(bucket);
+        // Timers due this very tick land in the level 0 bucket fired next
+        for (const Timer& timer : scratch_) {
+            --size_;
+            place(timer, timer.deadline > currentTick_ ? timer.deadline : currentTick_);
+        }
+        scratch_.clear();
+    }
+}
@@ -0,0 +1,77 @@
+#include "WideSeatBitmask.h"
+#include "SeatWordOps.h"
+#include <algorithm>
+
+WideSeatBitmask::WideSeatBitmask(uint32_t capacity)
+    : capacity_(std::clamp(capacity, 1u, MAX_CAPACITY)),
+      wordCount_(wordsFor(capacity_)),
+      lines_(std::make_unique<WordLine[]>((wordCount_ + WORDS_PER_LINE - 1) / WORDS_PER_LINE)),
+      heldLines_(std::make_unique<WordLine[]>((wordCount_ + WORDS_PER_LINE - 1) / WORDS_PER_LINE)) {
+}
+
+bool WideSeatBitmask::tryBook(std::span<const uint64_t> seatMask, const ClaimOptions& options) {
+    auto view = words();
+
+    if (!seat_ops::isValidMask(view, capacity_, seatMask)) {
+        return false;
+    }
+
+    return seat_ops::tryBook(view, seatMask, options);
+}
+
+void WideSeatBitmask::release(std::span<const uint64_t> seatMask) {
+    auto view = words();
+    if (seat_ops::isValidMask(view, capacity_, seatMask)) {
+        seat_ops::clearBits(view, seatMask);
+    }
+}
+
+bool WideSeatBitmask::tryMove(std::span<const uint64_t> release, std::span<const uint64_t> claim,
+                              const ClaimOptions& options) {
+    auto view = words();
+
+    if (!seat_ops::isValidMask(view, capacity_, release) ||
+        !seat_ops::isValidMask(view, capacity_, claim)) {
+        return false;
+    }
+
+    return seat_ops::tryMove(view, release, claim, options);
+}
+
+bool WideSeatBitmask::tryHold(std::span<const uint64_t> seatMask, const ClaimOptions& options) {
+    if (!tryBook(seatMask, options)) {
+        return false;
+    }
+    // Held bits follow the claim, as in FixedSeatBitmask (see SeatMap::tryHold)
+    auto heldView = held();
+    seat_ops::setBits(heldView, seatMask);
+    return true;
+}
+
+void WideSeatBitmask::confirmHeld(std::span<const uint64_t> seatMask) {
+    if (seat_ops::isValidMask(words(), capacity_, seatMask)) {
+        auto heldView = held();
+        seat_ops::clearBits(heldView, seatMask);
+    }
+}
+
+void WideSeatBitmask::releaseHeld(std::span<const uint64_t> seatMask) {
+    auto view = words();
+    if (seat_ops::isValidMask(view, capacity_, seatMask)) {
+        auto heldView = held();
+        seat_ops::clearBits(heldView, seatMask);
+        seat_ops::clearBits(view, seatMask);
+    }
+}
+
+bool WideSeatBitmask::areAvailable(std::span<const uint64_t> seatMask) const {
+    return seat_ops::areAvailable(words(), seatMask);
+}
+
+uint32_t WideSeatBitmask::getAvailableCount() const {
+    return capacity_ - seat_ops::occupiedCount(words(), capacity_);
+}
+
+uint32_t WideSeatBitmask::getHeldCount() const {
+    return seat_ops::occupiedCount(held(), capacity_);
+}
@@ -64,7 +64,8 @@ private:
         std::cout << "4. Book seats \n";
         std::cout << "5. View booking details\n";
         std::cout << "6. View occupancy statistics\n";
-        std::cout << "7. Exit\n";
+        std::cout << "7. Cancel booking\n";
+        std::cout << "8. Exit\n";
         std::cout << "\nEnter choice: ";
     }
     
@@ -101,6 +102,9 @@ private:
                 viewOccupancyStats();
                 break;
             case 7:
+                cancelBooking();
+                break;
+            case 8:
                 running_ = false;
                 std::cout << "\nThank you for using the booking system!\n";
                 break;
@@ -218,9 +222,10 @@ private:
             std::cout << "\n✓ Booking successful! (Lock-Free)\n";
             std::cout << "Booking ID: " << booking->bookingId << "\n";
             std::cout << "Seats booked: ";
-            for (size_t i = 0; i < booking->seats.size(); ++i) {
-                std::cout << booking->seats[i];
-                if (i < booking->seats.size() - 1) {
+            auto bookedSeats = booking->seatIds();
+            for (size_t i = 0; i < bookedSeats.size(); ++i) {
+                std::cout << bookedSeats[i];
+                if (i < bookedSeats.size() - 1) {
                     std::cout << ", ";
                 }
             }
@@ -247,15 +252,28 @@ private:
         std::cout << "Movie ID: " << booking->movieId << "\n";
         std::cout << "Theater ID: " << booking->theaterId << "\n";
         std::cout << "Seats: ";
-        for (size_t i = 0; i < booking->seats.size(); ++i) {
-            std::cout << booking->seats[i];
-            if (i < booking->seats.size() - 1) {
+        auto bookedSeats = booking->seatIds();
+        for (size_t i = 0; i < bookedSeats.size(); ++i) {
+            std::cout << bookedSeats[i];
+            if (i < bookedSeats.size() - 1) {
                 std::cout << ", ";
             }
         }
         std::cout << "\n";
     }
     
+    void cancelBooking() {
+        std::cout << "\nEnter Booking ID: ";
+        uint64_t bookingId;
+        std::cin >> bookingId;
+        
+        if (service_.cancelBooking(bookingId)) {
+            std::cout << "\n✓ Booking " << bookingId << " cancelled, seats released.\n";
+        } else {
+            std::cout << "Booking not found or already cancelled!\n";
+        }
+    }
+    
     void viewOccupancyStats() {
         std::cout << "\nEnter Movie ID: ";
         uint32_t movieId;
@@ -265,12 +283,13 @@ private:
         uint32_t theaterId;
         std::cin >> theaterId;
         
+        uint32_t capacity = service_.getCapacity(movieId, theaterId);
         uint32_t available = service_.getAvailableCount(movieId, theaterId);
         double occupancy = service_.getOccupancyPercentage(movieId, theaterId);
         
         std::cout << "\n--- Statistics ---\n";
-        std::cout << "Available seats: " << available << " / 20\n";
-        std::cout << "Occupied seats: " << (20 - available) << " / 20\n";
+        std::cout << "Available seats: " << available << " / " << capacity << "\n";
+        std::cout << "Occupied seats: " << (capacity - available) << " / " << capacity << "\n";
         std::cout << "Occupancy: " << occupancy << "%\n";
     }
 };
@@ -0,0 +1,1328 @@
+#include "BookingService.h"
+#include "BookingLog.h"
+#include "BookingSnapshot.h"
+#include "Checksum.h"
+#include <iostream>
+#include <fstream>
+#include <filesystem>
+#include <thread>
+#include <vector>
+#include <chrono>
+#include <atomic>
+#include <iomanip>
+#include <algorithm>
+#include <cstddef>
+#include <csignal>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+// ============================================================================
+// DURABILITY TESTS - Write-Ahead Log and Snapshots
+// ============================================================================
+
+class DurabilityTests {
+public:
+    static int passed;
+    static int failed;
+
+    static void assertTrue(bool condition, const std::string& msg) {
+        if (condition) {
+            std::cout << "  ✓ " << msg << "\n";
+            passed++;
+        } else {
+            std::cerr << "  ✗ FAILED: " << msg << "\n";
+            failed++;
+        }
+    }
+
+    static void assertEqual(int expected, int actual, const std::string& msg) {
+        if (expected == actual) {
+            std::cout << "  ✓ " << msg << "\n";
+            passed++;
+        } else {
+            std::cerr << "  ✗ FAILED: " << msg << " (expected: " << expected
+                      << ", got: " << actual << ")\n";
+            failed++;
+        }
+    }
+};
+
+int DurabilityTests::passed = 0;
+int DurabilityTests::failed = 0;
+
+// Fresh file in the temp directory, removed again by the caller
+std::string tempPath(const std::string& name) {
+    auto path = std::filesystem::temp_directory_path() / ("booking_durability_" + name);
+    std::filesystem::remove(path);
+    return path.string();
+}
+
+std::vector<LogRecord> readLog(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    std::vector<LogRecord> records;
+    LogRecord record;
+    while (in.read(reinterpret_cast<char*>(&record), sizeof(record))) {
+        records.push_back(record);
+    }
+    return records;
+}
+
+BookingServiceConfig logConfig(Durability durability, const std::string& path) {
+    BookingServiceConfig config;
+    config.durability = durability;
+    config.logPath = path;
+    return config;
+}
+
+void addShows(BookingService& service, uint32_t movies, uint32_t capacity) {
+    service.addTheater(Theater(1, "Theater", capacity));
+    for (uint32_t m = 1; m <= movies; m++) {
+        service.addMovie(Movie(m, "Movie " + std::to_string(m)));
+        service.linkMovieToTheater(m, 1);
+    }
+}
+
+// Runs `work` in a child process that then exits without cleanup: a service
+// `work` leaves alive (never destroyed) loses its log flusher with whatever
+// is still staged, as in a crash
+template <typename Work>
+bool runThenCrash(Work work) {
+    std::cout.flush();
+    pid_t pid = ::fork();
+    if (pid == 0) {
+        ::_exit(work() ? 0 : 1);
+    }
+    int status = 0;
+    return pid > 0 && ::waitpid(pid, &status, 0) == pid && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+// ============================================================================
+// TEST 1: Every change is logged, in causal order
+// ============================================================================
+
+void testLogRecordsEveryChange() {
+    std::cout << "\n=== TEST 1: Log Records Every Change ===\n";
+
+    std::string path = tempPath("changes.wal");
+    uint64_t first = 0;
+    uint64_t second = 0;
+    uint64_t exchanged = 0;
+    {
+        BookingService service(logConfig(Durability::Async, path));
+        addShows(service, 1, 20);
+        DurabilityTests::assertTrue(service.getLog() != nullptr, "Log opened");
+
+        first = service.bookSeats(1, 1, {"a1", "a2"})->bookingId;
+        second = service.bookSeats(1, 1, {"a3"})->bookingId;
+        service.cancelBooking(second);
+        exchanged = service.exchange(first, 1, 1, {"a2", "a4"})->bookingId;
+    }  // Destruction writes and syncs the rest
+
+    auto records = readLog(path);
+    DurabilityTests::assertEqual(5, static_cast<int>(records.size()), "Five records written");
+
+    bool dense = true;
+    for (size_t i = 0; i < records.size(); i++) {
+        dense = dense && records[i].lsn == i + 1;
+    }
+    DurabilityTests::assertTrue(dense, "LSNs are dense from 1");
+
+    if (records.size() == 5) {
+        using Type = LogRecord::Type;
+        DurabilityTests::assertTrue(records[0].type == Type::Book && records[0].bookingId == first &&
+                                    records[0].seatCount == 2 && records[0].seats[1] == 1,
+                                    "Book a1,a2");
+        DurabilityTests::assertTrue(records[2].type == Type::Cancel && records[2].bookingId == second &&
+                                    records[2].seatCount == 1 && records[2].seats[0] == 2,
+                                    "Cancel frees a3");
+        DurabilityTests::assertTrue(records[3].type == Type::Exchange && records[3].bookingId == exchanged,
+                                    "Exchange books the replacement first");
+        DurabilityTests::assertTrue(records[4].type == Type::Cancel && records[4].bookingId == first &&
+                                    records[4].seatCount == 1 && records[4].seats[0] == 0,
+                                    "Then cancels the original, freeing only a1 (a2 is kept)");
+    }
+
+    std::filesystem::remove(path);
+}
+
+// ============================================================================
+// TEST 2: GroupSync returns only once the record is on disk
+// ============================================================================
+
+void testGroupSyncWaitsForDisk() {
+    std::cout << "\n=== TEST 2: GroupSync Waits For Disk ===\n";
+
+    const int THREADS = 8;
+    const int BOOKINGS_PER_THREAD = 25;
+    std::string path = tempPath("groupsync.wal");
+
+    BookingServiceConfig config = logConfig(Durability::GroupSync, path);
+    config.groupCommitWindow = std::chrono::milliseconds(2);
+    BookingService service(config);
+    addShows(service, THREADS, 64);
+
+    // One thread: its k-th booking is lsn k
+    bool durable = true;
+    for (int k = 1; k <= 5; k++) {
+        service.bookSeats(1, 1, {"a" + std::to_string(k)});
+        durable = durable && service.getLog()->getDurableLsn() >= static_cast<uint64_t>(k);
+    }
+    DurabilityTests::assertTrue(durable, "Each booking durable when bookSeats returns");
+
+    uint64_t flushesBefore = service.getLog()->getFlushCount();
+    std::vector<std::thread> threads;
+    std::atomic<int> booked{0};
+    for (int t = 0; t < THREADS; t++) {
+        threads.emplace_back([&, t]() {
+            for (int i = 0; i < BOOKINGS_PER_THREAD; i++) {
+                uint32_t movie = static_cast<uint32_t>(t + 1);
+                std::string seat = "a" + std::to_string(i + 10);
+                booked += service.bookSeats(movie, 1, {seat}) != nullptr;
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    uint64_t flushes = service.getLog()->getFlushCount() - flushesBefore;
+    std::cout << "  " << booked.load() << " bookings in " << flushes << " write+fdatasync rounds\n";
+
+    DurabilityTests::assertEqual(THREADS * BOOKINGS_PER_THREAD, booked.load(), "All bookings made");
+    DurabilityTests::assertTrue(flushes < static_cast<uint64_t>(booked.load()),
+                                "Concurrent bookings share commits");
+    DurabilityTests::assertEqual(5 + THREADS * BOOKINGS_PER_THREAD,
+                                 static_cast<int>(readLog(path).size()),
+                                 "Every returned booking already in the file");
+    DurabilityTests::assertTrue(!service.getLog()->hasFailed(), "Log healthy");
+
+    std::filesystem::remove(path);
+}
+
+// ============================================================================
+// TEST 3: Reopening a log appends after its last whole record
+// ============================================================================
+
+void testLogReopen() {
+    std::cout << "\n=== TEST 3: Log Reopen ===\n";
+
+    std::string path = tempPath("reopen.wal");
+    {
+        BookingService service(logConfig(Durability::Async, path));
+        addShows(service, 1, 20);
+        service.bookSeats(1, 1, {"a1"});
+        service.bookSeats(1, 1, {"a2"});
+    }
+
+    // A torn record at the end, as left by a crash mid-write
+    {
+        std::ofstream out(path, std::ios::binary | std::ios::app);
+        out.write("torn", 4);
+    }
+
+    {
+        BookingService service(logConfig(Durability::Async, path));
+        addShows(service, 1, 20);
+        service.bookSeats(1, 1, {"a5"});
+    }
+
+    auto records = readLog(path);
+    DurabilityTests::assertEqual(3, static_cast<int>(records.size()), "Torn tail dropped, new record appended");
+    DurabilityTests::assertTrue(std::filesystem::file_size(path) == 3 * sizeof(LogRecord),
+                                "File holds whole records only");
+    if (records.size() == 3) {
+        DurabilityTests::assertTrue(records[2].lsn == 3 && records[2].seats[0] == 4,
+                                    "LSNs continue after the old records");
+    }
+
+    BookingServiceConfig config = logConfig(Durability::Async, "/nonexistent-dir/booking.wal");
+    BookingService noLog(config);
+    DurabilityTests::assertTrue(noLog.getLog() == nullptr && noLog.hasLogFailed(),
+                                "Unopenable path reported by hasLogFailed");
+
+    config.durability = Durability::GroupSync;
+    BookingService noSyncLog(config);
+    addShows(noSyncLog, 1, 20);
+    DurabilityTests::assertTrue(noSyncLog.bookSeats(1, 1, {"a1"}) == nullptr &&
+                                noSyncLog.getAvailableCount(1, 1) == 20,
+                                "GroupSync without a log refuses bookings");
+
+    // Every write fails (ENOSPC): GroupSync calls fail and take their bookings back
+    if (std::filesystem::exists("/dev/full")) {
+        BookingService fullLog(logConfig(Durability::GroupSync, "/dev/full"));
+        addShows(fullLog, 1, 20);
+        const Booking* booking = fullLog.bookSeats(1, 1, {"a1", "a2"});
+        DurabilityTests::assertTrue(booking == nullptr && fullLog.hasLogFailed(),
+                                    "Booking whose record cannot be written fails");
+        DurabilityTests::assertEqual(20, static_cast<int>(fullLog.getAvailableCount(1, 1)),
+                                     "Its seats are free again");
+
+        std::vector<BookingRequest> batch = {{1, 1, {"a3"}}, {1, 1, {"a4"}}};
+        auto results = fullLog.bookBatch(batch);
+        DurabilityTests::assertTrue(results[0].status == BookingResult::Status::NotDurable &&
+                                    results[1].status == BookingResult::Status::NotDurable,
+                                    "Batch items reported NotDurable");
+        DurabilityTests::assertTrue(fullLog.bookAdjacent(1, 1, 2) == nullptr &&
+                                    fullLog.getAvailableCount(1, 1) == 20,
+                                    "Later changes refused");
+    }
+
+    // The log fails while a cancel or exchange waits for its sync (file
+    // size limit: one record fits): the change is undone. In a child
+    // process, which the limit must not outlive.
+    auto failsAfterOneRecord = [&](auto change) {
+        std::filesystem::remove(path);
+        return runThenCrash([&]() {
+            ::signal(SIGXFSZ, SIG_IGN);
+            rlimit limit{sizeof(LogRecord), sizeof(LogRecord)};
+            ::setrlimit(RLIMIT_FSIZE, &limit);
+            BookingService* service = new BookingService(logConfig(Durability::GroupSync, path));  // Never destroyed
+            addShows(*service, 1, 20);
+            const Booking* booking = service->bookSeats(1, 1, {"a1", "a2"});
+            return booking && change(*service, booking->bookingId) &&
+                   service->getBookingStatus(booking->bookingId) == BookingStatus::Active &&
+                   service->getAvailableCount(1, 1) == 18;
+        });
+    };
+    DurabilityTests::assertTrue(failsAfterOneRecord([](BookingService& service, uint64_t id) {
+                                    return !service.cancelBooking(id);
+                                }),
+                                "Cancel that never reaches disk fails, booking active with its seats");
+    DurabilityTests::assertTrue(failsAfterOneRecord([](BookingService& service, uint64_t id) {
+                                    return service.exchange(id, 1, 1, {"a5"}) == nullptr;
+                                }),
+                                "Exchange that never reaches disk is undone, new seat free again");
+
+    std::filesystem::remove(path);
+}
+
+// ============================================================================
+// TEST 4: Concurrent appends through a small ring
+// ============================================================================
+
+void testConcurrentAppends() {
+    std::cout << "\n=== TEST 4: Concurrent Appends ===\n";
+
+    const int THREADS = 4;
+    const int PER_THREAD = 5000;
+    std::string path = tempPath("ring.wal");
+
+    {
+        // 64 slots: producers lap the flusher and wait for free slots
+        BookingLog::Options options;
+        options.groupCommitWindow = std::chrono::microseconds(100);
+        options.ringCapacity = 64;
+        auto log = BookingLog::open(path, options);
+
+        std::vector<std::thread> threads;
+        for (int t = 0; t < THREADS; t++) {
+            threads.emplace_back([&, t]() {
+                for (int i = 0; i < PER_THREAD; i++) {
+                    LogRecord record;
+                    record.movieId = static_cast<uint32_t>(t);
+                    record.bookingId = static_cast<uint64_t>(i);
+                    log->append(record);
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+    }
+
+    auto records = readLog(path);
+    DurabilityTests::assertEqual(THREADS * PER_THREAD, static_cast<int>(records.size()), "Every record written");
+
+    bool dense = true;
+    std::vector<uint64_t> nextPerThread(THREADS, 0);
+    bool ordered = true;
+    for (size_t i = 0; i < records.size(); i++) {
+        dense = dense && records[i].lsn == i + 1;
+        uint32_t t = records[i].movieId;
+        ordered = ordered && t < THREADS && records[i].bookingId == nextPerThread[t]++;
+    }
+    DurabilityTests::assertTrue(dense, "LSNs dense and in file order");
+    DurabilityTests::assertTrue(ordered, "Each thread's records in its append order, none lost");
+
+    std::filesystem::remove(path);
+}
+
+// ============================================================================
+// TEST 5: Booking throughput per durability mode
+// ============================================================================
+
+void testDurabilityThroughput() {
+    std::cout << "\n=== TEST 5: Bookings/sec per Durability Mode ===\n";
+
+    const int THREADS = 8;
+    const uint32_t SHOWS_PER_THREAD = 64;
+    const uint32_t CAPACITY = 1024;
+    const auto DURATION = std::chrono::milliseconds(300);
+    std::string path = tempPath("throughput.wal");
+
+    struct Mode {
+        Durability durability;
+        const char* name;
+    };
+    const Mode modes[] = {
+        {Durability::None, "None     "},
+        {Durability::Async, "Async    "},
+        {Durability::GroupSync, "GroupSync"},
+    };
+
+    double noneRate = 0;
+    double asyncRate = 0;
+    for (const Mode& mode : modes) {
+        std::filesystem::remove(path);
+        BookingService service(logConfig(mode.durability, path));
+        addShows(service, THREADS * SHOWS_PER_THREAD, CAPACITY);
+
+        std::vector<std::vector<ShowHandle>> shows(THREADS);
+        for (uint32_t t = 0; t < THREADS; t++) {
+            for (uint32_t s = 0; s < SHOWS_PER_THREAD; s++) {
+                shows[t].push_back(service.resolveShow(t * SHOWS_PER_THREAD + s + 1, 1));
+            }
+        }
+
+        std::atomic<bool> stop{false};
+        std::atomic<uint64_t> booked{0};
+        std::vector<std::thread> threads;
+        auto start = std::chrono::steady_clock::now();
+        for (int t = 0; t < THREADS; t++) {
+            threads.emplace_back([&, t]() {
+                uint64_t count = 0;
+                for (uint32_t s = 0; s < SHOWS_PER_THREAD && !stop.load(std::memory_order_relaxed); s++) {
+                    for (uint16_t seat = 0; seat < CAPACITY && !stop.load(std::memory_order_relaxed); seat++) {
+                        uint16_t seats[] = {seat};
+                        count += service.bookSeats(shows[t][s], std::span<const uint16_t>(seats)) != nullptr;
+                    }
+                }
+                booked += count;
+            });
+        }
+        std::this_thread::sleep_for(DURATION);
+        stop = true;
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        double rate = booked.load() / seconds;
+
+        std::cout << "  " << mode.name << ": " << std::fixed << std::setprecision(0) << rate
+                  << " bookings/sec";
+        if (const BookingLog* log = service.getLog()) {
+            std::cout << " (" << log->getFlushCount() << " group commits, "
+                      << std::setprecision(1) << static_cast<double>(booked.load()) / std::max<uint64_t>(log->getFlushCount(), 1)
+                      << " bookings each)";
+        }
+        std::cout << "\n";
+
+        if (mode.durability == Durability::None) {
+            noneRate = rate;
+        } else if (mode.durability == Durability::Async) {
+            asyncRate = rate;
+        }
+        DurabilityTests::assertTrue(booked.load() > 0, std::string(mode.name) + " made bookings");
+    }
+
+    // The booking path only stages a record; the disk is the flusher's problem
+    DurabilityTests::assertTrue(asyncRate > noneRate / 10, "Async keeps the same order of throughput as None");
+
+    std::filesystem::remove(path);
+}
+
+// ============================================================================
+// TEST 6: Snapshot round trip
+// ============================================================================
+
+void testSnapshotRoundTrip() {
+    std::cout << "\n=== TEST 6: Snapshot Round Trip ===\n";
+
+    // Known CRC-32C check value
+    const char digits[] = "123456789";
+    DurabilityTests::assertTrue(crc32c(digits, 9) == 0xE3069283, "CRC-32C check value");
+    DurabilityTests::assertTrue(crc32c(digits + 4, 5, crc32c(digits, 4)) == 0xE3069283, "CRC-32C chains");
+
+    std::string path = tempPath("roundtrip.snap");
+    uint64_t kept = 0;
+    uint64_t cancelled = 0;
+    uint64_t lastId = 0;
+    ShowHandle savedShow;
+    {
+        BookingService service;
+        service.addTheater(Theater(1, "Grand", 100,
+                                   std::make_shared<SeatLayout>(SeatLayout::uniform(10, 10))));
+        service.addTheater(Theater(2, "Studio"));
+        service.addMovie(Movie(1, "First"));
+        service.addMovie(Movie(2, "Second"));
+        service.linkMovieToTheater(1, 1);
+        service.linkMovieToTheater(1, 2);
+        service.linkMovieToTheater(2, 2);
+
+        savedShow = service.resolveShow(2, 2);
+        kept = service.bookSeats(1, 1, {"a1", "a70"})->bookingId;
+        cancelled = service.bookSeats(2, 2, {"a3"})->bookingId;
+        service.cancelBooking(cancelled);
+        lastId = service.bookSeats(2, 2, {"a4", "a5"})->bookingId;
+        service.holdSeats(2, 2, {"a10"}, std::chrono::seconds(60));
+
+        SnapshotInfo info = service.saveSnapshot(path);
+        DurabilityTests::assertTrue(info.ok(), "Snapshot written");
+        DurabilityTests::assertEqual(2, static_cast<int>(info.showCount), "Two shows saved");
+        DurabilityTests::assertEqual(3, static_cast<int>(info.bookingCount), "Three bookings saved");
+        DurabilityTests::assertTrue(info.walLsn == 0 && info.bytes == std::filesystem::file_size(path),
+                                    "No log position without a log; size reported");
+    }
+
+    BookingService restored;
+    SnapshotInfo info = restored.loadSnapshot(path);
+    DurabilityTests::assertTrue(info.ok(), "Snapshot loaded");
+
+    auto movies = restored.getAllMovies();
+    DurabilityTests::assertTrue(movies.size() == 2 && movies[0]->title == "First" && movies[1]->title == "Second",
+                                "Movies restored in order");
+    DurabilityTests::assertEqual(2, static_cast<int>(restored.getTheatersForMovie(1).size()), "Links restored");
+    const Theater* grand = restored.getTheater(1);
+    DurabilityTests::assertTrue(grand && grand->name == "Grand" && grand->capacity == 100 && grand->layout &&
+                                grand->layout->getRows().size() == 10,
+                                "Theater and its layout restored");
+
+    DurabilityTests::assertTrue(restored.resolveShow(2, 2).index == savedShow.index, "Show handles preserved");
+    DurabilityTests::assertEqual(98, static_cast<int>(restored.getAvailableCount(1, 1)), "Booked seats restored");
+    DurabilityTests::assertEqual(18, static_cast<int>(restored.getAvailableCount(2, 2)),
+                                 "Cancelled seat free, held seat not saved");
+    DurabilityTests::assertTrue(restored.getBooking(kept) && restored.getBooking(kept)->seatCount == 2,
+                                "Active booking restored");
+    DurabilityTests::assertTrue(restored.getBookingStatus(cancelled) == BookingStatus::Cancelled,
+                                "Cancelled booking stays cancelled");
+    DurabilityTests::assertTrue(restored.cancelBooking(kept) && restored.getAvailableCount(1, 1) == 100,
+                                "Restored booking can be cancelled");
+
+    const Booking* next = restored.bookSeats(2, 2, {"a3"});
+    DurabilityTests::assertTrue(next && next->bookingId > lastId, "New ids continue after the saved ones");
+
+    std::filesystem::remove(path);
+}
+
+// ============================================================================
+// TEST 7: Bad snapshots are rejected
+// ============================================================================
+
+void testSnapshotRejectsBadFiles() {
+    std::cout << "\n=== TEST 7: Bad Snapshots Rejected ===\n";
+
+    std::string path = tempPath("bad.snap");
+    {
+        BookingService service;
+        addShows(service, 4, 20);
+        service.bookSeats(1, 1, {"a1"});
+        service.saveSnapshot(path);
+    }
+
+    using Status = SnapshotInfo::Status;
+    auto patch = [&](size_t offset, char value) {
+        std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+        file.seekp(static_cast<std::streamoff>(offset));
+        file.write(&value, 1);
+    };
+
+    BookingService missing;
+    DurabilityTests::assertTrue(missing.loadSnapshot(tempPath("missing.snap")).status == Status::IoError,
+                                "Missing file: IoError");
+
+    BookingService used;
+    addShows(used, 1, 20);
+    DurabilityTests::assertTrue(used.loadSnapshot(path).status == Status::NotEmpty,
+                                "Service with data: NotEmpty");
+
+    // Flip a byte in the last section, then restore it
+    size_t last = std::filesystem::file_size(path) - 1;
+    patch(last, 0x55);
+    BookingService flipped;
+    DurabilityTests::assertTrue(flipped.loadSnapshot(path).status == Status::Corrupt,
+                                "Flipped byte: Corrupt");
+    DurabilityTests::assertTrue(flipped.getAllMovies().empty(), "Nothing adopted from a corrupt file");
+    patch(last, 0);
+
+    patch(offsetof(SnapshotHeader, version), 99);
+    BookingService newer;
+    DurabilityTests::assertTrue(newer.loadSnapshot(path).status == Status::VersionMismatch,
+                                "Other format version: VersionMismatch");
+
+    std::filesystem::resize_file(path, 16);
+    BookingService truncated;
+    DurabilityTests::assertTrue(truncated.loadSnapshot(path).status == Status::Corrupt,
+                                "Truncated file: Corrupt");
+
+    std::filesystem::remove(path);
+}
+
+// ============================================================================
+// TEST 8: Online snapshot under concurrent bookings and cancels
+// ============================================================================
+
+void testOnlineSnapshot() {
+    std::cout << "\n=== TEST 8: Online Snapshot ===\n";
+
+    const int THREADS = 4;
+    const uint32_t CAPACITY = 256;
+    std::string logPath = tempPath("online.wal");
+    std::string path = tempPath("online.snap");
+
+    SnapshotInfo info;
+    {
+        BookingService service(logConfig(Durability::Async, logPath));
+        addShows(service, THREADS, CAPACITY);
+
+        std::atomic<bool> stop{false};
+        std::vector<std::thread> threads;
+        for (int t = 0; t < THREADS; t++) {
+            threads.emplace_back([&, t]() {
+                ShowHandle show = service.resolveShow(static_cast<uint32_t>(t + 1), 1);
+                for (uint16_t seat = 0; !stop.load(std::memory_order_relaxed); seat = (seat + 1) % CAPACITY) {
+                    uint16_t seats[] = {seat};
+                    const Booking* booking = service.bookSeats(show, std::span<const uint16_t>(seats));
+                    if (booking && seat % 3 == 0) {
+                        service.cancelBooking(booking->bookingId);
+                    }
+                }
+            });
+        }
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        info = service.saveSnapshot(path);
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        stop = true;
+        for (auto& thread : threads) {
+            thread.join();
+        }
+    }
+    DurabilityTests::assertTrue(info.ok() && info.walLsn > 1, "Snapshot taken while booking");
+    std::cout << "  " << info.bookingCount << " bookings saved, log position " << info.walLsn << "\n";
+
+    BookingService restored;
+    DurabilityTests::assertTrue(restored.loadSnapshot(path).ok(), "Online snapshot loads");
+
+    // Everything logged before walLsn is in the snapshot
+    auto records = readLog(logPath);
+    uint64_t maxId = 0;
+    bool complete = true;
+    for (const LogRecord& record : records) {
+        maxId = std::max(maxId, record.bookingId);
+        if (record.lsn >= info.walLsn) {
+            continue;
+        }
+        BookingStatus status = restored.getBookingStatus(record.bookingId);
+        complete = complete && (record.type == LogRecord::Type::Cancel ? status == BookingStatus::Cancelled
+                                                                       : status != BookingStatus::Unknown);
+    }
+    DurabilityTests::assertTrue(complete, "Every change logged before walLsn is in the snapshot");
+
+    // Seat maps agree with the active bookings
+    bool consistent = true;
+    for (uint32_t movie = 1; movie <= THREADS; movie++) {
+        uint32_t active = 0;
+        for (uint64_t id = 1; id <= maxId; id++) {
+            const Booking* booking = restored.getBooking(id);
+            active += booking && booking->movieId == movie ? booking->seatCount : 0;
+        }
+        consistent = consistent && restored.getAvailableCount(movie, 1) == CAPACITY - active;
+    }
+    DurabilityTests::assertTrue(consistent, "Booked seats match the active bookings");
+
+    std::filesystem::remove(logPath);
+    std::filesystem::remove(path);
+}
+
+// ============================================================================
+// TEST 9: Restore time for 100k shows
+// ============================================================================
+
+void testSnapshotRestoreTime() {
+    std::cout << "\n=== TEST 9: Restore 100k Shows ===\n";
+
+    const uint32_t MOVIES = 1000;
+    const uint32_t THEATERS = 100;
+    std::string path = tempPath("large.snap");
+
+    {
+        BookingService service;
+        for (uint32_t t = 1; t <= THEATERS; t++) {
+            service.addTheater(Theater(t, "Theater " + std::to_string(t)));
+        }
+        for (uint32_t m = 1; m <= MOVIES; m++) {
+            service.addMovie(Movie(m, "Movie " + std::to_string(m)));
+            for (uint32_t t = 1; t <= THEATERS; t++) {
+                service.linkMovieToTheater(m, t);
+            }
+        }
+        for (uint32_t m = 1; m <= MOVIES; m++) {
+            for (uint32_t t = 1; t <= THEATERS; t++) {
+                uint16_t seats[] = {static_cast<uint16_t>((m + t) % 20)};
+                service.bookSeats(service.resolveShow(m, t), std::span<const uint16_t>(seats));
+            }
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        SnapshotInfo info = service.saveSnapshot(path);
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        std::cout << "  Saved " << info.showCount << " shows, " << info.bookingCount << " bookings ("
+                  << info.bytes / 1024 << " KiB) in " << std::fixed << std::setprecision(1) << ms << " ms\n";
+    }
+
+    BookingService restored;
+    auto start = std::chrono::steady_clock::now();
+    SnapshotInfo info = restored.loadSnapshot(path);
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "  Restored in " << std::fixed << std::setprecision(1) << ms << " ms\n";
+
+    DurabilityTests::assertTrue(info.ok() && info.showCount == MOVIES * THEATERS, "All shows restored");
+    DurabilityTests::assertEqual(19, static_cast<int>(restored.getAvailableCount(MOVIES, THEATERS)),
+                                 "Seats restored");
+    DurabilityTests::assertTrue(ms < 1000, "Restore takes well under a second");
+
+    std::filesystem::remove(path);
+}
+
+// ============================================================================
+// TEST 10: Crash recovery from snapshot + log tail
+// ============================================================================
+
+void testCrashRecovery() {
+    std::cout << "\n=== TEST 10: Crash Recovery ===\n";
+
+    std::string logPath = tempPath("recovery.wal");
+    std::string snapshotPath = tempPath("recovery.snap");
+    uint64_t beforeSnapshot = 0;
+    uint64_t cancelledAfter = 0;
+    uint64_t exchanged = 0;
+    uint64_t lastId = 0;
+    {
+        BookingService service(logConfig(Durability::Async, logPath));
+        addShows(service, 3, 64);
+        beforeSnapshot = service.bookSeats(1, 1, {"a1", "a2"})->bookingId;
+        uint64_t early = service.bookSeats(1, 1, {"a3"})->bookingId;
+        DurabilityTests::assertTrue(service.saveSnapshot(snapshotPath).ok(), "Snapshot taken mid-run");
+
+        // After the snapshot: only in the log
+        service.cancelBooking(early);
+        cancelledAfter = service.bookSeats(2, 1, {"a10"})->bookingId;
+        service.cancelBooking(cancelledAfter);
+        exchanged = service.exchange(beforeSnapshot, 3, 1, {"a5", "a6", "a7"})->bookingId;
+        lastId = service.bookSeats(2, 1, {"a11", "a12"})->bookingId;
+    }
+
+    // A crash mid-write: one whole record of garbage and part of another
+    {
+        std::ofstream out(logPath, std::ios::binary | std::ios::app);
+        LogRecord stale;
+        stale.lsn = 999;
+        stale.bookingId = 1;
+        out.write(reinterpret_cast<const char*>(&stale), sizeof(stale));
+        out.write("torn", 4);
+    }
+
+    {
+        BookingService restored(logConfig(Durability::Async, logPath));
+        RecoveryInfo info = restored.recover(snapshotPath, 2);
+        std::cout << "  " << info.replayedRecords << " records replayed by " << info.workers << " workers in "
+                  << info.elapsed.count() << " us\n";
+
+        DurabilityTests::assertTrue(info.ok() && info.snapshotLoaded, "Recovered from snapshot and log");
+        DurabilityTests::assertEqual(6, static_cast<int>(info.replayedRecords),
+                                     "Only the tail after walLsn replayed");
+        DurabilityTests::assertEqual(static_cast<int>(sizeof(LogRecord) + 4), static_cast<int>(info.tornBytes),
+                                     "Torn tail detected and dropped");
+
+        DurabilityTests::assertEqual(64, static_cast<int>(restored.getAvailableCount(1, 1)),
+                                     "Show 1: snapshot bookings cancelled and exchanged away");
+        DurabilityTests::assertEqual(62, static_cast<int>(restored.getAvailableCount(2, 1)),
+                                     "Show 2: cancelled booking freed, later one kept");
+        DurabilityTests::assertEqual(61, static_cast<int>(restored.getAvailableCount(3, 1)),
+                                     "Show 3: exchange target booked");
+        DurabilityTests::assertTrue(restored.getBookingStatus(beforeSnapshot) == BookingStatus::Cancelled &&
+                                    restored.getBookingStatus(cancelledAfter) == BookingStatus::Cancelled,
+                                    "Cancels replayed");
+        const Booking* moved = restored.getBooking(exchanged);
+        DurabilityTests::assertTrue(moved && moved->movieId == 3 && moved->seatCount == 3, "Exchange replayed");
+
+        const Booking* next = restored.bookSeats(2, 1, {"a20"});
+        DurabilityTests::assertTrue(next && next->bookingId > lastId, "New ids continue after the log");
+        DurabilityTests::assertTrue(restored.bookSeats(2, 1, {"a11"}) == nullptr, "Replayed seats stay taken");
+        DurabilityTests::assertTrue(restored.getLog() && restored.getLog()->getNextLsn() == 10,
+                                    "Log appends continue after the last intact record");
+    }  // Its new record is written on destruction
+
+    // No snapshot: the whole log on top of the caller's catalog
+    std::filesystem::remove(snapshotPath);
+    BookingService fromLog(logConfig(Durability::Async, logPath));
+    addShows(fromLog, 3, 64);
+    RecoveryInfo full = fromLog.recover(snapshotPath);
+    DurabilityTests::assertTrue(full.ok() && !full.snapshotLoaded && full.replayedRecords == 9 &&
+                                fromLog.getAvailableCount(1, 1) == 64 && fromLog.getAvailableCount(2, 1) == 61 &&
+                                fromLog.getAvailableCount(3, 1) == 61,
+                                "Whole log replayed without a snapshot");
+
+    // A crash between an exchange's two records: neither is replayed
+    std::filesystem::remove(logPath);
+    uint64_t original = 0;
+    {
+        BookingService service(logConfig(Durability::Async, logPath));
+        addShows(service, 2, 64);
+        original = service.bookSeats(1, 1, {"a1", "a2"})->bookingId;
+        service.exchange(original, 2, 1, {"a3"});
+    }
+    std::filesystem::resize_file(logPath, 2 * sizeof(LogRecord));  // Book + Exchange, no Cancel
+    {
+        BookingService restored(logConfig(Durability::Async, logPath));
+        addShows(restored, 2, 64);
+        RecoveryInfo info = restored.recover(snapshotPath);
+        DurabilityTests::assertTrue(info.ok() && info.replayedRecords == 1 &&
+                                    info.tornBytes == sizeof(LogRecord),
+                                    "Exchange without its Cancel dropped as torn");
+        DurabilityTests::assertTrue(restored.getBookingStatus(original) == BookingStatus::Active &&
+                                    restored.getAvailableCount(1, 1) == 62 &&
+                                    restored.getAvailableCount(2, 1) == 64,
+                                    "Original booking kept, replacement never booked");
+    }
+
+    std::filesystem::remove(logPath);
+}
+
+// ============================================================================
+// TEST 11: Parallel replay throughput
+// ============================================================================
+
+void testParallelReplay() {
+    std::cout << "\n=== TEST 11: Parallel Replay Throughput ===\n";
+
+    const uint32_t MOVIES = 512;
+    const uint32_t CAPACITY = 256;
+    std::string logPath = tempPath("replay.wal");
+
+    // One booking per seat, every fourth cancelled again
+    uint32_t expectedFree = 0;
+    {
+        BookingService service(logConfig(Durability::Async, logPath));
+        addShows(service, MOVIES, CAPACITY);
+        for (uint32_t m = 1; m <= MOVIES; m++) {
+            ShowHandle show = service.resolveShow(m, 1);
+            for (uint16_t seat = 0; seat < CAPACITY; seat++) {
+                uint16_t seats[] = {seat};
+                const Booking* booking = service.bookSeats(show, std::span<const uint16_t>(seats));
+                if (seat % 4 == 0) {
+                    service.cancelBooking(booking->bookingId);
+                }
+            }
+        }
+        expectedFree = service.getAvailableCount(MOVIES, 1);
+    }
+
+    uint64_t rebuilt = 0;
+    for (uint32_t workers : {1u, 4u}) {
+        BookingService restored(logConfig(Durability::Async, logPath));
+        addShows(restored, MOVIES, CAPACITY);
+        RecoveryInfo info = restored.recover("", workers);
+        std::cout << "  " << workers << " worker(s): " << info.replayedRecords << " records in "
+                  << std::fixed << std::setprecision(1) << info.elapsed.count() / 1000.0 << " ms ("
+                  << std::setprecision(0) << info.recordsPerSecond() << " records/sec)\n";
+
+        bool matches = info.ok() && info.skippedRecords == 0;
+        for (uint32_t m = 1; m <= MOVIES; m++) {
+            matches = matches && restored.getAvailableCount(m, 1) == expectedFree;
+        }
+        DurabilityTests::assertTrue(matches, std::to_string(workers) + " worker(s) rebuild every show");
+        rebuilt = info.replayedRecords;
+    }
+    DurabilityTests::assertEqual(static_cast<int>(MOVIES * CAPACITY * 5 / 4), static_cast<int>(rebuilt),
+                                 "Every record replayed");
+
+    std::filesystem::remove(logPath);
+}
+
+// ============================================================================
+// TEST 12: GroupSync commit latency per log backend
+// ============================================================================
+
+void testCommitLatency() {
+    std::cout << "\n=== TEST 12: Commit Latency per Log Backend ===\n";
+
+    const int THREADS = 8;
+    const uint32_t CAPACITY = 4096;
+    const auto DURATION = std::chrono::milliseconds(300);
+    std::string path = tempPath("latency.wal");
+
+    struct Backend {
+        LogBackend backend;
+        const char* name;
+    };
+    const Backend backends[] = {
+        {LogBackend::Sync, "Sync   "},
+        {LogBackend::IoUring, "IoUring"},
+    };
+
+    for (const Backend& backend : backends) {
+        std::filesystem::remove(path);
+        BookingServiceConfig config = logConfig(Durability::GroupSync, path);
+        config.groupCommitWindow = std::chrono::microseconds(100);
+        config.logBackend = backend.backend;
+        BookingService service(config);
+        addShows(service, THREADS, CAPACITY);
+
+        std::atomic<bool> stop{false};
+        std::vector<std::vector<double>> latencies(THREADS);
+        std::vector<std::thread> threads;
+        for (int t = 0; t < THREADS; t++) {
+            threads.emplace_back([&, t]() {
+                ShowHandle show = service.resolveShow(static_cast<uint32_t>(t + 1), 1);
+                for (uint16_t seat = 0; seat < CAPACITY && !stop.load(std::memory_order_relaxed); seat++) {
+                    uint16_t seats[] = {seat};
+                    auto start = std::chrono::steady_clock::now();
+                    service.bookSeats(show, std::span<const uint16_t>(seats));
+                    latencies[t].push_back(
+                        std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count());
+                }
+            });
+        }
+        std::this_thread::sleep_for(DURATION);
+        stop = true;
+        for (auto& thread : threads) {
+            thread.join();
+        }
+
+        std::vector<double> all;
+        for (const auto& perThread : latencies) {
+            all.insert(all.end(), perThread.begin(), perThread.end());
+        }
+        std::sort(all.begin(), all.end());
+        auto percentile = [&](double p) {
+            return all.empty() ? 0.0 : all[std::min(all.size() - 1, static_cast<size_t>(p * all.size()))];
+        };
+
+        bool active = service.getLog()->getBackend() == backend.backend;
+        std::cout << "  " << backend.name << (active ? "" : " (unavailable, ran as Sync)") << ": "
+                  << std::fixed << std::setprecision(0) << all.size() / std::chrono::duration<double>(DURATION).count()
+                  << " commits/sec, p50 " << percentile(0.50) << " us, p99 " << percentile(0.99)
+                  << " us, p99.9 " << percentile(0.999) << " us, max " << (all.empty() ? 0.0 : all.back())
+                  << " us\n";
+
+        DurabilityTests::assertTrue(!all.empty() && !service.getLog()->hasFailed(),
+                                    std::string(backend.name) + " commits bookings");
+        DurabilityTests::assertTrue(service.getLog()->getDurableLsn() >= all.size(),
+                                    std::string(backend.name) + " made every returned booking durable");
+    }
+
+    // The file is the same either way: dense, intact records
+    auto records = readLog(path);
+    bool intact = !records.empty();
+    for (size_t i = 0; i < records.size(); i++) {
+        intact = intact && records[i].lsn == i + 1 && records[i].isIntact();
+    }
+    DurabilityTests::assertTrue(intact, "io_uring groups land in lsn order with valid checksums");
+
+    std::filesystem::remove(path);
+}
+
+// ============================================================================
+// TEST 13: Segment rotation and compaction
+// ============================================================================
+
+// Segment files of a segmented log ("<path>.<first lsn>"): count and bytes.
+// A running compactor may delete one meanwhile: it then counts no bytes.
+std::pair<int, uint64_t> segmentFiles(const std::string& logPath) {
+    std::filesystem::path base(logPath);
+    std::string prefix = base.filename().string() + ".";
+    int count = 0;
+    uint64_t bytes = 0;
+    for (const auto& entry : std::filesystem::directory_iterator(base.parent_path())) {
+        std::string name = entry.path().filename().string();
+        if (name.size() == prefix.size() + 20 && name.compare(0, prefix.size(), prefix) == 0) {
+            std::error_code error;
+            uint64_t size = entry.file_size(error);
+            count++;
+            bytes += error ? 0 : size;
+        }
+    }
+    return {count, bytes};
+}
+
+void removeSegments(const std::string& logPath) {
+    std::filesystem::path base(logPath);
+    std::string prefix = base.filename().string() + ".";
+    for (const auto& entry : std::filesystem::directory_iterator(base.parent_path())) {
+        if (entry.path().filename().string().rfind(prefix, 0) == 0) {
+            std::filesystem::remove(entry.path());
+        }
+    }
+}
+
+// The flusher rotates at the start of the round after the one that filled
+// the segment: wait for it, so compactLog finds the segment closed
+void awaitRotation(const BookingLog& log, uint64_t segmentBytes) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (log.getSegments().back().records * sizeof(LogRecord) >= segmentBytes &&
+           std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
+
+BookingServiceConfig segmentedConfig(const std::string& logPath, const std::string& snapshotPath) {
+    BookingServiceConfig config = logConfig(Durability::Async, logPath);
+    config.groupCommitWindow = std::chrono::microseconds(200);
+    config.logSegmentBytes = 256 * sizeof(LogRecord);
+    config.snapshotPath = snapshotPath;
+    return config;
+}
+
+void testLogCompaction() {
+    std::cout << "\n=== TEST 13: Segment Rotation and Compaction ===\n";
+
+    const uint32_t MOVIES = 20;
+    const uint32_t CAPACITY = 256;
+    std::string logPath = tempPath("compact.wal");
+    std::string snapshotPath = tempPath("compact.snap");
+    removeSegments(logPath);
+    BookingServiceConfig config = segmentedConfig(logPath, snapshotPath);
+
+    // One round per show: book every seat, cancel every other booking,
+    // then fold what the log has closed so far into the snapshot
+    uint64_t logged = 0;
+    size_t removed = 0;
+    int maxFiles = 0;
+    uint64_t maxBytes = 0;
+    {
+        BookingService service(config);
+        addShows(service, MOVIES, CAPACITY);
+        for (uint32_t m = 1; m <= MOVIES; m++) {
+            ShowHandle show = service.resolveShow(m, 1);
+            for (uint16_t seat = 0; seat < CAPACITY; seat++) {
+                uint16_t seats[] = {seat};
+                const Booking* booking = service.bookSeats(show, std::span<const uint16_t>(seats));
+                if (seat % 2 == 0) {
+                    service.cancelBooking(booking->bookingId);
+                }
+            }
+            service.getLog()->waitDurable(service.getLog()->getNextLsn() - 1);
+            awaitRotation(*service.getLog(), config.logSegmentBytes);
+            removed += service.compactLog();
+            auto [files, bytes] = segmentFiles(logPath);
+            maxFiles = std::max(maxFiles, files);
+            maxBytes = std::max(maxBytes, bytes);
+        }
+        logged = service.getLog()->getNextLsn() - 1;
+
+        // After the last compaction: only in the active segment
+        service.bookSeats(1, 1, {"a1", "a3"});
+        service.bookSeats(2, 1, {"a1"});
+    }
+
+    std::cout << "  " << logged << " records logged, " << removed << " segments compacted away; at most "
+              << maxFiles << " segment files (" << maxBytes / 1024 << " KB) on disk\n";
+    DurabilityTests::assertTrue(removed >= MOVIES / 2, "Closed segments deleted after each snapshot");
+    DurabilityTests::assertTrue(maxFiles <= 2 && maxBytes <= 2 * config.logSegmentBytes + CAPACITY * 2 * sizeof(LogRecord),
+                                "Disk use bounded by the recent segments");
+
+    BookingService restored(config);
+    RecoveryInfo info = restored.recover(snapshotPath);
+    DurabilityTests::assertTrue(info.ok() && info.snapshotLoaded, "Restarted from the compacted snapshot");
+    DurabilityTests::assertEqual(2, static_cast<int>(info.replayedRecords), "Only the short tail replayed");
+
+    bool matches = restored.getAvailableCount(1, 1) == CAPACITY / 2 - 2 &&
+                   restored.getAvailableCount(2, 1) == CAPACITY / 2 - 1;
+    for (uint32_t m = 3; m <= MOVIES; m++) {
+        matches = matches && restored.getAvailableCount(m, 1) == CAPACITY / 2;
+    }
+    DurabilityTests::assertTrue(matches, "Every show matches the state before the restart");
+
+    auto segments = restored.getLog()->getSegments();
+    DurabilityTests::assertTrue(segments.front().firstLsn > 1 && restored.getLog()->getNextLsn() == logged + 3,
+                                "Log continues after the compacted prefix");
+
+    std::filesystem::remove(snapshotPath);
+    removeSegments(logPath);
+}
+
+// ============================================================================
+// TEST 14: Background compaction under load
+// ============================================================================
+
+void testBackgroundCompaction() {
+    std::cout << "\n=== TEST 14: Background Compaction Under Load ===\n";
+
+    const int THREADS = 4;
+    const uint32_t CAPACITY = 1024;
+    const auto DURATION = std::chrono::milliseconds(400);  // At least, and until MIN_COMPACTIONS ran
+    const uint64_t MIN_COMPACTIONS = 8;
+    const auto DEADLINE = std::chrono::seconds(60);
+    std::string logPath = tempPath("background.wal");
+    std::string snapshotPath = tempPath("background.snap");
+    removeSegments(logPath);
+    BookingServiceConfig config = segmentedConfig(logPath, snapshotPath);
+    config.compactionInterval = std::chrono::milliseconds(20);
+
+    // Each thread books and cancels seats of its own show in a loop while
+    // the compactor snapshots and deletes segments behind it
+    std::atomic<uint64_t> operations{0};
+    std::atomic<int64_t> slowest{0};
+    int maxFiles = 0;
+    uint64_t logged = 0;
+    uint64_t compactions = 0;
+    std::vector<uint32_t> available(THREADS + 1);
+    {
+        BookingService service(config);
+        addShows(service, THREADS, CAPACITY);
+        DurabilityTests::assertTrue(service.recover(snapshotPath).ok(), "Fresh start recovered (nothing to replay)");
+
+        std::atomic<bool> stop{false};
+        std::vector<std::thread> threads;
+        for (int t = 0; t < THREADS; t++) {
+            threads.emplace_back([&, t]() {
+                ShowHandle show = service.resolveShow(t + 1, 1);
+                for (uint16_t seat = 0; !stop.load(std::memory_order_relaxed); seat = (seat + 1) % CAPACITY) {
+                    auto start = std::chrono::steady_clock::now();
+                    uint16_t seats[] = {seat};
+                    const Booking* booking = service.bookSeats(show, std::span<const uint16_t>(seats));
+                    if (booking && seat % 3 != 0) {
+                        service.cancelBooking(booking->bookingId);
+                    }
+                    auto micros = std::chrono::duration_cast<std::chrono::microseconds>(
+                        std::chrono::steady_clock::now() - start).count();
+                    int64_t seen = slowest.load(std::memory_order_relaxed);
+                    while (micros > seen && !slowest.compare_exchange_weak(seen, micros)) {
+                    }
+                    operations.fetch_add(1, std::memory_order_relaxed);
+                }
+            });
+        }
+        auto start = std::chrono::steady_clock::now();
+        auto elapsed = [&]() { return std::chrono::steady_clock::now() - start; };
+        while (elapsed() < DURATION || (service.getCompactionCount() < MIN_COMPACTIONS && elapsed() < DEADLINE)) {
+            maxFiles = std::max(maxFiles, segmentFiles(logPath).first);
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+        stop = true;
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        logged = service.getLog()->getNextLsn() - 1;
+        compactions = service.getCompactionCount();
+        for (int t = 1; t <= THREADS; t++) {
+            available[t] = service.getAvailableCount(t, 1);
+        }
+    }
+
+    // Between two compactions the log grows by segmentsLogged / compactions
+    // segments on average; allow a few times that for uneven gaps
+    uint64_t segmentsLogged = logged / 256;
+    std::cout << "  " << operations.load() << " operations, " << logged << " records (" << segmentsLogged
+              << " segments' worth), " << compactions << " compactions; at most " << maxFiles
+              << " segment files; slowest operation " << slowest.load() << " us\n";
+    DurabilityTests::assertTrue(compactions >= MIN_COMPACTIONS &&
+                                static_cast<uint64_t>(maxFiles) <= 4 * segmentsLogged / compactions + 2,
+                                "Compactor keeps the segment count bounded");
+
+    {
+        BookingService restored(config);
+        RecoveryInfo info = restored.recover(snapshotPath);
+        std::cout << "  Restart: " << info.replayedRecords << " of " << logged << " records replayed\n";
+        bool matches = info.ok() && info.snapshotLoaded && info.replayedRecords < logged / 2;
+        for (int t = 1; t <= THREADS; t++) {
+            matches = matches && restored.getAvailableCount(t, 1) == available[t];
+        }
+        DurabilityTests::assertTrue(matches, "Restart replays a bounded tail and matches the last state");
+    }
+
+    // The same load again, but the process dies while the compactor runs,
+    // with a commit window long enough to always leave records staged
+    uint64_t compactedLsn = BookingService().loadSnapshot(snapshotPath).walLsn;
+    bool ran = runThenCrash([&]() {
+        BookingServiceConfig crashing = config;
+        crashing.groupCommitWindow = std::chrono::milliseconds(50);
+        BookingService* service = new BookingService(crashing);  // Never destroyed
+        if (!service->recover(snapshotPath).ok()) {
+            return false;
+        }
+        for (int t = 0; t < THREADS; t++) {
+            std::thread([service, t]() {
+                ShowHandle show = service->resolveShow(t + 1, 1);
+                for (uint16_t seat = 0;; seat = (seat + 1) % CAPACITY) {
+                    uint16_t seats[] = {seat};
+                    const Booking* booking = service->bookSeats(show, std::span<const uint16_t>(seats));
+                    if (booking && seat % 3 != 0) {
+                        service->cancelBooking(booking->bookingId);
+                    }
+                }
+            }).detach();
+        }
+        // Crash once the compactor has saved a snapshot past the one we
+        // started from (and is likely busy with the next)
+        auto deadline = std::chrono::steady_clock::now() + DEADLINE;
+        while (BookingService().loadSnapshot(snapshotPath).walLsn <= compactedLsn) {
+            if (std::chrono::steady_clock::now() >= deadline) {
+                return false;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        return true;
+    });
+
+    BookingService probe;
+    uint64_t walLsn = probe.loadSnapshot(snapshotPath).walLsn;
+    uint64_t logEnd = 0;
+    {
+        auto log = BookingLog::open(logPath, {.segmentBytes = config.logSegmentBytes});
+        logEnd = log ? log->getNextLsn() : 0;
+    }
+    DurabilityTests::assertTrue(ran && walLsn > compactedLsn && logEnd >= walLsn,
+                                "Crash during compaction: the log still holds every record up to walLsn");
+
+    uint64_t booked = 0;
+    {
+        BookingService crashed(config);
+        DurabilityTests::assertTrue(crashed.recover(snapshotPath).ok(), "Recovered after the crash");
+        const Booking* booking = crashed.bookAdjacent(1, 1, 1);
+        booked = booking ? booking->bookingId : 0;
+    }
+    BookingService again(config);
+    DurabilityTests::assertTrue(again.recover(snapshotPath).ok() && booked != 0 &&
+                                again.getBookingStatus(booked) == BookingStatus::Active,
+                                "Booking made after the crash survives the next restart");
+
+    std::filesystem::remove(snapshotPath);
+    removeSegments(logPath);
+}
+
+// ============================================================================
+// TEST 15: A snapshot only claims records that reached the log
+// ============================================================================
+
+void testSnapshotAfterUncleanShutdown() {
+    std::cout << "\n=== TEST 15: Snapshot Then Unclean Shutdown ===\n";
+
+    std::string logPath = tempPath("unclean.wal");
+    std::string snapshotPath = tempPath("unclean.snap");
+    BookingServiceConfig config = logConfig(Durability::Async, logPath);
+    config.groupCommitWindow = std::chrono::milliseconds(300);
+
+    // The last bookings are still staged when the snapshot starts: the
+    // flusher has just written the first one and sleeps out its window
+    bool snapshotted = runThenCrash([&]() {
+        BookingService& service = *new BookingService(config);  // Never destroyed
+        addShows(service, 2, 20);
+        service.bookSeats(1, 1, {"a1", "a2"});
+        service.getLog()->waitDurable(1);
+        service.bookSeats(1, 1, {"a3"});
+        service.bookSeats(2, 1, {"a1"});
+        return service.saveSnapshot(snapshotPath).ok();
+    });
+    DurabilityTests::assertTrue(snapshotted, "Snapshot taken, then the process died");
+
+    BookingService probe;
+    uint64_t walLsn = probe.loadSnapshot(snapshotPath).walLsn;
+    DurabilityTests::assertTrue(walLsn == 4 && readLog(logPath).size() + 1 >= walLsn,
+                                "Every record below the snapshot's walLsn reached the log");
+
+    BookingService restored(config);
+    RecoveryInfo info = restored.recover(snapshotPath);
+    DurabilityTests::assertTrue(info.ok() && info.snapshotLoaded && restored.getAvailableCount(1, 1) == 17 &&
+                                restored.getAvailableCount(2, 1) == 19,
+                                "Recovered the snapshot's bookings");
+    DurabilityTests::assertTrue(restored.getLog()->getNextLsn() == walLsn, "Log continues at the snapshot's walLsn");
+
+    std::filesystem::remove(snapshotPath);
+    std::filesystem::remove(logPath);
+}
+
+// ============================================================================
+// TEST 16: Recovery moves the log past a snapshot it fell behind
+// ============================================================================
+
+void testRecoveryPastLostTail() {
+    std::cout << "\n=== TEST 16: Recovery Past a Lost Log Tail ===\n";
+
+    std::string logPath = tempPath("behind.wal");
+    std::string snapshotPath = tempPath("behind.snap");
+    for (bool segmented : {false, true}) {
+        std::string label = segmented ? " (segmented)" : " (one file)";
+        BookingServiceConfig config = logConfig(Durability::Async, logPath);
+        config.logSegmentBytes = segmented ? 256 * sizeof(LogRecord) : 0;
+        std::string logFile = segmented ? logPath + ".00000000000000000001" : logPath;
+        std::filesystem::remove(logPath);
+        removeSegments(logPath);
+        {
+            BookingService service(config);
+            addShows(service, 2, 20);
+            service.bookSeats(1, 1, {"a1", "a2"});
+            service.bookSeats(1, 1, {"a3"});
+            service.bookSeats(2, 1, {"a1"});
+            service.saveSnapshot(snapshotPath);
+        }
+
+        // The log lost records the snapshot holds (walLsn 4)
+        std::filesystem::resize_file(logFile, sizeof(LogRecord));
+
+        uint64_t booked = 0;
+        {
+            BookingService restored(config);
+            RecoveryInfo info = restored.recover(snapshotPath);
+            DurabilityTests::assertTrue(info.ok() && restored.getLog()->getNextLsn() == 4,
+                                        "Log moved on to the snapshot's walLsn" + label);
+            booked = restored.bookSeats(1, 1, {"a5"})->bookingId;
+        }
+
+        BookingService again(config);
+        RecoveryInfo info = again.recover(snapshotPath);
+        DurabilityTests::assertTrue(info.ok() && info.replayedRecords == 1 &&
+                                    again.getBookingStatus(booked) == BookingStatus::Active &&
+                                    again.getAvailableCount(1, 1) == 16,
+                                    "Booking made after the restart survives the next one" + label);
+    }
+
+    std::filesystem::remove(snapshotPath);
+    std::filesystem::remove(logPath);
+    removeSegments(logPath);
+}
+
+// ============================================================================
+// MAIN
+// ============================================================================
+
+int main() {
+    std::cout << "=========================================================\n";
+    std::cout << "      DURABILITY TESTS - WRITE-AHEAD LOG\n";
+    std::cout << "=========================================================\n";
+
+    testLogRecordsEveryChange();
+    testGroupSyncWaitsForDisk();
+    testLogReopen();
+    testConcurrentAppends();
+    testDurabilityThroughput();
+    testSnapshotRoundTrip();
+    testSnapshotRejectsBadFiles();
+    testOnlineSnapshot();
+    testSnapshotRestoreTime();
+    testCrashRecovery();
+    testParallelReplay();
+    testCommitLatency();
+    testLogCompaction();
+    testBackgroundCompaction();
+    testSnapshotAfterUncleanShutdown();
+    testRecoveryPastLostTail();
+
+    std::cout << "\n=========================================================\n";
+    std::cout << "                    FINAL RESULTS\n";
+    std::cout << "=========================================================\n";
+    std::cout << "Passed: " << DurabilityTests::passed << "\n";
+    std::cout << "Failed: " << DurabilityTests::failed << "\n";
+    std::cout << "Total:  " << (DurabilityTests::passed + DurabilityTests::failed) << "\n";
+    std::cout << "=========================================================\n";
+
+    if (DurabilityTests::failed == 0) {
+        std::cout << "\n✅ ALL DURABILITY TESTS PASSED!\n\n";
+    } else {
+        std::cout << "\n❌ SOME DURABILITY TESTS FAILED!\n\n";
+    }
+
+    return DurabilityTests::failed > 0 ? 1 : 0;
+}
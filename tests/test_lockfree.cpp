@@ -1,10 +1,18 @@
 #include "BookingService.h"
 #include "SeatBitmask.h"
+#include "WideSeatBitmask.h"
+#include "FixedSeatBitmask.h"
+#include "ConcurrentHashIndex.h"
+#include "EpochReclaimer.h"
+#include "SeatSelector.h"
+#include "TimerWheel.h"
 #include <iostream>
 #include <thread>
 #include <vector>
 #include <chrono>
 #include <atomic>
+#include <algorithm>
+#include <array>
 #include <cassert>
 
 class TestFramework {
@@ -150,6 +158,977 @@ void testConcurrentLockFreeBooking() {
     TestFramework::assertEqual(980, failureCount.load(), "980 failed bookings");
 }
 
+void testBackoffPolicies() {
+    std::cout << "\n--- Test: Pluggable Backoff Policies ---\n";
+    
+    const BackoffStrategy strategies[] = {
+        BackoffStrategy::None, BackoffStrategy::Pause, BackoffStrategy::ExponentialJitter,
+        BackoffStrategy::Yield, BackoffStrategy::Sleep
+    };
+    const char* names[] = {"None", "Pause", "ExponentialJitter", "Yield", "Sleep"};
+    
+    for (int s = 0; s < 5; ++s) {
+        BackoffPolicy policy;
+        policy.strategy = strategies[s];
+        SeatBitmask mask(policy);
+        
+        std::atomic<int> successCount(0);
+        std::vector<std::thread> threads;
+        for (int i = 0; i < 200; ++i) {
+            threads.emplace_back([&mask, &successCount, i]() {
+                uint32_t seatMask = 1u << (i % 20);
+                if (mask.tryBook(seatMask)) {
+                    successCount++;
+                }
+            });
+        }
+        for (auto& t : threads) {
+            t.join();
+        }
+        
+        std::cout << "  " << names[s] << ": retries=" << mask.getRetryCount()
+                  << " give-ups=" << mask.getGiveUpCount() << "\n";
+        TestFramework::assertEqual(20, successCount.load(),
+                                   std::string(names[s]) + ": exactly 20 successful bookings");
+    }
+    
+    // A zero retry budget never attempts the CAS and counts a give-up
+    BackoffPolicy noAttempts;
+    noAttempts.maxRetries = 0;
+    SeatBitmask starved(noAttempts);
+    TestFramework::assertTrue(!starved.tryBook(1u), "maxRetries=0 gives up immediately");
+    TestFramework::assertEqual(1, static_cast<int>(starved.getGiveUpCount()), "Give-up counted");
+}
+
+// ===== Tests for WideSeatBitmask (multi-word) =====
+
+void testWideBitmaskBasics() {
+    std::cout << "\n--- Test: Wide Bitmask Basics (300 seats) ---\n";
+    
+    WideSeatBitmask mask(300);
+    TestFramework::assertEqual(5, mask.getWordCount(), "300 seats -> 5 words");
+    TestFramework::assertEqual(300, mask.getAvailableCount(), "Initially 300 seats available");
+    
+    TestFramework::assertEqual(299, WideSeatBitmask::seatIdToBit("a300", 300), "a300 -> bit 299");
+    TestFramework::assertEqual(-1, WideSeatBitmask::seatIdToBit("a301", 300), "a301 invalid");
+    TestFramework::assertEqual(-1, WideSeatBitmask::seatIdToBit("a0", 300), "a0 invalid");
+    
+    // Request spanning words 0 and 1 (a60..a70)
+    std::vector<std::string> seats1;
+    for (int i = 60; i <= 70; ++i) {
+        seats1.push_back("a" + std::to_string(i));
+    }
+    auto mask1 = mask.createMask(seats1);
+    TestFramework::assertTrue(mask.tryBook(mask1), "Booking spanning two words succeeds");
+    TestFramework::assertEqual(289, mask.getAvailableCount(), "289 seats after booking 11");
+    
+    // a200 is taken, so {a10, a200} must fail without leaving a10 occupied
+    TestFramework::assertTrue(mask.tryBook(mask.createMask({"a200"})), "Booking a200 succeeds");
+    TestFramework::assertTrue(!mask.tryBook(mask.createMask({"a10", "a200"})),
+                              "Booking {a10, a200} fails");
+    TestFramework::assertTrue(mask.areAvailable(mask.createMask({"a10"})),
+                              "a10 rolled back (no partial booking)");
+    TestFramework::assertEqual(288, mask.getAvailableCount(), "Still 288 seats");
+}
+
+void testWideBitmaskConcurrentSpanning() {
+    std::cout << "\n--- Test: 1000 Threads Booking Across Words ---\n";
+    
+    WideSeatBitmask mask(200);
+    const int numThreads = 1000;
+    std::atomic<int> successCount(0);
+    std::vector<std::thread> threads;
+    
+    // Each thread wants {k, k+64, k+128}: three words, all-or-nothing
+    for (int i = 0; i < numThreads; ++i) {
+        threads.emplace_back([&mask, &successCount, i]() {
+            int k = (i % 64) + 1;
+            auto seatMask = mask.createMask({"a" + std::to_string(k),
+                                             "a" + std::to_string(k + 64),
+                                             "a" + std::to_string(k + 128)});
+            if (mask.tryBook(seatMask)) {
+                successCount++;
+            }
+        });
+    }
+    
+    for (auto& t : threads) {
+        t.join();
+    }
+    
+    TestFramework::assertEqual(64, successCount.load(), "Exactly 64 successful triples");
+    TestFramework::assertEqual(8, mask.getAvailableCount(), "Only a193..a200 left");
+}
+
+void testFixedBitmaskSpecializations() {
+    std::cout << "\n--- Test: Compile-Time Seat Capacities ---\n";
+    
+    TestFramework::assertEqual(1, FixedSeatBitmask<64>::WORD_COUNT, "64 seats -> 1 word");
+    TestFramework::assertEqual(2, FixedSeatBitmask<128>::WORD_COUNT, "128 seats -> 2 words");
+    TestFramework::assertEqual(8, FixedSeatBitmask<512>::WORD_COUNT, "512 seats -> 8 words");
+    TestFramework::assertTrue(FixedSeatBitmask<20>::ALL_SEATS_MASK[0] == 0xFFFFFu,
+                              "20-seat ALL_SEATS_MASK is 20 bits");
+    
+    // Factory picks the specialization per capacity
+    auto map256 = SeatMap::create(256);
+    auto map300 = SeatMap::create(300);
+    TestFramework::assertTrue(dynamic_cast<FixedSeatBitmask<256>*>(map256.get()) != nullptr,
+                              "Capacity 256 uses FixedSeatBitmask<256>");
+    TestFramework::assertTrue(dynamic_cast<WideSeatBitmask*>(map300.get()) != nullptr,
+                              "Capacity 300 uses WideSeatBitmask");
+    
+    // Same all-or-nothing semantics across words
+    FixedSeatBitmask<128> mask;
+    TestFramework::assertTrue(mask.tryBook(mask.createMask({"a64", "a65"})), "Booking a64, a65 succeeds");
+    TestFramework::assertTrue(!mask.tryBook(mask.createMask({"a1", "a65"})), "Booking a1, a65 fails");
+    TestFramework::assertEqual(126, mask.getAvailableCount(), "126 seats (a1 rolled back)");
+}
+
+void testFetchOrBooking() {
+    std::cout << "\n--- Test: Wait-Free fetch_or Booking ---\n";
+    
+    FixedSeatBitmask<64> mask;
+    TestFramework::assertTrue(mask.tryBook(mask.createMask({"a1"}), ClaimStrategy::FetchOr),
+                              "fetch_or booking a1 succeeds");
+    TestFramework::assertTrue(!mask.tryBook(mask.createMask({"a1", "a2"}), ClaimStrategy::FetchOr),
+                              "fetch_or booking a1, a2 fails");
+    TestFramework::assertTrue(mask.areAvailable(mask.createMask({"a2"})),
+                              "a2 rolled back (only newly set bits cleared)");
+    TestFramework::assertTrue(!mask.areAvailable(mask.createMask({"a1"})),
+                              "a1 still occupied by first booking");
+    
+    // Multi-word rollback
+    WideSeatBitmask wide(300);
+    TestFramework::assertTrue(wide.tryBook(wide.createMask({"a250"}), ClaimStrategy::FetchOr),
+                              "fetch_or booking a250 succeeds");
+    TestFramework::assertTrue(!wide.tryBook(wide.createMask({"a5", "a250"}), ClaimStrategy::FetchOr),
+                              "fetch_or booking a5, a250 fails");
+    TestFramework::assertEqual(299, wide.getAvailableCount(), "a5 rolled back across words");
+    
+    // Same contention test as the CAS loop: exactly one winner per seat
+    FixedSeatBitmask<20> contended;
+    std::atomic<int> successCount(0);
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 1000; ++i) {
+        threads.emplace_back([&contended, &successCount, i]() {
+            auto seatMask = contended.createMask({"a" + std::to_string((i % 20) + 1)});
+            if (contended.tryBook(seatMask, ClaimStrategy::FetchOr)) {
+                successCount++;
+            }
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    TestFramework::assertEqual(20, successCount.load(), "Exactly 20 fetch_or winners");
+}
+
+void testConcurrentHashIndex() {
+    std::cout << "\n--- Test: Concurrent Hash Index ---\n";
+    
+    // Small initial table so the concurrent inserts force several resizes
+    ConcurrentHashIndex<uint64_t> index(16);
+    const int THREADS = 8;
+    const uint64_t KEYS = 2000;
+    std::vector<std::unique_ptr<uint64_t[]>> values(THREADS);
+    std::atomic<int> created(0);
+    std::atomic<int> mismatches(0);
+    
+    std::vector<std::thread> threads;
+    for (int t = 0; t < THREADS; ++t) {
+        values[t] = std::make_unique<uint64_t[]>(KEYS);
+        threads.emplace_back([&, t]() {
+            for (uint64_t k = 0; k < KEYS; ++k) {
+                uint64_t key = (k << 32) | (k % 7);  // packed (movieId, theaterId)
+                uint64_t* value = index.insertIfAbsent(key, [&]() {
+                    created++;
+                    values[t][k] = key;
+                    return &values[t][k];
+                });
+                // Every thread must observe the single winning value
+                if (*value != key || index.find(key) != value) {
+                    mismatches++;
+                }
+            }
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    
+    TestFramework::assertEqual(static_cast<int>(KEYS), created.load(), "One value created per key");
+    TestFramework::assertEqual(0, mismatches.load(), "All threads see the same value");
+    TestFramework::assertEqual(static_cast<int>(KEYS), static_cast<int>(index.size()), "Index size matches");
+    TestFramework::assertTrue(index.find(KEYS << 32) == nullptr, "Missing key returns nullptr");
+}
+
+std::atomic<int> reclaimedObjects(0);
+
+void testEpochReclamation() {
+    std::cout << "\n--- Test: Epoch-Based Reclamation ---\n";
+    
+    EpochReclaimer& epochs = EpochReclaimer::global();
+    std::atomic<bool> pinned(false);
+    std::atomic<bool> release(false);
+    
+    // A reader pinned before the retire must keep the object alive
+    std::thread reader([&]() {
+        auto guard = epochs.pin();
+        pinned = true;
+        while (!release) {
+            std::this_thread::yield();
+        }
+    });
+    while (!pinned) {
+        std::this_thread::yield();
+    }
+    
+    int before = reclaimedObjects.load();
+    epochs.retire(new int(42), [](void* p) {
+        delete static_cast<int*>(p);
+        reclaimedObjects++;
+    });
+    epochs.reclaim();
+    TestFramework::assertEqual(before, reclaimedObjects.load(), "Not freed while a reader is pinned");
+    
+    release = true;
+    reader.join();
+    epochs.reclaim();
+    TestFramework::assertEqual(before + 1, reclaimedObjects.load(), "Freed after the reader leaves");
+    
+    // Nested guards on one thread
+    {
+        auto outer = epochs.pin();
+        {
+            auto inner = epochs.pin();
+        }
+        epochs.retire(new int(7), [](void* p) {
+            delete static_cast<int*>(p);
+            reclaimedObjects++;
+        });
+        epochs.reclaim();
+        TestFramework::assertEqual(before + 1, reclaimedObjects.load(), "Inner guard exit keeps outer pinned");
+    }
+    epochs.reclaim();
+    TestFramework::assertEqual(before + 2, reclaimedObjects.load(), "Freed after outer guard exit");
+    
+    // Grace periods: wait for earlier readers, never for our own guard
+    pinned = false;
+    release = false;
+    std::thread slowReader([&]() {
+        auto guard = epochs.pin();
+        pinned = true;
+        while (!release) {
+            std::this_thread::yield();
+        }
+    });
+    while (!pinned) {
+        std::this_thread::yield();
+    }
+    TestFramework::assertTrue(!epochs.synchronize(std::chrono::milliseconds(20)), "Grace period waits for a pinned reader");
+    release = true;
+    slowReader.join();
+    {
+        auto own = epochs.pin();
+        TestFramework::assertTrue(epochs.synchronize(), "Grace period ends once readers leave");
+    }
+}
+
+// Parsing is constexpr: checked at compile time
+static_assert(SeatMap::seatIdToBit("a1", 20) == 0);
+static_assert(SeatMap::seatIdToBit("A150", 300) == 149);
+static_assert(SeatMap::seatIdToBit("a4096", SeatMap::MAX_CAPACITY) == 4095);
+static_assert(SeatMap::seatIdToBit("a01", 20) == -1);
+static_assert(SeatMap::seatIdToBit("a2x", 20) == -1);
+static_assert(SeatBitmask::seatIdToBit("a21") == -1);
+
+void testSeatParsingSpans() {
+    std::cout << "\n--- Test: Seat Parsing With Views And Spans ---\n";
+    
+    WideSeatBitmask map(300);
+    std::array<uint64_t, SeatMap::MAX_WORDS> words{};
+    std::span<uint64_t> mask(words.data(), map.getWordCount());
+    
+    std::array<std::string_view, 3> ids = {"a1", "a65", "a300"};
+    TestFramework::assertTrue(map.buildMask(ids, mask), "Valid string views build a mask");
+    TestFramework::assertTrue(words[0] == 1 && words[1] == 1 && words[4] == (uint64_t{1} << 43),
+                              "Bits set in one pass across words");
+    
+    std::array<std::string_view, 2> bad = {"a2", "a301"};
+    TestFramework::assertTrue(!map.buildMask(bad, mask), "Out-of-range view rejected");
+    
+    BookingService service;
+    service.addMovie(std::make_shared<Movie>(1, "Inception"));
+    service.addTheater(std::make_shared<Theater>(1, "Grand Hall", 300));
+    service.linkMovieToTheater(1, 1);
+    ShowHandle show = service.resolveShow(1, 1);
+    
+    std::array<std::string_view, 2> views = {"a10", "a200"};
+    auto byViews = service.bookSeats(1, 1, std::span<const std::string_view>(views));
+    TestFramework::assertTrue(byViews != nullptr, "Booking by string views succeeds");
+    TestFramework::assertEqual(2, byViews->seatCount, "Two seats recorded");
+    
+    std::array<uint16_t, 2> indexes = {10, 199};  // a11, a200
+    TestFramework::assertTrue(service.bookSeats(show, std::span<const uint16_t>(indexes)) == nullptr,
+                              "Pre-parsed overlap with a200 rejected");
+    indexes[1] = 298;  // a299
+    auto byIndexes = service.bookSeats(show, std::span<const uint16_t>(indexes));
+    TestFramework::assertTrue(byIndexes != nullptr, "Booking by seat indexes succeeds");
+    TestFramework::assertTrue(byIndexes->seatIds() == std::vector<std::string>{"a11", "a299"},
+                              "Seat IDs rendered from indexes");
+    
+    std::array<uint16_t, 1> outOfRange = {300};
+    TestFramework::assertTrue(service.bookSeats(show, std::span<const uint16_t>(outOfRange)) == nullptr,
+                              "Index beyond capacity rejected");
+    TestFramework::assertEqual(296, service.getAvailableCount(show), "296 seats remaining");
+}
+
+void testAvailableSeatEnumeration() {
+    std::cout << "\n--- Test: Allocation-Free Seat Enumeration ---\n";
+    
+    BookingService service;
+    service.addMovie(std::make_shared<Movie>(1, "Inception"));
+    service.addTheater(std::make_shared<Theater>(1, "IMAX"));
+    service.addTheater(std::make_shared<Theater>(2, "Grand Hall", 130));
+    service.linkMovieToTheater(1, 1);
+    service.linkMovieToTheater(1, 2);
+    
+    // No show yet: fallback lists every seat
+    char buffer[128];
+    size_t length = service.formatAvailableSeats(1, 1, buffer);
+    TestFramework::assertTrue(std::string_view(buffer, length).starts_with("a1,a2,a3,") &&
+                              std::string_view(buffer, length).ends_with(",a20"),
+                              "Fallback formats a1..a20");
+    
+    ShowHandle hall = service.resolveShow(1, 2);
+    service.bookSeats(hall, {"a1", "a64", "a65", "a129"});
+    
+    std::vector<uint32_t> visited;
+    service.forEachAvailableSeat(hall, [&visited](uint32_t seat) { visited.push_back(seat); });
+    TestFramework::assertEqual(126, visited.size(), "Visitor sees 126 free seats");
+    TestFramework::assertTrue(visited.front() == 1 && visited[62] == 65 && visited.back() == 129,
+                              "Visitor skips booked seats across words, ascending");
+    
+    int seen = 0;
+    service.forEachAvailableSeat(hall, [&seen](uint32_t) { return ++seen < 3; });
+    TestFramework::assertEqual(3, seen, "Visitor returning false stops the walk");
+    
+    char small[10];
+    length = service.formatAvailableSeats(hall, small);
+    TestFramework::assertTrue(std::string_view(small, length) == "a2,a3,a4",
+                              "Small buffer gets whole seat IDs only");
+    
+    std::vector<char> large(130 * (SeatMap::MAX_SEAT_ID_LENGTH + 1));
+    length = service.formatAvailableSeats(hall, large);
+    auto seats = service.getAvailableSeats(1, 2);
+    std::string joined;
+    for (const auto& seat : seats) {
+        joined += (joined.empty() ? "" : ",") + seat;
+    }
+    TestFramework::assertTrue(std::string_view(large.data(), length) == joined,
+                              "Buffer output matches getAvailableSeats");
+}
+
+void testBookAdjacent() {
+    std::cout << "\n--- Test: Adjacent Seat Blocks ---\n";
+    
+    WideSeatBitmask wide(300);
+    wide.tryBook(wide.createMask({"a60", "a70"}));
+    TestFramework::assertEqual(0, wide.findFreeRun(59), "59-seat run fits before a60");
+    TestFramework::assertEqual(60, wide.findFreeRun(9, 59), "9-seat run a61..a69 spans words");
+    TestFramework::assertEqual(70, wide.findFreeRun(10, 60), "10-seat run starts after a70");
+    TestFramework::assertEqual(236, wide.findFreeRun(64, 236), "64-seat run at the end");
+    TestFramework::assertEqual(-1, wide.findFreeRun(64, 237), "Run cannot pass the capacity");
+    
+    BookingService service;
+    service.addMovie(std::make_shared<Movie>(1, "Inception"));
+    service.addTheater(std::make_shared<Theater>(1, "IMAX"));
+    service.addTheater(std::make_shared<Theater>(2, "Studio", 64));
+    service.linkMovieToTheater(1, 1);
+    service.linkMovieToTheater(1, 2);
+    
+    service.bookSeats(1, 1, {"a3"});
+    auto block = service.bookAdjacent(1, 1, 4);
+    TestFramework::assertTrue(block != nullptr &&
+                              block->seatIds() == std::vector<std::string>{"a4", "a5", "a6", "a7"},
+                              "4 adjacent seats skip the gap before a3");
+    TestFramework::assertTrue(service.bookAdjacent(1, 1, 14) == nullptr, "No 14-seat block left");
+    TestFramework::assertTrue(service.bookAdjacent(1, 1, 13) != nullptr, "13-seat block a8..a20 fits");
+    
+    // Concurrent groups of 3 on 64 seats: 21 blocks, all contiguous, no overlap
+    ShowHandle studio = service.resolveShow(1, 2);
+    std::atomic<int> successCount(0);
+    std::atomic<int> badBlocks(0);
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 40; ++i) {
+        threads.emplace_back([&]() {
+            auto booking = service.bookAdjacent(studio, 3);
+            if (booking) {
+                successCount++;
+                if (booking->seatCount != 3 || booking->seats[2] != booking->seats[0] + 2) {
+                    badBlocks++;
+                }
+            }
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    TestFramework::assertEqual(21, successCount.load(), "21 groups of 3 seated in 64 seats");
+    TestFramework::assertEqual(0, badBlocks.load(), "Every group is contiguous");
+    TestFramework::assertEqual(1, service.getAvailableCount(studio), "One seat left");
+}
+
+void testBestAvailableSelection() {
+    std::cout << "\n--- Test: Best-Available Selection ---\n";
+    
+    // 20 rows x 25 seats; row 13 (a326..a350) is preferred
+    auto layout = std::make_shared<SeatLayout>(SeatLayout::uniform(20, 25));
+    TestFramework::assertTrue(layout->isValid() && layout->getCapacity() == 500, "500-seat layout is valid");
+    
+    BookingService service;
+    service.addMovie(std::make_shared<Movie>(1, "Inception"));
+    service.addTheater(std::make_shared<Theater>(1, "Grand", 500, layout));
+    service.addTheater(std::make_shared<Theater>(2, "IMAX"));
+    service.linkMovieToTheater(1, 1);
+    service.linkMovieToTheater(1, 2);
+    
+    auto best = service.bookBestAvailable(1, 1, 3);
+    TestFramework::assertTrue(best != nullptr &&
+                              best->seatIds() == std::vector<std::string>{"a337", "a338", "a339"},
+                              "Center of the preferred row first");
+    
+    // a335 taken: a337..a339 would strand a336, so slide left onto it
+    auto grand = service.resolveShow(1, 1);
+    service.bookSeats(1, 1, {"a335"});
+    WideSeatBitmask probe(500);
+    probe.tryBook(probe.createMask({"a335"}));
+    SeatSelector selector(*layout);
+    SeatChoice choice = selector.select(probe, 3);
+    TestFramework::assertEqual(335, choice.start, "Orphan penalty moves the block to a336");
+    TestFramework::assertTrue(selector.select(probe, 26).start == -1, "No block wider than a row");
+    
+    // Blocks never cross rows
+    std::array<SeatChoice, SeatSelector::MAX_CANDIDATES> ranked;
+    size_t rankedCount = selector.rank(probe, 25, ranked);
+    bool rowAligned = rankedCount > 0;
+    for (size_t i = 0; i < rankedCount; ++i) {
+        rowAligned = rowAligned && ranked[i].start % 25 == 0;
+    }
+    TestFramework::assertTrue(rowAligned, "Full-row blocks start at a row");
+    
+    // Theater without a layout is one row
+    auto imax = service.bookBestAvailable(1, 2, 2);
+    TestFramework::assertTrue(imax != nullptr &&
+                              imax->seatIds() == std::vector<std::string>{"a10", "a11"},
+                              "Default layout picks the center pair");
+    
+    // Concurrent pickers all want the same best block: losers fall back
+    std::atomic<int> successCount(0);
+    std::atomic<int> seatsBooked(0);
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 60; ++i) {
+        threads.emplace_back([&]() {
+            auto booking = service.bookBestAvailable(grand, 4);
+            if (booking && booking->seats[3] == booking->seats[0] + 3 &&
+                booking->seats[0] / 25 == booking->seats[3] / 25) {
+                successCount++;
+                seatsBooked += booking->seatCount;
+            }
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    TestFramework::assertEqual(60, successCount.load(), "60 groups of 4 seated in one row each");
+    TestFramework::assertEqual(500 - 1 - 3 - 240, service.getAvailableCount(grand), "No seat booked twice");
+    
+    // Selection latency on the 500-seat house. The bound is loose enough
+    // for Debug and sanitizer builds (~3 us in Release, ~30 us under ASAN)
+    // while an optimized build still fails on a gross regression
+    const int iterations = 20000;
+    int64_t checksum = 0;
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        checksum += selector.select(probe, 2 + i % 4).start;
+    }
+    auto nanos = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::high_resolution_clock::now() - start).count();
+    double microsPerSelect = nanos / 1000.0 / iterations;
+    std::cout << "  Best-available select (500 seats): " << microsPerSelect << " us"
+              << " (checksum " << checksum << ")\n";
+    TestFramework::assertTrue(microsPerSelect < 200.0, "Best-available select stays under 200 us");
+}
+
+void testTimerWheel() {
+    std::cout << "\n--- Test: Hierarchical Timer Wheel ---\n";
+    
+    // One deadline per level boundary, plus one beyond the wheel's range
+    const std::vector<uint64_t> deadlines = {1, 63, 64, 65, 4095, 4096, 300000, (1ull << 24) + 5000};
+    TimerWheel wheel;
+    for (size_t i = 0; i < deadlines.size(); ++i) {
+        wheel.schedule(i, deadlines[i]);
+    }
+    TestFramework::assertEqual(deadlines.size(), wheel.size(), "All timers pending");
+    
+    std::vector<uint64_t> firedAt(deadlines.size(), 0);
+    size_t fired = wheel.advance(deadlines.back() + 10, [&](uint64_t id) {
+        firedAt[id] = wheel.getCurrentTick();
+    });
+    TestFramework::assertEqual(deadlines.size(), fired, "Every timer fired once");
+    TestFramework::assertTrue(firedAt == deadlines, "Each timer fired exactly at its deadline tick");
+    TestFramework::assertEqual(0, wheel.size(), "Wheel empty");
+    
+    wheel.schedule(42, 10);  // Already past: fires on the next tick
+    size_t late = wheel.advance(wheel.getCurrentTick() + 1, [](uint64_t) {});
+    TestFramework::assertEqual(1, late, "Past deadline fires on the next tick");
+}
+
+void testSeatHolds() {
+    std::cout << "\n--- Test: Seat Holds (reserve / confirm / expire) ---\n";
+    
+    BookingService service;
+    service.addMovie(std::make_shared<Movie>(1, "Inception"));
+    service.addTheater(std::make_shared<Theater>(1, "IMAX"));
+    service.addTheater(std::make_shared<Theater>(2, "Arena", 1000));
+    service.linkMovieToTheater(1, 1);
+    service.linkMovieToTheater(1, 2);
+    ShowHandle show = service.resolveShow(1, 1);
+    const auto ttl = std::chrono::minutes(5);
+    
+    HoldId hold = service.holdSeats(1, 1, {"a1", "a2"}, ttl);
+    TestFramework::assertTrue(hold.isValid(), "Hold succeeds");
+    auto available = service.getAvailableSeats(1, 1);
+    TestFramework::assertTrue(std::find(available.begin(), available.end(), "a1") == available.end(),
+                              "Held seat not listed as available");
+    TestFramework::assertEqual(2, service.getHeldCount(show), "2 seats held");
+    TestFramework::assertTrue(service.bookSeats(1, 1, {"a2"}) == nullptr, "Held seat cannot be booked");
+    TestFramework::assertTrue(!service.holdSeats(show, {"a2", "a3"}, ttl).isValid(), "Held seat cannot be held again");
+    
+    const Booking* booking = service.confirmHold(hold);
+    TestFramework::assertTrue(booking != nullptr &&
+                              booking->seatIds() == std::vector<std::string>{"a1", "a2"},
+                              "Confirm turns the hold into a booking");
+    TestFramework::assertTrue(booking && service.getBooking(booking->bookingId) == booking, "Booking retrievable");
+    TestFramework::assertEqual(0, service.getHeldCount(show), "No seats held after confirm");
+    TestFramework::assertEqual(18, service.getAvailableCount(show), "Confirmed seats stay taken");
+    TestFramework::assertTrue(service.confirmHold(hold) == nullptr, "Hold confirms only once");
+    TestFramework::assertTrue(!service.releaseHold(hold), "Confirmed hold cannot be released");
+    
+    HoldId released = service.holdSeats(show, {"a3"}, ttl);
+    TestFramework::assertTrue(service.releaseHold(released), "Release succeeds");
+    TestFramework::assertEqual(18, service.getAvailableCount(show), "Released seat is free again");
+    
+    // Expiry by the timer wheel
+    auto now = std::chrono::steady_clock::now();
+    HoldId expiring = service.holdSeats(show, {"a4", "a5"}, std::chrono::seconds(30));
+    TestFramework::assertEqual(0, service.expireHolds(now), "Nothing expires early");
+    TestFramework::assertEqual(1, service.expireHolds(now + std::chrono::minutes(1)), "Hold expires after its TTL");
+    TestFramework::assertEqual(18, service.getAvailableCount(show), "Expired seats are free again");
+    TestFramework::assertTrue(service.confirmHold(expiring) == nullptr, "Expired hold cannot be confirmed");
+    
+    // A confirm after the TTL fails even before the sweep runs
+    HoldId late = service.holdSeats(show, {"a6"}, std::chrono::milliseconds(1));
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    TestFramework::assertTrue(service.confirmHold(late) == nullptr, "Late confirm fails");
+    TestFramework::assertEqual(18, service.getAvailableCount(show), "Late hold's seat is free again");
+    
+    // Many holds on one large show expire in one batch
+    ShowHandle arena = service.resolveShow(1, 2);
+    for (uint16_t seat = 0; seat < 500; seat += 2) {
+        std::array<uint16_t, 2> pair = {seat, static_cast<uint16_t>(seat + 1)};
+        service.holdSeats(arena, pair, std::chrono::seconds(10));
+    }
+    TestFramework::assertEqual(500, service.getHeldCount(arena), "250 holds on the arena");
+    TestFramework::assertEqual(250, service.expireHolds(std::chrono::steady_clock::now() + std::chrono::minutes(1)),
+                               "All arena holds expire together");
+    TestFramework::assertEqual(1000, service.getAvailableCount(arena), "Arena empty again");
+    
+    // Confirm and release racing on the same holds: exactly one wins
+    std::vector<HoldId> holds;
+    for (uint16_t seat = 0; seat < 200; ++seat) {
+        holds.push_back(service.holdSeats(arena, std::span<const uint16_t>(&seat, 1), ttl));
+    }
+    std::atomic<int> confirmed(0);
+    std::atomic<int> releasedCount(0);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 8; ++t) {
+        threads.emplace_back([&, t]() {
+            for (HoldId id : holds) {
+                if (t % 2 == 0 ? service.confirmHold(id) != nullptr : service.releaseHold(id)) {
+                    (t % 2 == 0 ? confirmed : releasedCount)++;
+                }
+            }
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    TestFramework::assertEqual(200, confirmed.load() + releasedCount.load(), "Each hold ended exactly once");
+    TestFramework::assertEqual(1000 - confirmed.load(), service.getAvailableCount(arena),
+                               "Only confirmed seats stay taken");
+    TestFramework::assertEqual(0, service.getHeldCount(arena), "No seats left held");
+}
+
+void testCancelBooking() {
+    std::cout << "\n--- Test: Cancellation ---\n";
+    
+    BookingService service;
+    service.addMovie(std::make_shared<Movie>(1, "Inception"));
+    service.addTheater(std::make_shared<Theater>(1, "IMAX"));
+    service.linkMovieToTheater(1, 1);
+    ShowHandle show = service.resolveShow(1, 1);
+    
+    const Booking* first = service.bookSeats(1, 1, {"a1", "a2"});
+    const Booking* second = service.bookSeats(1, 1, {"a3"});
+    TestFramework::assertTrue(first && second, "Bookings succeed");
+    uint64_t firstId = first->bookingId;
+    
+    TestFramework::assertTrue(service.cancelBooking(firstId), "Cancel succeeds");
+    TestFramework::assertTrue(service.getBooking(firstId) == nullptr, "Cancelled booking not returned");
+    TestFramework::assertTrue(service.getBookingStatus(firstId) == BookingStatus::Cancelled, "Status is Cancelled");
+    TestFramework::assertTrue(service.getBookingStatus(999) == BookingStatus::Unknown, "Unknown id");
+    TestFramework::assertEqual(19, service.getAvailableCount(show), "Only the cancelled seats are free");
+    TestFramework::assertTrue(first->seatIds() == std::vector<std::string>{"a1", "a2"}, "Old record pointer stays valid");
+    
+    const Booking* rebooked = service.bookSeats(1, 1, {"a1"});
+    TestFramework::assertTrue(rebooked != nullptr, "Released seat can be re-booked");
+    TestFramework::assertTrue(!service.cancelBooking(firstId), "Second cancel fails...");
+    TestFramework::assertTrue(service.getBooking(rebooked->bookingId) != nullptr &&
+                              !service.bookSeats(1, 1, {"a1"}), "...and leaves the re-booked seat taken");
+    TestFramework::assertTrue(!service.cancelBooking(12345), "Unknown booking cannot be cancelled");
+    
+    // Book / cancel / re-book the same seats from many threads; cancels
+    // of the same booking race too. Keep every 3rd booking.
+    std::atomic<int> doubleCancels(0);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 8; ++t) {
+        threads.emplace_back([&, t]() {
+            for (int i = 0; i < 2000; ++i) {
+                uint16_t seat = static_cast<uint16_t>((t + i) % 20);
+                const Booking* booking = service.bookSeats(show, std::span<const uint16_t>(&seat, 1));
+                if (!booking || booking->bookingId % 3 == 0) {
+                    continue;
+                }
+                bool a = service.cancelBooking(booking->bookingId);
+                bool b = service.cancelBooking(booking->bookingId);
+                if (a == b) {
+                    doubleCancels++;
+                }
+            }
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    TestFramework::assertEqual(0, doubleCancels.load(), "Each booking cancelled exactly once");
+    
+    // Every taken seat belongs to exactly one active booking
+    std::vector<int> owners(20, 0);
+    // Ids come from per-thread blocks, so walk past any unused block tails
+    for (uint64_t id = 1; id <= 8 * 2000 + 8 * 4096; ++id) {
+        if (const Booking* booking = service.getBooking(id)) {
+            for (uint16_t seat : booking->seatIndexes()) {
+                owners[seat]++;
+            }
+        }
+    }
+    int taken = 0;
+    bool consistent = true;
+    for (int owner : owners) {
+        consistent = consistent && owner <= 1;
+        taken += owner;
+    }
+    TestFramework::assertTrue(consistent, "No seat owned by two active bookings");
+    TestFramework::assertEqual(20 - taken, service.getAvailableCount(show), "Bitmap matches active bookings");
+}
+
+void testExchange() {
+    std::cout << "\n--- Test: Exchange / Rebook ---\n";
+    
+    BookingService service;
+    service.addMovie(std::make_shared<Movie>(1, "Inception"));
+    service.addTheater(std::make_shared<Theater>(1, "IMAX"));
+    service.addTheater(std::make_shared<Theater>(2, "Studio"));
+    service.addTheater(std::make_shared<Theater>(3, "Arena", 300));
+    service.linkMovieToTheater(1, 1);
+    service.linkMovieToTheater(1, 2);
+    service.linkMovieToTheater(1, 3);
+    ShowHandle imax = service.resolveShow(1, 1);
+    ShowHandle studio = service.resolveShow(1, 2);
+    
+    const Booking* original = service.bookSeats(1, 1, {"a1", "a2"});
+    service.bookSeats(1, 1, {"a10"});
+    
+    const Booking* moved = service.exchange(original->bookingId, 1, 1, {"a2", "a3"});
+    TestFramework::assertTrue(moved != nullptr && moved->seatIds() == std::vector<std::string>{"a2", "a3"},
+                              "Exchange within a show");
+    TestFramework::assertTrue(service.getBookingStatus(original->bookingId) == BookingStatus::Cancelled,
+                              "Original booking cancelled");
+    TestFramework::assertEqual(17, service.getAvailableCount(imax), "a1 freed, a3 taken, a2 kept");
+    TestFramework::assertTrue(service.bookSeats(1, 1, {"a1"}) != nullptr, "Old seat can be booked again");
+    
+    TestFramework::assertTrue(service.exchange(moved->bookingId, 1, 1, {"a10"}) == nullptr,
+                              "Exchange onto a taken seat fails");
+    TestFramework::assertTrue(service.getBooking(moved->bookingId) == moved, "Failed exchange keeps the booking");
+    TestFramework::assertTrue(service.exchange(original->bookingId, 1, 1, {"a5"}) == nullptr,
+                              "Cancelled booking cannot be exchanged");
+    
+    const Booking* crossed = service.exchange(moved->bookingId, 1, 2, {"a1", "a2", "a3"});
+    TestFramework::assertTrue(crossed != nullptr && crossed->theaterId == 2, "Exchange to another show");
+    TestFramework::assertEqual(18, service.getAvailableCount(imax), "Seats freed in the old show");
+    TestFramework::assertEqual(17, service.getAvailableCount(studio), "Seats taken in the new show");
+    
+    const Booking* wide = service.bookSeats(1, 3, {"a1", "a2"});
+    const Booking* spanning = service.exchange(wide->bookingId, 1, 3, {"a2", "a100", "a200"});
+    TestFramework::assertTrue(spanning != nullptr && service.getAvailableCount(service.resolveShow(1, 3)) == 297,
+                              "Exchange across words of a large show");
+    
+    // Cancel and exchange racing on the same bookings: never both
+    std::vector<uint64_t> ids;
+    for (uint16_t seat = 3; seat < 8; ++seat) {
+        ids.push_back(service.bookSeats(studio, std::span<const uint16_t>(&seat, 1))->bookingId);
+    }
+    std::atomic<int> both(0);
+    std::atomic<int> cancels(0);
+    std::atomic<int> exchanges(0);
+    for (size_t i = 0; i < ids.size(); ++i) {
+        std::atomic<int> wins(0);
+        uint16_t target = static_cast<uint16_t>(8 + i);
+        std::thread canceller([&]() { if (service.cancelBooking(ids[i])) { wins++; cancels++; } });
+        std::thread exchanger([&]() {
+            if (service.exchange(ids[i], studio, std::span<const uint16_t>(&target, 1))) { wins++; exchanges++; }
+        });
+        canceller.join();
+        exchanger.join();
+        if (wins.load() > 1) {
+            both++;
+        }
+    }
+    TestFramework::assertEqual(0, both.load(), "Cancel and exchange never both succeed");
+    TestFramework::assertEqual(12 + cancels.load(), service.getAvailableCount(studio),
+                               "Cancelled bookings freed their seats, exchanged ones moved");
+}
+
+void testBookingIdBlocks() {
+    std::cout << "\n--- Test: Per-Thread Booking Id Blocks ---\n";
+    
+    // Each service hands out its own ids, even interleaved on one thread
+    BookingService first;
+    BookingService second;
+    for (BookingService* service : {&first, &second}) {
+        service->addMovie(std::make_shared<Movie>(1, "Inception"));
+        service->addTheater(std::make_shared<Theater>(1, "IMAX"));
+        service->linkMovieToTheater(1, 1);
+    }
+    TestFramework::assertTrue(first.bookSeats(1, 1, {"a1"})->bookingId == 1, "First service starts at 1");
+    TestFramework::assertTrue(second.bookSeats(1, 1, {"a1"})->bookingId == 1, "Second service starts at 1");
+    TestFramework::assertTrue(first.bookSeats(1, 1, {"a2"})->bookingId == 2, "Blocks are per service");
+    
+    // Many threads: ids unique, increasing per thread, and few left unused
+    const int numThreads = 8;
+    const int perThread = 1000;
+    BookingService service;
+    service.addMovie(std::make_shared<Movie>(1, "Inception"));
+    std::vector<ShowHandle> shows;
+    for (int t = 0; t < numThreads; ++t) {
+        service.addTheater(std::make_shared<Theater>(t + 1, "Hall", perThread));
+        service.linkMovieToTheater(1, t + 1);
+        shows.push_back(service.resolveShow(1, t + 1));
+    }
+    
+    std::vector<std::vector<uint64_t>> ids(numThreads);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < numThreads; ++t) {
+        threads.emplace_back([&, t]() {
+            for (int i = 0; i < perThread; ++i) {
+                uint16_t seat = static_cast<uint16_t>(i);
+                if (const Booking* booking = service.bookSeats(shows[t], std::span<const uint16_t>(&seat, 1))) {
+                    ids[t].push_back(booking->bookingId);
+                }
+            }
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    
+    std::vector<uint64_t> all;
+    bool increasing = true;
+    for (const auto& threadIds : ids) {
+        increasing = increasing && std::is_sorted(threadIds.begin(), threadIds.end());
+        all.insert(all.end(), threadIds.begin(), threadIds.end());
+    }
+    std::sort(all.begin(), all.end());
+    TestFramework::assertEqual(numThreads * perThread, static_cast<int>(all.size()), "Every booking succeeded");
+    TestFramework::assertTrue(std::adjacent_find(all.begin(), all.end()) == all.end(), "Booking ids are unique");
+    TestFramework::assertTrue(increasing, "Ids increase within a thread");
+    // Blocks double from 1, so a thread never strands more ids than it used
+    TestFramework::assertTrue(all.back() < 2u * all.size() + numThreads, "Unused block tails stay bounded");
+    
+    bool retrievable = true;
+    for (uint64_t id : all) {
+        const Booking* booking = service.getBooking(id);
+        retrievable = retrievable && booking && booking->bookingId == id;
+    }
+    TestFramework::assertTrue(retrievable, "Every id finds its record");
+}
+
+void testSeatArena() {
+    std::cout << "\n--- Test: Seat Arena Tiers ---\n";
+    
+    using Tier = SeatArena::Tier;
+    SeatArena arena;
+    
+    // Packed blocks sit back to back; padded ones own whole lines
+    auto* a = static_cast<std::byte*>(arena.allocate(24, 8, Tier::Packed));
+    auto* b = static_cast<std::byte*>(arena.allocate(24, 8, Tier::Packed));
+    TestFramework::assertTrue(b - a == 24, "Packed blocks are contiguous");
+    auto* p = static_cast<std::byte*>(arena.allocate(24, 8, Tier::Padded));
+    auto* q = static_cast<std::byte*>(arena.allocate(24, 8, Tier::Padded));
+    TestFramework::assertTrue(reinterpret_cast<uintptr_t>(p) % 64 == 0 && q - p == 64,
+                              "Padded blocks take one cache line each");
+    TestFramework::assertTrue(SeatArena::blockSize(96, 64, Tier::Packed) == 128, "Over-aligned sizes round up");
+    
+    arena.deallocate(a, 24, 8, Tier::Packed);
+    TestFramework::assertTrue(arena.allocate(24, 8, Tier::Packed) == a, "Freed blocks are reused");
+    TestFramework::assertTrue(arena.allocate(SeatArena::CHUNK_SIZE + 1, 8, Tier::Packed) == nullptr,
+                              "Blocks larger than a chunk are refused");
+    
+    // Seat maps keep their seats when moved between tiers
+    for (uint32_t capacity : {20u, 128u, 300u}) {
+        SeatMap* seats = SeatMap::create(capacity, arena, Tier::Packed);
+        std::array<uint64_t, SeatMap::MAX_WORDS> booked{};
+        std::array<uint64_t, SeatMap::MAX_WORDS> held{};
+        booked[0] = 0b101;
+        held[0] = 0b1000;
+        booked[(capacity - 1) / 64] |= uint64_t{1} << ((capacity - 1) % 64);
+        std::span<const uint64_t> bookedMask(booked.data(), seats->getWordCount());
+        std::span<const uint64_t> heldMask(held.data(), seats->getWordCount());
+        seats->tryBook(bookedMask);
+        seats->tryHold(heldMask, ClaimOptions{});
+        
+        SeatMap* moved = SeatMap::relocate(*seats, arena, Tier::Padded);
+        bool same = moved->getCapacity() == capacity && moved->getAvailableCount() == capacity - 4 &&
+                    moved->getHeldCount() == 1 && !moved->areAvailable(bookedMask);
+        TestFramework::assertTrue(same && reinterpret_cast<uintptr_t>(moved) % 64 == 0,
+                                  "Relocated map of " + std::to_string(capacity) + " seats is identical");
+        moved->releaseHeld(heldMask);
+        TestFramework::assertEqual(static_cast<int>(capacity) - 3, moved->getAvailableCount(), "Held seats stay releasable");
+        SeatMap::destroy(seats, arena, Tier::Packed);
+        SeatMap::destroy(moved, arena, Tier::Padded);
+    }
+}
+
+void testSeatRebalancing() {
+    std::cout << "\n--- Test: Seat Map Promotion / Demotion ---\n";
+    
+    // Zero threshold: every show is hot at the first call, quiet at the next
+    BookingServiceConfig config;
+    config.promoteRetries = 0;
+    config.demoteRounds = 1;
+    config.moveTimeout = std::chrono::milliseconds(500);
+    BookingService service(config);
+    service.addMovie(std::make_shared<Movie>(1, "Inception"));
+    service.addTheater(std::make_shared<Theater>(1, "IMAX"));
+    service.addTheater(std::make_shared<Theater>(2, "Arena", 300));
+    service.linkMovieToTheater(1, 1);
+    service.linkMovieToTheater(1, 2);
+    ShowHandle imax = service.resolveShow(1, 1);
+    ShowHandle arena = service.resolveShow(1, 2);
+    
+    const Booking* booked = service.bookSeats(imax, std::vector<std::string>{"a1", "a2"});
+    HoldId hold = service.holdSeats(imax, std::vector<std::string>{"a5"}, std::chrono::minutes(1));
+    service.bookSeats(arena, std::vector<std::string>{"a1", "a300"});
+    TestFramework::assertTrue(!service.isSeatMapPadded(imax), "New shows start packed");
+    
+    TestFramework::assertEqual(2, static_cast<int>(service.rebalanceSeats()), "Hot shows promoted");
+    TestFramework::assertTrue(service.isSeatMapPadded(imax) && service.isSeatMapPadded(arena), "Promoted shows are padded");
+    TestFramework::assertEqual(17, service.getAvailableCount(imax), "Bookings and holds survive promotion");
+    TestFramework::assertEqual(298, service.getAvailableCount(arena), "Wide map survives promotion");
+    TestFramework::assertTrue(service.confirmHold(hold) != nullptr, "Hold confirmed after the move");
+    TestFramework::assertTrue(service.cancelBooking(booked->bookingId), "Booking cancelled after the move");
+    
+    TestFramework::assertEqual(2, static_cast<int>(service.rebalanceSeats()), "Quiet shows demoted");
+    TestFramework::assertTrue(!service.isSeatMapPadded(imax), "Demoted show is packed again");
+    TestFramework::assertEqual(19, service.getAvailableCount(imax), "Seats survive demotion");
+    
+    // Bookers and cancellers racing with moves: no claim or release lost
+    // (no demotion delay either, so the show changes tier on every call)
+    config.demoteRounds = 0;
+    BookingService churn(config);
+    churn.addMovie(std::make_shared<Movie>(1, "Inception"));
+    churn.addTheater(std::make_shared<Theater>(1, "IMAX"));
+    churn.linkMovieToTheater(1, 1);
+    ShowHandle hot = churn.resolveShow(1, 1);
+    
+    const int numThreads = 4;
+    const int rounds = 50;
+    std::atomic<bool> stop(false);
+    std::atomic<int> net(0);
+    std::atomic<int> attempts(0);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < numThreads; ++t) {
+        threads.emplace_back([&, t]() {
+            for (int i = 0; !stop && i < 100000; ++i) {
+                uint16_t seat = static_cast<uint16_t>(((t * 5 + i) % 19) + 1);
+                const Booking* booking = churn.bookSeats(hot, std::span<const uint16_t>(&seat, 1));
+                attempts++;
+                if (booking) {
+                    net++;
+                    if (i % 2 == 0 && churn.cancelBooking(booking->bookingId)) {
+                        net--;
+                    }
+                }
+            }
+        });
+    }
+    size_t moves = 0;
+    for (int round = 0; round < rounds; ++round) {
+        moves += churn.rebalanceSeats();
+        std::this_thread::yield();
+    }
+    stop = true;
+    for (auto& t : threads) {
+        t.join();
+    }
+    
+    std::cout << "  " << moves << " moves of " << rounds << " during " << attempts.load() << " bookings\n";
+    TestFramework::assertTrue(moves > 0, "Shows moved while booking");
+    TestFramework::assertEqual(20 - net.load(), churn.getAvailableCount(hot), "No seat update lost across moves");
+}
+
+void testCatalogViews() {
+    std::cout << "\n--- Test: Pooled Catalog Views ---\n";
+    
+    BookingService service;
+    auto movie = std::make_shared<Movie>(1, "Inception");
+    service.addMovie(movie);
+    service.addTheater(Theater(1, "IMAX"));
+    service.addTheater(Theater(2, "Arena", 300));
+    
+    // The service owns copies: later caller changes are not seen
+    movie->title = "Changed";
+    const Movie* view = service.getMovie(1);
+    TestFramework::assertTrue(view && view->title == "Inception", "Movie copied into the pool");
+    
+    service.linkMovieToTheater(1, 1);
+    service.linkMovieToTheater(1, 2);
+    TestFramework::assertTrue(service.getMovie(1) == view, "Linking keeps the same movie view");
+    auto theaters = service.getTheatersForMovie(1);
+    TestFramework::assertTrue(theaters.size() == 2 && theaters[0] == service.getTheater(1) &&
+                              theaters[1]->capacity == 300, "Theater views in link order");
+    
+    // Replacing a movie publishes a new view; the old one stays readable
+    service.addMovie(Movie(1, "Inception (IMAX)"));
+    TestFramework::assertTrue(service.getMovie(1)->title == "Inception (IMAX)", "Replaced movie visible");
+    TestFramework::assertTrue(view->title == "Inception", "Old view still valid");
+    TestFramework::assertEqual(2, static_cast<int>(service.getTheatersForMovie(1).size()), "Links survive replacement");
+    TestFramework::assertTrue(service.getAllMovies().size() == 1 && service.getAllMovies()[0] == service.getMovie(1),
+                              "Movie list holds the current view");
+    TestFramework::assertTrue(service.getMovie(2) == nullptr && service.getTheater(3) == nullptr, "Unknown ids give nullptr");
+}
+
 void testLockFreeServiceBasics() {
     std::cout << "\n--- Test: Lock-Free Service Basics ---\n";
     
@@ -181,6 +1160,68 @@ void testLockFreeServiceBasics() {
     TestFramework::assertTrue(occupancy > 14.9 && occupancy < 15.1, "15% occupancy");
 }
 
+void testLargeTheaterService() {
+    std::cout << "\n--- Test: Service With 300-Seat Theater ---\n";
+    
+    BookingService service;
+    service.addMovie(std::make_shared<Movie>(1, "Inception"));
+    service.addTheater(std::make_shared<Theater>(1, "Grand Hall", 300));
+    service.linkMovieToTheater(1, 1);
+    
+    TestFramework::assertEqual(300, service.getAvailableSeats(1, 1).size(), "300 seats available initially");
+    
+    auto booking = service.bookSeats(1, 1, {"a64", "a65", "a250"});
+    TestFramework::assertTrue(booking != nullptr, "Booking a64, a65, a250 succeeds");
+    TestFramework::assertEqual(297, service.getAvailableCount(1, 1), "297 seats remaining");
+    TestFramework::assertEqual(300, service.getCapacity(1, 1), "Capacity is 300");
+    
+    TestFramework::assertTrue(service.bookSeats(1, 1, {"a301"}) == nullptr, "a301 rejected");
+    TestFramework::assertTrue(service.bookSeats(1, 1, {"a1", "a250"}) == nullptr, "Overlap with a250 rejected");
+    TestFramework::assertEqual(297, service.getAvailableCount(1, 1), "Still 297 seats");
+}
+
+void testShowHandleBooking() {
+    std::cout << "\n--- Test: Booking By Show Handle ---\n";
+    
+    BookingService service;
+    service.addMovie(std::make_shared<Movie>(1, "Inception"));
+    service.addMovie(std::make_shared<Movie>(2, "Tenet"));
+    service.addTheater(std::make_shared<Theater>(1, "IMAX"));
+    service.linkMovieToTheater(1, 1);
+    
+    ShowHandle show = service.resolveShow(1, 1);
+    TestFramework::assertTrue(show.isValid(), "Linked show resolves");
+    TestFramework::assertTrue(!service.resolveShow(2, 1).isValid(), "Unlinked show does not resolve");
+    TestFramework::assertEqual(show.index, service.resolveShow(1, 1).index, "Resolving twice gives the same handle");
+    
+    auto booking = service.bookSeats(show, {"a1", "a2"});
+    TestFramework::assertTrue(booking != nullptr, "Booking by handle succeeds");
+    TestFramework::assertEqual(1, booking->theaterId, "Booking records the show's theater");
+    TestFramework::assertEqual(18, service.getAvailableCount(show), "18 seats remaining (handle)");
+    TestFramework::assertEqual(18, service.getAvailableCount(1, 1), "18 seats remaining (ids)");
+    TestFramework::assertTrue(service.bookSeats(1, 1, {"a2"}) == nullptr, "Id-based booking sees handle booking");
+    
+    ShowHandle invalid;
+    TestFramework::assertTrue(service.bookSeats(invalid, {"a3"}) == nullptr, "Invalid handle rejected");
+    TestFramework::assertEqual(0, service.getAvailableSeats(invalid).size(), "Invalid handle has no seats");
+    
+    // Concurrent handle bookings: exactly one winner per seat
+    std::atomic<int> successCount(0);
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 200; ++i) {
+        threads.emplace_back([&service, &successCount, show, i]() {
+            if (service.bookSeats(show, {"a" + std::to_string((i % 18) + 3)})) {
+                successCount++;
+            }
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    TestFramework::assertEqual(18, successCount.load(), "Exactly 18 handle winners");
+    TestFramework::assertEqual(0, service.getAvailableCount(show), "Show sold out");
+}
+
 void testMassiveConcurrentBooking() {
     std::cout << "\n--- Test: 10,000 Threads Concurrent Booking ---\n";
     
@@ -239,9 +1280,119 @@ void testMassiveConcurrentBooking() {
     
     std::cout << "  ✓ Completed in " << duration.count() << " ms\n";
     std::cout << "  ✓ Successful bookings: " << successCount.load() << "\n";
-    std::cout << "  ✓ Throughput: " << (numThreads * 1000 / duration.count()) << " ops/sec\n";
+    std::cout << "  ✓ Throughput: " << (numThreads * 1000 / std::max<int64_t>(1, duration.count())) << " ops/sec\n";
     
     TestFramework::assertTrue(successCount.load() > 0, "Some bookings succeeded");
+    
+    // Every booking id is unique and retrievable (ids come from
+    // per-thread blocks, so they need not be dense)
+    int found = 0;
+    for (uint64_t id = 1; id <= static_cast<uint64_t>(numThreads) + 4096; ++id) {
+        auto booking = service.getBooking(id);
+        if (booking && booking->bookingId == id) {
+            found++;
+        }
+    }
+    TestFramework::assertEqual(successCount.load(), found, "All bookings retrievable by id");
+    TestFramework::assertTrue(service.getBooking(0) == nullptr, "Unknown id returns nullptr");
+    
+    // Booking throughput vs threads: the record append is contention-free,
+    // so throughput should keep rising up to the core count
+    unsigned cores = std::max(1u, std::thread::hardware_concurrency());
+    std::cout << "  Booking throughput vs threads (" << cores << " cores):\n";
+    for (unsigned threadCount = 1; threadCount <= cores; threadCount *= 2) {
+        BookingService scaling;
+        scaling.addMovie(std::make_shared<Movie>(1, "Movie"));
+        for (unsigned t = 1; t <= threadCount; ++t) {
+            scaling.addTheater(std::make_shared<Theater>(t, "Theater", SeatMap::MAX_CAPACITY));
+            scaling.linkMovieToTheater(1, t);
+        }
+        
+        std::atomic<int> booked(0);
+        std::vector<std::thread> bookers;
+        auto scaleStart = std::chrono::high_resolution_clock::now();
+        for (unsigned t = 1; t <= threadCount; ++t) {
+            bookers.emplace_back([&scaling, &booked, t]() {
+                ShowHandle show = scaling.resolveShow(1, t);
+                for (uint32_t seat = 1; seat <= SeatMap::MAX_CAPACITY; ++seat) {
+                    if (scaling.bookSeats(show, {"a" + std::to_string(seat)})) {
+                        booked++;
+                    }
+                }
+            });
+        }
+        for (auto& t : bookers) {
+            t.join();
+        }
+        auto micros = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::high_resolution_clock::now() - scaleStart).count();
+        std::cout << "    " << threadCount << " threads: "
+                  << static_cast<int64_t>(booked.load() * 1e6 / std::max<int64_t>(1, micros))
+                  << " bookings/sec\n";
+        TestFramework::assertEqual(static_cast<int>(threadCount * SeatMap::MAX_CAPACITY), booked.load(),
+                                   "Every seat booked with " + std::to_string(threadCount) + " threads");
+    }
+}
+
+void benchmarkBookingStrategy(ClaimStrategy strategy, const std::string& label,
+                              BackoffStrategy backoff = BackoffStrategy::Sleep) {
+    BookingServiceConfig config;
+    config.claimStrategy = strategy;
+    config.backoff.strategy = backoff;
+    BookingService service(config);
+    
+    const uint32_t numSeats = 4096;
+    service.addMovie(std::make_shared<Movie>(1, "Test Movie"));
+    service.addTheater(std::make_shared<Theater>(1, "Test Theater", numSeats));
+    service.linkMovieToTheater(1, 1);
+    
+    const int numThreads = 8;
+    std::atomic<int> successCount(0);
+    std::vector<std::vector<int64_t>> latencies(numThreads);
+    std::vector<std::thread> threads;
+    
+    auto start = std::chrono::high_resolution_clock::now();
+    
+    for (int t = 0; t < numThreads; ++t) {
+        threads.emplace_back([&, t]() {
+            latencies[t].reserve(numSeats);
+            for (uint32_t seat = 1; seat <= numSeats; ++seat) {
+                std::vector<std::string> seats = {"a" + std::to_string(seat)};
+                auto opStart = std::chrono::high_resolution_clock::now();
+                auto booking = service.bookSeats(1, 1, seats);
+                auto opEnd = std::chrono::high_resolution_clock::now();
+                latencies[t].push_back(
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(opEnd - opStart).count());
+                if (booking) {
+                    successCount++;
+                }
+            }
+        });
+    }
+    
+    for (auto& t : threads) {
+        t.join();
+    }
+    
+    auto end = std::chrono::high_resolution_clock::now();
+    auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start);
+    
+    std::vector<int64_t> all;
+    for (const auto& perThread : latencies) {
+        all.insert(all.end(), perThread.begin(), perThread.end());
+    }
+    std::sort(all.begin(), all.end());
+    
+    std::cout << "  " << label << " booking (" << numThreads << " threads, "
+              << numSeats << " contended seats):\n";
+    std::cout << "    Time: " << duration.count() / 1000.0 << " ms\n";
+    std::cout << "    p50: " << all[all.size() / 2] << " ns, p99: "
+              << all[all.size() * 99 / 100] << " ns\n";
+    std::cout << "    CAS retries: " << service.getRetryCount()
+              << ", give-ups: " << service.getGiveUpCount() << "\n";
+    
+    TestFramework::assertEqual(numSeats, successCount.load(),
+                               label + ": every seat booked exactly once");
 }
 
 void benchmarkLockFreeVsOthers() {
@@ -289,6 +1440,12 @@ void benchmarkLockFreeVsOthers() {
     std::cout << "  ✓ Average: " << avgMicroseconds << " μs per operation\n";
     std::cout << "  ✓ Throughput: " << static_cast<int>(1000000.0 / avgMicroseconds) 
               << " ops/second\n";
+    
+    // Booking under contention: every thread races for every seat
+    benchmarkBookingStrategy(ClaimStrategy::CompareExchange, "CAS loop (sleep backoff)");
+    benchmarkBookingStrategy(ClaimStrategy::CompareExchange, "CAS loop (jittered spin)",
+                             BackoffStrategy::ExponentialJitter);
+    benchmarkBookingStrategy(ClaimStrategy::FetchOr, "fetch_or");
 }
 
 int main() {
@@ -299,7 +1456,28 @@ int main() {
     testBitmaskBasics();
     testBitmaskLockFreeBooking();
     testConcurrentLockFreeBooking();
+    testBackoffPolicies();
+    testWideBitmaskBasics();
+    testWideBitmaskConcurrentSpanning();
+    testFixedBitmaskSpecializations();
+    testFetchOrBooking();
+    testConcurrentHashIndex();
+    testEpochReclamation();
+    testCatalogViews();
     testLockFreeServiceBasics();
+    testLargeTheaterService();
+    testShowHandleBooking();
+    testSeatParsingSpans();
+    testAvailableSeatEnumeration();
+    testBookAdjacent();
+    testBestAvailableSelection();
+    testTimerWheel();
+    testSeatHolds();
+    testCancelBooking();
+    testExchange();
+    testBookingIdBlocks();
+    testSeatArena();
+    testSeatRebalancing();
     testMassiveConcurrentBooking();
     benchmarkLockFreeVsOthers();
     
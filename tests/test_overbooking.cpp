@@ -159,6 +159,32 @@ void testLinearOverbookingBatch() {
     OverbookingTests::assertTrue(failBooking1 == nullptr, "Single seat re-booking fails");
     OverbookingTests::assertTrue(failBooking2 == nullptr, "Two-seat re-booking fails");
     OverbookingTests::assertTrue(failBooking3 == nullptr, "Multi-seat re-booking fails");
+    
+    // Test 2.4: The same rules through bookBatch, across shows
+    std::cout << "\nTest 2.4: bookBatch across shows\n";
+    service.addTheater(std::make_shared<Theater>(2, "Second"));
+    service.linkMovieToTheater(1, 2);
+    std::vector<BookingRequest> requests = {
+        {1, 2, {"a1", "a2"}},   // Booked
+        {1, 1, {"a3"}},         // Show 1 is sold out
+        {1, 2, {"a2", "a3"}},   // Overlaps the first item
+        {1, 2, {"a3", "a4"}},   // Fits
+        {1, 9, {"a1"}},         // Unknown theater
+        {1, 2, {"a99"}},        // Invalid seat
+    };
+    auto results = service.bookBatch(requests);
+    using Status = BookingResult::Status;
+    OverbookingTests::assertEqual(6, results.size(), "One result per request");
+    OverbookingTests::assertTrue(results[0].ok() && results[0].booking->seatIds() == std::vector<std::string>{"a1", "a2"},
+                                 "First item booked");
+    OverbookingTests::assertTrue(results[1].status == Status::SeatsTaken, "Sold-out show rejected");
+    OverbookingTests::assertTrue(results[2].status == Status::SeatsTaken, "Item overlapping an earlier one rejected");
+    OverbookingTests::assertTrue(results[3].ok(), "Non-overlapping item booked");
+    OverbookingTests::assertTrue(results[4].status == Status::InvalidRequest, "Unknown show rejected");
+    OverbookingTests::assertTrue(results[5].status == Status::InvalidRequest, "Invalid seat rejected");
+    OverbookingTests::assertEqual(16, service.getAvailableCount(1, 2), "Only a1-a4 booked in show 2");
+    OverbookingTests::assertTrue(results[3].booking->bookingId == results[0].booking->bookingId + 1,
+                                 "Batch ids are consecutive");
 }
 
 // ============================================================================
@@ -315,7 +341,7 @@ void testConcurrentOverbookingRandom() {
             if (booking) {
                 successCount++;
                 std::lock_guard<std::mutex> lock(bookingsMutex);
-                allBookedSeats.push_back(booking->seats);
+                allBookedSeats.push_back(booking->seatIds());
             }
         });
     }
@@ -390,7 +416,7 @@ void testConcurrentOverbookingOverlappingBatches() {
             if (booking) {
                 successCount++;
                 std::lock_guard<std::mutex> lock(bookingsMutex);
-                successfulBookings.push_back(booking->seats);
+                successfulBookings.push_back(booking->seatIds());
             }
         });
     }
@@ -420,6 +446,35 @@ void testConcurrentOverbookingOverlappingBatches() {
     std::cout << "  Total seats booked: " << allSeats.size() << " / 20\n";
     std::cout << "  Average seats per successful booking: " 
               << (totalSeatsBooked / successCount.load()) << "\n";
+    
+    // Same sliding windows, submitted as batches over two shows
+    service.addTheater(std::make_shared<Theater>(2, "Test 2"));
+    service.linkMovieToTheater(1, 2);
+    std::atomic<int> batchSeats{0};
+    threads.clear();
+    for (int i = 0; i < 20; i++) {
+        threads.emplace_back([&, i]() {
+            std::vector<BookingRequest> batch;
+            for (int j = 0; j < 8; j++) {
+                BookingRequest request{1, static_cast<uint32_t>(1 + j % 2), {}};
+                int startSeat = (i + j) % 16 + 1;
+                for (int k = 0; k < 5; k++) {
+                    request.seatIds.push_back("a" + std::to_string(startSeat + k));
+                }
+                batch.push_back(std::move(request));
+            }
+            for (const auto& result : service.bookBatch(batch)) {
+                if (result.ok() && result.booking->theaterId == 2) {
+                    batchSeats += result.booking->seatCount;
+                }
+            }
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    OverbookingTests::assertEqual(20 - static_cast<int>(service.getAvailableCount(1, 2)), batchSeats.load(),
+                                 "Batches never overbook: booked seats match the bitmap");
 }
 
 // ============================================================================
@@ -1,13 +1,51 @@
 #include "BookingService.h"
+#include "FixedSeatBitmask.h"
 #include <iostream>
 #include <thread>
 #include <vector>
+#include <array>
 #include <chrono>
 #include <atomic>
 #include <random>
 #include <map>
 #include <set>
 #include <iomanip>
+#include <algorithm>
+#include <cstdlib>
+#include <new>
+
+// ============================================================================
+// Allocation counting (only while countAllocations is set)
+// ============================================================================
+
+namespace {
+    std::atomic<bool> countAllocations{false};
+    std::atomic<uint64_t> allocationCount{0};
+    std::atomic<uint64_t> allocatedBytes{0};
+}
+
+void* operator new(std::size_t size) {
+    if (countAllocations.load(std::memory_order_relaxed)) {
+        allocationCount.fetch_add(1, std::memory_order_relaxed);
+        allocatedBytes.fetch_add(size, std::memory_order_relaxed);
+    }
+    if (void* p = std::malloc(size ? size : 1)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+// GCC pairs new-expressions with these after inlining and flags the free()
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    std::free(p);
+}
+#pragma GCC diagnostic pop
 
 // ============================================================================
 // SCALABILITY TESTS - Large Datasets & High Concurrency
@@ -165,7 +203,7 @@ void testConcurrentMetadataReads() {
                 } else if (operation == 1) {
                     // Read specific movie
                     int movieId = movieDist(gen);
-                    auto movie = service.getMovie(movieId);
+                    service.getMovie(movieId);
                     totalReads++;
                 } else {
                     // Read theaters for movie
@@ -193,6 +231,45 @@ void testConcurrentMetadataReads() {
                                  "All 100,000 reads completed (10,000 threads × 10 ops)");
     ScalabilityTests::assertTrue(duration < 10000, 
                                 "Completed in <10 seconds");
+    
+    // Read scaling: fixed reads per thread, one thread per core at most.
+    // With RCU metadata, readers share no written cache line, so
+    // throughput should grow ~linearly up to the core count.
+    const int READS_PER_THREAD = 200000;
+    unsigned cores = std::max(1u, std::thread::hardware_concurrency());
+    std::cout << "\nRead throughput vs threads (" << cores << " cores):\n";
+    
+    for (unsigned numThreads = 1; numThreads <= cores; numThreads *= 2) {
+        std::atomic<int64_t> reads{0};
+        std::vector<std::thread> readers;
+        
+        auto scaleStart = std::chrono::high_resolution_clock::now();
+        for (unsigned t = 0; t < numThreads; t++) {
+            readers.emplace_back([&, t]() {
+                int64_t local = 0;
+                for (int i = 0; i < READS_PER_THREAD; i++) {
+                    uint32_t movieId = static_cast<uint32_t>((i + t * 7919) % 500) + 1;
+                    if (service.getMovie(movieId)) {
+                        local++;
+                    }
+                }
+                reads += local;
+            });
+        }
+        for (auto& t : readers) {
+            t.join();
+        }
+        auto scaleMicros = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::high_resolution_clock::now() - scaleStart).count();
+        
+        std::cout << "  " << std::setw(3) << numThreads << " threads: "
+                  << std::fixed << std::setprecision(0)
+                  << (reads.load() * 1e6 / std::max<int64_t>(1, scaleMicros)) << " reads/sec\n";
+        
+        ScalabilityTests::assertEqual(static_cast<int>(numThreads) * READS_PER_THREAD,
+                                      static_cast<int>(reads.load()),
+                                      "All movies found with " + std::to_string(numThreads) + " threads");
+    }
 }
 
 // ============================================================================
@@ -356,7 +433,7 @@ void testRealisticMixedWorkload() {
                 } else {
                     // 5% - Metadata access
                     int movieId = movieDist(gen);
-                    auto movie = service.getMovie(movieId);
+                    service.getMovie(movieId);
                     auto theaters = service.getTheatersForMovie(movieId);
                     metadataOps++;
                 }
@@ -452,6 +529,233 @@ void testMemoryFootprint() {
                                 "Bitmask memory <500 KB");
     ScalabilityTests::assertTrue((vectorMemory / bitmaskMemory) > 60, 
                                 "Bitmask >60x more efficient than vector");
+    
+    // Seat maps actually allocated: packed back to back in arena chunks,
+    // instead of one heap block (plus allocator header) per show
+    size_t arenaBytes = service.getSeatArenaBytes();
+    size_t packedBytes = 100000 * SeatArena::blockSize(sizeof(FixedSeatBitmask<20>),
+                                                       alignof(FixedSeatBitmask<20>),
+                                                       SeatArena::Tier::Packed);
+    std::cout << "  Seat map arena: " << arenaBytes / 1024 << " KB ("
+              << packedBytes / 100000 << " bytes per show, "
+              << arenaBytes / SeatArena::CHUNK_SIZE << " chunks)\n";
+    ScalabilityTests::assertTrue(arenaBytes <= packedBytes + SeatArena::CHUNK_SIZE,
+                                "Seat maps packed with less than one chunk of slack");
+    ScalabilityTests::assertTrue(arenaBytes < 100000 * 32,
+                                "Below the 32-byte heap block a seat map took on its own");
+    
+    // Booking records: fixed-size, inline seat indexes, no per-seat strings
+    const int RECORDS = 4096;
+    BookingService records;
+    records.addMovie(std::make_shared<Movie>(1, "M"));
+    records.addTheater(std::make_shared<Theater>(1, "T", SeatMap::MAX_CAPACITY));
+    records.linkMovieToTheater(1, 1);
+    ShowHandle big = records.resolveShow(1, 1);
+    std::vector<std::vector<std::string>> seatRequests;
+    for (int i = 1; i <= RECORDS; i++) {
+        seatRequests.push_back({"a" + std::to_string(i)});
+    }
+    records.bookSeats(big, seatRequests[0]);  // First segment allocated outside the count
+    
+    allocationCount = 0;
+    allocatedBytes = 0;
+    countAllocations = true;
+    int booked = 0;
+    for (int i = 1; i < RECORDS; i++) {
+        if (records.bookSeats(big, seatRequests[i])) {
+            booked++;
+        }
+    }
+    countAllocations = false;
+    
+    double allocsPerBooking = static_cast<double>(allocationCount.load()) / booked;
+    double bytesPerBooking = static_cast<double>(allocatedBytes.load()) / booked;
+    std::cout << "\nBooking record:\n";
+    std::cout << "  sizeof(Booking): " << sizeof(Booking) << " bytes (trivially copyable, "
+              << Booking::MAX_SEATS << " seats inline)\n";
+    std::cout << "  Heap allocations per bookSeats: " << std::setprecision(2) << allocsPerBooking << "\n";
+    std::cout << "  Heap bytes per bookSeats: " << std::setprecision(1) << bytesPerBooking
+              << " (amortized record slab)\n";
+    std::cout << "  (was 4 allocations: make_shared<Booking>, vector<string>, map node, seat mask)\n";
+    
+    ScalabilityTests::assertEqual(RECORDS - 1, booked, "All single-seat bookings succeeded");
+    ScalabilityTests::assertTrue(sizeof(Booking) <= 128, "Booking record fits in two cache lines");
+    ScalabilityTests::assertTrue(allocsPerBooking < 0.01, "No heap allocation per booking (slab segments only)");
+    
+    // Seat-map polling into a caller buffer
+    std::vector<char> pollBuffer(SeatMap::MAX_CAPACITY * (SeatMap::MAX_SEAT_ID_LENGTH + 1));
+    ShowHandle polledShow = service.resolveShow(1, 1);  // a1 booked, 19 free
+    allocationCount = 0;
+    countAllocations = true;
+    size_t polled = 0;
+    for (int i = 0; i < 100; i++) {
+        polled += service.formatAvailableSeats(polledShow, pollBuffer);
+    }
+    countAllocations = false;
+    std::cout << "  Heap allocations per formatAvailableSeats poll: " << allocationCount.load() / 100 << "\n";
+    ScalabilityTests::assertTrue(polled > 0, "Polls produced seat lists");
+    ScalabilityTests::assertEqual(0, static_cast<int>(allocationCount.load()), "Seat-map polling allocates nothing");
+    
+    // Catalog reads return pooled views: no allocation, no refcount
+    allocationCount = 0;
+    countAllocations = true;
+    size_t found = 0;
+    for (uint32_t i = 1; i <= 100; i++) {
+        found += service.getMovie(i) != nullptr;
+        found += service.getTheater(i) != nullptr;
+    }
+    countAllocations = false;
+    std::cout << "  Heap allocations per getMovie/getTheater: " << allocationCount.load() / 200 << "\n";
+    ScalabilityTests::assertEqual(200, static_cast<int>(found), "Catalog views found");
+    ScalabilityTests::assertEqual(0, static_cast<int>(allocationCount.load()), "Catalog reads allocate nothing");
+}
+
+// ============================================================================
+// TEST 6: Exchange Throughput Under Contention
+// ============================================================================
+
+void testExchangeUnderContention() {
+    std::cout << "\n=== TEST 6: Exchange Throughput Under Contention ===\n";
+    std::cout << "Goal: Customers keep moving between two crowded shows; nobody loses or doubles seats\n\n";
+    
+    BookingService service;
+    service.addMovie(std::make_shared<Movie>(1, "Inception"));
+    service.addTheater(std::make_shared<Theater>(1, "Early", 64));
+    service.addTheater(std::make_shared<Theater>(2, "Late", 64));
+    service.linkMovieToTheater(1, 1);
+    service.linkMovieToTheater(1, 2);
+    const ShowHandle shows[2] = {service.resolveShow(1, 1), service.resolveShow(1, 2)};
+    
+    // 48 customers with 2 seats each: 96 of 128 seats taken at all times
+    const int THREADS = 8;
+    const int CUSTOMERS_PER_THREAD = 6;
+    const int ROUNDS = 5000;
+    std::vector<uint64_t> customers;
+    for (int c = 0; c < THREADS * CUSTOMERS_PER_THREAD; c++) {
+        std::array<uint16_t, 2> pair = {static_cast<uint16_t>(c * 2 % 64), static_cast<uint16_t>(c * 2 % 64 + 1)};
+        customers.push_back(service.bookSeats(shows[c / 32], pair)->bookingId);
+    }
+    
+    std::atomic<int64_t> attempts{0};
+    std::atomic<int64_t> exchanged{0};
+    std::vector<std::thread> threads;
+    auto startTime = std::chrono::high_resolution_clock::now();
+    
+    for (int t = 0; t < THREADS; t++) {
+        threads.emplace_back([&, t]() {
+            std::mt19937 gen(t);
+            std::uniform_int_distribution<> seatDist(0, 62);
+            for (int round = 0; round < ROUNDS; round++) {
+                uint64_t& id = customers[t * CUSTOMERS_PER_THREAD + round % CUSTOMERS_PER_THREAD];
+                uint16_t seat = static_cast<uint16_t>(seatDist(gen));
+                std::array<uint16_t, 2> pair = {seat, static_cast<uint16_t>(seat + 1)};
+                const Booking* moved = service.exchange(id, shows[gen() % 2], pair);
+                attempts++;
+                if (moved) {
+                    id = moved->bookingId;
+                    exchanged++;
+                }
+            }
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    
+    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::high_resolution_clock::now() - startTime).count();
+    
+    ScalabilityTests::printStats("Exchange attempts (8 threads, 48 customers, 128 seats)",
+                                 attempts.load(), std::max<int64_t>(duration, 1));
+    std::cout << "    Successful exchanges: " << exchanged.load() << " ("
+              << (exchanged.load() * 100 / attempts.load()) << "%)\n";
+    
+    int active = 0;
+    for (uint64_t id : customers) {
+        const Booking* booking = service.getBooking(id);
+        active += booking && booking->seatCount == 2;
+    }
+    int occupied = 128 - static_cast<int>(service.getAvailableCount(shows[0]) + service.getAvailableCount(shows[1]));
+    
+    ScalabilityTests::assertEqual(THREADS * CUSTOMERS_PER_THREAD, active, "Every customer still holds one booking");
+    ScalabilityTests::assertEqual(96, occupied, "Exactly the customers' 96 seats are occupied");
+    ScalabilityTests::assertTrue(exchanged.load() > 0, "Exchanges make progress under contention");
+}
+
+// ============================================================================
+// TEST 7: Batch Booking vs. Per-Item Loop
+// ============================================================================
+
+void testBatchBookingThroughput() {
+    std::cout << "\n=== TEST 7: Batch Booking vs. Per-Item Loop ===\n";
+    std::cout << "Goal: bookBatch beats calling bookSeats in a loop for aggregator batches\n\n";
+    
+    // Aggregator batch: 400 items over 40 shows, 2 seats each
+    const int MOVIES = 10;
+    const int THEATERS = 4;
+    const int ITEMS = 400;
+    const int ROUNDS = 200;
+    std::vector<BookingRequest> batch;
+    for (int i = 0; i < ITEMS; i++) {
+        int show = i % (MOVIES * THEATERS);
+        int seat = (i / (MOVIES * THEATERS)) * 2 + 1;
+        batch.push_back({static_cast<uint32_t>(show / THEATERS + 1), static_cast<uint32_t>(show % THEATERS + 1),
+                         {"a" + std::to_string(seat), "a" + std::to_string(seat + 1)}});
+    }
+    
+    auto makeService = [&]() {
+        auto service = std::make_unique<BookingService>();
+        for (int m = 1; m <= MOVIES; m++) {
+            service->addMovie(std::make_shared<Movie>(m, "M" + std::to_string(m)));
+        }
+        for (int t = 1; t <= THEATERS; t++) {
+            service->addTheater(std::make_shared<Theater>(t, "T" + std::to_string(t)));
+            for (int m = 1; m <= MOVIES; m++) {
+                service->linkMovieToTheater(m, t);
+                service->resolveShow(m, t);  // Shows already on sale
+            }
+        }
+        service->cancelBooking(service->bookSeats(1, 1, {"a20"})->bookingId);  // Booking store already warm
+        return service;
+    };
+    
+    // Best of ROUNDS fresh services each, so a noisy round cannot decide it;
+    // only optimized builds assert that batching is not slower
+    int64_t loopNanos = INT64_MAX;
+    int64_t batchNanos = INT64_MAX;
+    int loopBooked = 0;
+    int batchBooked = 0;
+    for (int round = 0; round < ROUNDS; round++) {
+        auto loopService = makeService();
+        auto start = std::chrono::high_resolution_clock::now();
+        for (const auto& request : batch) {
+            loopBooked += loopService->bookSeats(request.movieId, request.theaterId, request.seatIds) != nullptr;
+        }
+        loopNanos = std::min<int64_t>(loopNanos, std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::high_resolution_clock::now() - start).count());
+        
+        auto batchService = makeService();
+        start = std::chrono::high_resolution_clock::now();
+        for (const auto& result : batchService->bookBatch(batch)) {
+            batchBooked += result.ok();
+        }
+        batchNanos = std::min<int64_t>(batchNanos, std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::high_resolution_clock::now() - start).count());
+    }
+    
+    std::cout << "  Best of " << ROUNDS << " rounds, " << ITEMS << " items over " << MOVIES * THEATERS << " shows:\n";
+    std::cout << "    bookSeats loop: " << loopNanos / 1000 << " us per batch\n";
+    std::cout << "    bookBatch:      " << batchNanos / 1000 << " us per batch\n";
+    std::cout << "    Speedup: " << std::setprecision(2)
+              << static_cast<double>(loopNanos) / std::max<int64_t>(batchNanos, 1) << "x\n";
+    
+    ScalabilityTests::assertEqual(ITEMS * ROUNDS, loopBooked, "Loop booked every item");
+    ScalabilityTests::assertEqual(ITEMS * ROUNDS, batchBooked, "Batch booked every item");
+#if defined(NDEBUG) && !defined(__SANITIZE_ADDRESS__) && !defined(__SANITIZE_THREAD__)
+    ScalabilityTests::assertTrue(batchNanos <= loopNanos, "bookBatch at least as fast as the loop");
+#else
+    std::cout << "  (speedup not asserted: Debug and sanitizer builds time the checks, not the batching)\n";
+#endif
 }
 
 // ============================================================================
@@ -468,6 +772,8 @@ int main() {
     testManyBookingsAcrossCombinations();
     testRealisticMixedWorkload();
     testMemoryFootprint();
+    testExchangeUnderContention();
+    testBatchBookingThroughput();
     
     std::cout << "\n=========================================================\n";
     std::cout << "                    FINAL RESULTS\n";